@@ -0,0 +1,569 @@
+/******************************************************************************
+ * feedbench.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 16-10-2026
+ *
+ * Description:
+ *   Micro-benchmarks of the feed hot paths against the approaches they
+ *   replaced.
+ *   - Parser: OkxFrameParser on the QString storage vs QJsonDocument over
+ *     toUtf8(), both producing an OkxTicker per "tickers" frame
+ *   - Book side: PriceLadder vs the best-first QVector of levels with a
+ *     QString meta it replaced, updates concentrated near the top; and the
+ *     display path, a copy + sort of that vector vs a best-first walk
+ *   - Market Watch rows at 100 / 1k / 10k rows: MarketWatchModel::data()
+ *     and onTickBatch() vs the uid-keyed std::map the rows lived in, read by
+ *     position and scanned per tick. The model also pays for its dataChanged
+ *     and flash bookkeeping; no feed or view is attached
+ *   - Repaint: data(DisplayRole) over a visible page of price/quantity cells,
+ *     the cached cell text vs QString::number on every paint
+ *   - Row batches at 1k / 10k rows: addRow() per symbol vs one addRows(),
+ *     and removeRowAt() per selected row vs one removeRowsAt() over a
+ *     selection of many separate ranges
+ *   - All instruments at 10k rows: a viewport-limited model vs one that
+ *     formats every row, under the same ticks while a 40-row page scrolls
+ *     down the table; and the cell text each model ends up holding
+ *   Prints nanoseconds per operation; results are summed into a checksum so
+ *   the work cannot be optimised away.
+ ******************************************************************************/
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QVector>
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <map>
+#include "okxframeparser.h"
+#include "instrumentregistry.h"
+#include "priceladder.h"
+#include "marketwatchmodel.h"
+#include "protocol.h"
+
+using CryptoCV::Decimal;
+
+static const int FRAMES = 100000;
+static const int BOOK_DEPTH = 400;
+static const int BOOK_UPDATES = 200000;
+static const int BOOK_DISPLAYS = 2000;
+static const int DISPLAY_LEVELS = 20;
+static const int CELL_READS = 200000;
+static const int TICK_BATCHES = 100;
+static const int TICKS_PER_BATCH = 500;   // One conflation release of a busy watch
+static const int PAGE_ROWS = 40;          // Rows a Market Watch view shows at once
+static const int REPAINTS = 5000;
+static const int UNIVERSE_ROWS = 10000;
+static const int VIEWPORT_MARGIN = 20;    // [MarketWatch] viewportMargin default
+static const int SCROLL_STEPS = 500;      // One tick batch and one repaint per step
+
+static qint64 g_checksum = 0;
+
+// Nanoseconds per operation of fn() doing count operations
+static double timeNs(int count, const std::function<void()> &fn)
+{
+    QElapsedTimer timer;
+    timer.start();
+    fn();
+    return double(timer.nsecsElapsed()) / double(qMax(1, count));
+}
+
+static void report(const char *name, double baselineNs, double newNs)
+{
+    std::printf("%-44s %10.1f ns  -> %10.1f ns  (x%.1f)\n", name, baselineNs, newNs, baselineNs / qMax(0.001, newNs));
+}
+
+static void reportBytes(const char *name, qint64 baselineBytes, qint64 newBytes)
+{
+    std::printf("%-44s %10.1f KB  -> %10.1f KB\n", name, double(baselineBytes) / 1024.0, double(newBytes) / 1024.0);
+}
+
+//------------------------------------------------------------------------------
+// Parser
+//------------------------------------------------------------------------------
+static QStringList makeTickerFrames(QRandomGenerator &rng)
+{
+    QStringList frames;
+    frames.reserve(FRAMES);
+    for (int i = 0; i < FRAMES; ++i) {
+        const QString instId = QString("MOCK%1-USDT").arg(int(rng.bounded(500)) + 1, 4, 10, QLatin1Char('0'));
+        const double mid = 100.0 + rng.generateDouble() * 50000.0;
+        frames << QString("{\"arg\":{\"channel\":\"tickers\",\"instId\":\"%1\"},\"data\":[{\"instType\":\"SPOT\",\"instId\":\"%1\","
+                          "\"last\":\"%2\",\"lastSz\":\"0.0123\",\"askPx\":\"%3\",\"askSz\":\"%4\",\"bidPx\":\"%5\",\"bidSz\":\"%6\","
+                          "\"open24h\":\"%2\",\"high24h\":\"%3\",\"low24h\":\"%5\",\"volCcy24h\":\"123456.78\",\"vol24h\":\"9876.5\","
+                          "\"sodUtc0\":\"%2\",\"sodUtc8\":\"%2\",\"ts\":\"%7\"}]}")
+                      .arg(instId)
+                      .arg(mid, 0, 'f', 2)
+                      .arg(mid + 0.01, 0, 'f', 2)
+                      .arg(rng.generateDouble() * 10.0, 0, 'f', 4)
+                      .arg(mid - 0.01, 0, 'f', 2)
+                      .arg(rng.generateDouble() * 10.0, 0, 'f', 4)
+                      .arg(1700000000000LL + i);
+    }
+    return frames;
+}
+
+static void benchParser()
+{
+    QRandomGenerator rng(1);
+    const QStringList frames = makeTickerFrames(rng);
+
+    const double jsonNs = timeNs(FRAMES, [&]() {
+        for (const QString &text : frames) {
+            const QJsonObject obj = QJsonDocument::fromJson(text.toUtf8()).object();
+            if (obj.value("arg").toObject().value("channel").toString() != QLatin1String("tickers")) continue;
+            for (const QJsonValue &v : obj.value("data").toArray()) {
+                const QJsonObject o = v.toObject();
+                CryptoCV::OkxTicker t;
+                t.instrument = InstrumentRegistry::instance().intern(o.value("instId").toString());
+                t.last = CryptoCV::Decimal::fromString(o.value("last").toString());
+                t.bid = CryptoCV::Decimal::fromString(o.value("bidPx").toString());
+                t.ask = CryptoCV::Decimal::fromString(o.value("askPx").toString());
+                t.bidQty = CryptoCV::Decimal::fromString(o.value("bidSz").toString());
+                t.askQty = CryptoCV::Decimal::fromString(o.value("askSz").toString());
+                t.ts = o.value("ts").toString().toLongLong();
+                g_checksum += t.last.mantissa + t.instrument + t.ts;
+            }
+        }
+    });
+
+    InstrumentRegistry::Cache instruments;   // As a feed shard holds one
+    const double scanNs = timeNs(FRAMES, [&]() {
+        for (const QString &text : frames) {
+            const char16_t *begin = reinterpret_cast<const char16_t *>(text.constData());
+            OkxFrameParser::Frame<char16_t> frame;
+            if (!OkxFrameParser::parseFrame(begin, begin + text.size(), frame)) continue;
+            if (frame.kind != OkxFrameParser::FrameKind::Data || !frame.channel.equals("tickers")) continue;
+            OkxFrameParser::RecordCursor<char16_t> cursor(frame);
+            OkxFrameParser::TextView<char16_t> record;
+            while (cursor.next(record)) {
+                CryptoCV::OkxTicker t;
+                if (OkxFrameParser::parseTicker(record, t, &instruments))
+                    g_checksum += t.last.mantissa + t.instrument + t.ts;
+            }
+        }
+    });
+
+    report("tickers frame: QJsonDocument -> OkxFrameParser", jsonNs, scanNs);
+}
+
+//------------------------------------------------------------------------------
+// Book side
+//------------------------------------------------------------------------------
+// Wire scales of the generated book: price 0.1, size 0.0001
+static const int PRICE_DECIMALS = 1;
+static const int SIZE_DECIMALS = 4;
+
+struct BookUpdate {
+    qint64 price;   // Mantissa at PRICE_DECIMALS
+    qint64 size;    // Mantissa at SIZE_DECIMALS, 0 = delete
+};
+
+// The level PriceLadder replaced: doubles plus a QString meta, kept best-first
+struct LegacyLevel {
+    double price = 0.0;
+    double quantity = 0.0;
+    QString meta;
+    int orders = 0;
+};
+
+// Bid side updates: mostly within a few ticks of the top, some thousands of
+// ticks deep (so the far end gets trimmed), 20% deletes
+static QVector<BookUpdate> makeBookUpdates(QRandomGenerator &rng)
+{
+    QVector<BookUpdate> updates;
+    updates.reserve(BOOK_UPDATES);
+    const qint64 top = 432500;   // 43250.0
+    for (int i = 0; i < BOOK_UPDATES; ++i) {
+        const qint64 offset = qint64(rng.bounded(1u << rng.bounded(13u)));
+        const bool remove = rng.bounded(5) == 0;
+        updates.append(BookUpdate{top - offset, remove ? 0 : 1 + qint64(rng.bounded(100000))});
+    }
+    return updates;
+}
+
+static void benchBookSide()
+{
+    QRandomGenerator rng(2);
+    const QVector<BookUpdate> updates = makeBookUpdates(rng);
+    const int capacity = BOOK_DEPTH * 2;   // As OrderBookEngine sizes a books side
+
+    // Baseline: best-first levels, lower_bound on the double price, worst level dropped when full
+    QVector<LegacyLevel> levels;
+    levels.reserve(capacity + 1);
+    const double vectorNs = timeNs(BOOK_UPDATES, [&]() {
+        for (const BookUpdate &u : updates) {
+            const double price = double(u.price) / double(PriceLadder::pow10(PRICE_DECIMALS));
+            auto it = std::lower_bound(levels.begin(), levels.end(), price,
+                                       [](const LegacyLevel &l, double p) { return l.price > p; });
+            if (it != levels.end() && it->price == price) {
+                if (u.size == 0) levels.erase(it);
+                else it->quantity = double(u.size) / double(PriceLadder::pow10(SIZE_DECIMALS));
+                continue;
+            }
+            if (u.size == 0) continue;
+            if (levels.size() >= capacity) {
+                if (it == levels.end()) continue;
+                const auto pos = it - levels.begin();
+                levels.removeLast();
+                it = levels.begin() + pos;
+            }
+            LegacyLevel level;
+            level.price = price;
+            level.quantity = double(u.size) / double(PriceLadder::pow10(SIZE_DECIMALS));
+            level.orders = 1;
+            levels.insert(it, level);
+        }
+        g_checksum += levels.size();
+    });
+
+    PriceLadder ladder(PriceLadder::Side::Bid, capacity);
+    ladder.setPriceScale(PRICE_DECIMALS);
+    const double ladderNs = timeNs(BOOK_UPDATES, [&]() {
+        for (const BookUpdate &u : updates) {
+            if (u.size == 0) {
+                ladder.remove(u.price);
+                continue;
+            }
+            PriceLadder::Level level;
+            level.ticks = u.price;
+            level.size = u.size;
+            level.orders = 1;
+            level.priceDecimals = PRICE_DECIMALS;
+            level.sizeDecimals = SIZE_DECIMALS;
+            ladder.upsert(level);
+        }
+        g_checksum += ladder.size();
+    });
+
+    report("book update: QVector<level> -> PriceLadder", vectorNs, ladderNs);
+
+    // Display: the order book window copied and sorted both sides on every refresh
+    const double sortNs = timeNs(BOOK_DISPLAYS, [&]() {
+        for (int i = 0; i < BOOK_DISPLAYS; ++i) {
+            QVector<LegacyLevel> copy = levels;
+            std::sort(copy.begin(), copy.end(), [](const LegacyLevel &a, const LegacyLevel &b) { return a.price > b.price; });
+            for (int d = 0; d < qMin(DISPLAY_LEVELS, int(copy.size())); ++d)
+                g_checksum += qint64(copy.at(d).price);
+        }
+    });
+    const double walkNs = timeNs(BOOK_DISPLAYS, [&]() {
+        for (int i = 0; i < BOOK_DISPLAYS; ++i)
+            ladder.forEachBestFirst(DISPLAY_LEVELS, [&](const PriceLadder::Level &l) { g_checksum += qint64(ladder.price(l)); });
+    });
+
+    report("book display: copy + sort -> best-first walk", sortNs, walkNs);
+}
+
+//------------------------------------------------------------------------------
+// Market Watch rows
+//------------------------------------------------------------------------------
+// A row as the model kept it before: in a std::map keyed by uid
+struct LegacyRow {
+    int uid = 0;
+    QString symbol;
+    int instrument = -1;
+    Decimal lastPrice, prevPrice;
+    Decimal bidPrice, prevBid;
+    Decimal askPrice, prevAsk;
+    Decimal askQty, prevAskQty;
+    Decimal bidQty, prevBidQty;
+    int priceDecimals = 0;
+    int sizeDecimals = 0;
+};
+
+typedef std::map<int, LegacyRow> LegacyRows;
+
+// Cell text as data() built it: the row is found by walking the map to its position
+static QVariant legacyCell(const LegacyRows &rows, int row, int column)
+{
+    auto it = rows.cbegin();
+    std::advance(it, row);
+    const LegacyRow &r = it->second;
+    switch (column) {
+    case CryptoCV::MarketWatchColumn::MarketWatch_LAST_PRICE:   return r.lastPrice.toString(r.priceDecimals);
+    case CryptoCV::MarketWatchColumn::MarketWatch_BID_PRICE:    return r.bidPrice.toString(r.priceDecimals);
+    case CryptoCV::MarketWatchColumn::MarketWatch_ASK_PRICE:    return r.askPrice.toString(r.priceDecimals);
+    case CryptoCV::MarketWatchColumn::MarketWatch_ASK_QUANTITY: return r.askQty.toString(r.sizeDecimals);
+    case CryptoCV::MarketWatchColumn::MarketWatch_BID_QUANTITY: return r.bidQty.toString(r.sizeDecimals);
+    }
+    return QVariant();
+}
+
+// A tick as onBrodcastRcv applied it: scan the rows for the instrument
+static void legacyRoute(LegacyRows &rows, const CryptoCV::OkxTicker &tick)
+{
+    int rowIndex = 0;
+    for (auto &kv : rows) {
+        LegacyRow &r = kv.second;
+        if (r.instrument != tick.instrument) {
+            ++rowIndex;
+            continue;
+        }
+        if (tick.last == r.lastPrice && tick.bid == r.bidPrice && tick.ask == r.askPrice &&
+            tick.bidQty == r.bidQty && tick.askQty == r.askQty)
+            return;
+        r.prevPrice = r.lastPrice;
+        r.prevBid = r.bidPrice;
+        r.prevAsk = r.askPrice;
+        r.prevAskQty = r.askQty;
+        r.prevBidQty = r.bidQty;
+        r.lastPrice = tick.last;
+        r.bidPrice = tick.bid;
+        r.askPrice = tick.ask;
+        r.bidQty = tick.bidQty;
+        r.askQty = tick.askQty;
+        r.priceDecimals = qMax(r.priceDecimals, qMax<int>(tick.last.scale, qMax(tick.bid.scale, tick.ask.scale)));
+        r.sizeDecimals = qMax(r.sizeDecimals, qMax<int>(tick.bidQty.scale, tick.askQty.scale));
+        g_checksum += rowIndex;   // dataChanged row
+        return;
+    }
+}
+
+static QString rowSymbol(int i)
+{
+    return QString("ROW%1-USDT").arg(i, 5, 10, QLatin1Char('0'));
+}
+
+static CryptoCV::OkxTicker makeTick(int instrument, QRandomGenerator &rng)
+{
+    CryptoCV::OkxTicker t;
+    t.instrument = instrument;
+    const qint64 mid = 4300000 + qint64(rng.bounded(10000));
+    t.last = Decimal(mid, 2);
+    t.bid = Decimal(mid - 1, 2);
+    t.ask = Decimal(mid + 1, 2);
+    t.bidQty = Decimal(1 + qint64(rng.bounded(100000)), 4);
+    t.askQty = Decimal(1 + qint64(rng.bounded(100000)), 4);
+    return t;
+}
+
+static void benchModelRows(int count)
+{
+    QRandomGenerator rng(3);
+    QVector<CryptoCV::MarketWatchRowData> rowData;
+    rowData.reserve(count);
+    LegacyRows legacy;
+    QVector<int> instruments;
+    instruments.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        CryptoCV::MarketWatchRowData row;
+        row.symbol = rowSymbol(i);
+        rowData.append(row);
+
+        LegacyRow l;
+        l.uid = i + 1;
+        l.symbol = row.symbol;
+        l.instrument = InstrumentRegistry::instance().intern(row.symbol);
+        legacy.emplace(l.uid, l);
+        instruments.append(l.instrument);
+    }
+    MarketWatchModel model;
+    model.addRows(rowData);
+
+    // One tick per row first, so every cell has a value to format
+    QVector<CryptoCV::OkxTicker> prime;
+    prime.reserve(count);
+    for (int instrument : std::as_const(instruments))
+        prime.append(makeTick(instrument, rng));
+    for (const CryptoCV::OkxTicker &t : std::as_const(prime))
+        legacyRoute(legacy, t);
+    model.onTickBatch(prime);
+
+    QVector<QVector<CryptoCV::OkxTicker>> batches(TICK_BATCHES);
+    for (auto &batch : batches) {
+        batch.reserve(TICKS_PER_BATCH);
+        for (int i = 0; i < TICKS_PER_BATCH; ++i)
+            batch.append(makeTick(instruments.at(int(rng.bounded(count))), rng));
+    }
+
+    const double scanNs = timeNs(TICK_BATCHES * TICKS_PER_BATCH, [&]() {
+        for (const auto &batch : std::as_const(batches)) {
+            for (const CryptoCV::OkxTicker &t : batch)
+                legacyRoute(legacy, t);
+        }
+    });
+    const double indexNs = timeNs(TICK_BATCHES * TICKS_PER_BATCH, [&]() {
+        for (const auto &batch : std::as_const(batches))
+            model.onTickBatch(batch);
+    });
+
+    // DisplayRole reads of price/quantity cells on random rows
+    QVector<QPair<int, int>> cells;
+    cells.reserve(CELL_READS);
+    for (int i = 0; i < CELL_READS; ++i)
+        cells.append(qMakePair(int(rng.bounded(count)),
+                               CryptoCV::MarketWatchColumn::MarketWatch_LAST_PRICE + int(rng.bounded(5))));
+    const double mapNs = timeNs(CELL_READS, [&]() {
+        for (const auto &cell : std::as_const(cells))
+            g_checksum += legacyCell(legacy, cell.first, cell.second).toString().size();
+    });
+    const double vectorNs = timeNs(CELL_READS, [&]() {
+        for (const auto &cell : std::as_const(cells))
+            g_checksum += model.data(model.index(cell.first, cell.second), Qt::DisplayRole).toString().size();
+    });
+
+    report(QString("onTickBatch, %1 rows: map scan -> row index").arg(count).toLatin1().constData(), scanNs, indexNs);
+    report(QString("data(), %1 rows: map walk -> QVector").arg(count).toLatin1().constData(), mapNs, vectorNs);
+}
+
+// A repaint asks for every visible cell, changed or not
+static void benchRepaint()
+{
+    QRandomGenerator rng(4);
+    QVector<CryptoCV::MarketWatchRowData> rowData;
+    QVector<CryptoCV::OkxTicker> ticks;
+    for (int i = 0; i < PAGE_ROWS; ++i) {
+        CryptoCV::MarketWatchRowData row;
+        row.symbol = QString("PAGE%1-USDT").arg(i, 3, 10, QLatin1Char('0'));
+        rowData.append(row);
+        ticks.append(makeTick(InstrumentRegistry::instance().intern(row.symbol), rng));
+    }
+    MarketWatchModel model;
+    model.addRows(rowData);
+    model.onTickBatch(ticks);
+
+    const int firstColumn = CryptoCV::MarketWatchColumn::MarketWatch_LAST_PRICE;
+    const int cells = CryptoCV::MarketWatchColumn::MarketWatch_TOTAL_COLUMNS - firstColumn;
+    const double numberNs = timeNs(REPAINTS * PAGE_ROWS * cells, [&]() {
+        for (int n = 0; n < REPAINTS; ++n) {
+            for (const CryptoCV::OkxTicker &t : std::as_const(ticks)) {
+                g_checksum += QString::number(t.last.toDouble(), 'f', t.last.scale).size();
+                g_checksum += QString::number(t.bid.toDouble(), 'f', t.bid.scale).size();
+                g_checksum += QString::number(t.ask.toDouble(), 'f', t.ask.scale).size();
+                g_checksum += QString::number(t.askQty.toDouble(), 'f', t.askQty.scale).size();
+                g_checksum += QString::number(t.bidQty.toDouble(), 'f', t.bidQty.scale).size();
+            }
+        }
+    });
+    const double cachedNs = timeNs(REPAINTS * PAGE_ROWS * cells, [&]() {
+        for (int n = 0; n < REPAINTS; ++n) {
+            for (int row = 0; row < PAGE_ROWS; ++row) {
+                for (int column = firstColumn; column < firstColumn + cells; ++column)
+                    g_checksum += model.data(model.index(row, column), Qt::DisplayRole).toString().size();
+            }
+        }
+    });
+    report("Repaint cell: QString::number -> cached text", numberNs, cachedNs);
+}
+
+// Restoring a watchlist and deleting a Ctrl/Shift selection, one row at a time vs in one batch
+static void benchRowBatches(int count)
+{
+    QVector<CryptoCV::MarketWatchRowData> rowData;
+    rowData.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        CryptoCV::MarketWatchRowData row;
+        row.symbol = rowSymbol(i);
+        rowData.append(row);
+    }
+    // Blocks of 10 selected rows with 10-row gaps: count / 20 ranges, bottom rows first as a view hands them over
+    QList<int> selection;
+    for (int row = count - 1; row >= 0; --row) {
+        if ((row / 10) % 2 == 0)
+            selection << row;
+    }
+
+    MarketWatchModel single, batch;
+    const double addRowNs = timeNs(count, [&]() {
+        for (const CryptoCV::MarketWatchRowData &row : std::as_const(rowData))
+            single.addRow(row);
+    });
+    const double addRowsNs = timeNs(count, [&]() { batch.addRows(rowData); });
+
+    const double removeRowNs = timeNs(int(selection.size()), [&]() {
+        for (int row : std::as_const(selection))   // Descending, so the rows still to go keep their indexes
+            single.removeRowAt(row);
+    });
+    const double removeRowsNs = timeNs(int(selection.size()), [&]() { batch.removeRowsAt(selection); });
+    g_checksum += single.rowCount() + batch.rowCount();
+
+    report(QString("Add %1 rows: addRow each -> addRows").arg(count).toLatin1().constData(), addRowNs, addRowsNs);
+    report(QString("Remove %1 rows: removeRowAt each -> removeRowsAt").arg(selection.size()).toLatin1().constData(),
+           removeRowNs, removeRowsNs);
+}
+
+// Formatted cell text held by a model (QString payloads; the row structs are the same size either way)
+static qint64 cellTextBytes(const MarketWatchModel &model)
+{
+    qint64 bytes = 0;
+    for (const CryptoCV::MarketWatchRowData &r : model.rows) {
+        for (const QString &text : r.text)
+            bytes += text.capacity() * qint64(sizeof(QChar));
+    }
+    return bytes;
+}
+
+// The "All instruments" table: every tick of the universe, a page scrolling down it
+static void benchUniverseScroll()
+{
+    QRandomGenerator rng(5);
+    QVector<CryptoCV::MarketWatchRowData> rowData;
+    QVector<int> instruments;
+    rowData.reserve(UNIVERSE_ROWS);
+    for (int i = 0; i < UNIVERSE_ROWS; ++i) {
+        CryptoCV::MarketWatchRowData row;
+        row.symbol = QString("ALL%1-USDT").arg(i, 5, 10, QLatin1Char('0'));
+        rowData.append(row);
+        instruments.append(InstrumentRegistry::instance().intern(row.symbol));
+    }
+    MarketWatchModel full, limited;
+    limited.setViewportLimited(true);
+    full.addRows(rowData);
+    limited.addRows(rowData);
+
+    QVector<QVector<CryptoCV::OkxTicker>> batches(SCROLL_STEPS);
+    for (auto &batch : batches) {
+        batch.reserve(TICKS_PER_BATCH);
+        for (int i = 0; i < TICKS_PER_BATCH; ++i)
+            batch.append(makeTick(instruments.at(int(rng.bounded(UNIVERSE_ROWS))), rng));
+    }
+
+    const int firstColumn = CryptoCV::MarketWatchColumn::MarketWatch_LAST_PRICE;
+    const int lastColumn = CryptoCV::MarketWatchColumn::MarketWatch_TOTAL_COLUMNS - 1;
+    // Each step: scroll a few rows, apply a batch, paint the page
+    auto run = [&](MarketWatchModel &model, bool viewport) {
+        for (int step = 0; step < SCROLL_STEPS; ++step) {
+            const int top = (step * 7) % (UNIVERSE_ROWS - PAGE_ROWS);
+            if (viewport) {
+                QVector<int> window;
+                for (int row = qMax(0, top - VIEWPORT_MARGIN); row < qMin(UNIVERSE_ROWS, top + PAGE_ROWS + VIEWPORT_MARGIN); ++row)
+                    window.append(row);
+                model.setViewportRows(window);
+            }
+            model.onTickBatch(batches.at(step));
+            for (int row = top; row < top + PAGE_ROWS; ++row) {
+                for (int column = firstColumn; column <= lastColumn; ++column)
+                    g_checksum += model.data(model.index(row, column), Qt::DisplayRole).toString().size();
+            }
+        }
+    };
+    const double fullNs = timeNs(SCROLL_STEPS * TICKS_PER_BATCH, [&]() { run(full, false); });
+    const double limitedNs = timeNs(SCROLL_STEPS * TICKS_PER_BATCH, [&]() { run(limited, true); });
+
+    report("10k rows, tick + scroll: all rows -> viewport", fullNs, limitedNs);
+    reportBytes("10k rows, cell text held: all rows -> viewport", cellTextBytes(full), cellTextBytes(limited));
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    benchParser();
+    benchBookSide();
+    for (int rows : {100, 1000, 10000})
+        benchModelRows(rows);
+    benchRepaint();
+    for (int rows : {1000, 10000})
+        benchRowBatches(rows);
+    benchUniverseScroll();
+
+    std::printf("checksum %lld\n", static_cast<long long>(g_checksum));
+    return 0;
+}
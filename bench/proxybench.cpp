@@ -0,0 +1,89 @@
+/******************************************************************************
+ * proxybench.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 16-10-2026
+ *
+ * Description:
+ *   IncrementalSortProxy vs QSortFilterProxyModel (dynamic sort on) over the
+ *   same QStandardItemModel, sorted by a numeric column, at 1k and 10k rows.
+ *   - Key changes: single-cell dataChanged on the sort column (tick flow)
+ *   - Inserts: single rows at random source positions
+ *   - Removes: single rows at random source positions (multi-select delete)
+ *   Prints microseconds per operation; the source's own cost is in both.
+ ******************************************************************************/
+
+#include <QCoreApplication>
+#include <QStandardItemModel>
+#include <QSortFilterProxyModel>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <cstdio>
+#include <functional>
+#include "incrementalsortproxy.h"
+
+static const int OPERATIONS = 2000;
+
+static void fill(QStandardItemModel &source, int rows, QRandomGenerator &rng)
+{
+    source.clear();
+    source.setColumnCount(2);
+    for (int row = 0; row < rows; ++row) {
+        QStandardItem *key = new QStandardItem;
+        key->setData(rng.generateDouble() * 1000.0, Qt::DisplayRole);
+        source.appendRow({key, new QStandardItem(QString::number(row))});
+    }
+}
+
+// Microseconds per call of op over OPERATIONS calls
+static double timeUs(const std::function<void(int)> &op)
+{
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < OPERATIONS; ++i)
+        op(i);
+    return double(timer.nsecsElapsed()) / 1000.0 / OPERATIONS;
+}
+
+static void run(const char *name, int rows, QAbstractItemModel *proxy, QStandardItemModel &source)
+{
+    QRandomGenerator rng(42);
+    fill(source, rows, rng);
+    proxy->sort(0);
+
+    const double keyUs = timeUs([&](int) {
+        source.item(int(rng.bounded(source.rowCount())), 0)->setData(rng.generateDouble() * 1000.0, Qt::DisplayRole);
+    });
+    const double insertUs = timeUs([&](int) {
+        QStandardItem *key = new QStandardItem;
+        key->setData(rng.generateDouble() * 1000.0, Qt::DisplayRole);
+        source.insertRow(int(rng.bounded(source.rowCount() + 1)), {key, new QStandardItem(QStringLiteral("new"))});
+    });
+    const double removeUs = timeUs([&](int) {
+        source.removeRow(int(rng.bounded(source.rowCount())));
+    });
+    std::printf("%-24s %6d rows  key change %9.2f us  insert %9.2f us  remove %9.2f us\n",
+                name, rows, keyUs, insertUs, removeUs);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    for (int rows : {1000, 10000}) {
+        {
+            QStandardItemModel source;
+            QSortFilterProxyModel proxy;
+            proxy.setDynamicSortFilter(true);
+            proxy.setSourceModel(&source);
+            run("QSortFilterProxyModel", rows, &proxy, source);
+        }
+        {
+            QStandardItemModel source;
+            IncrementalSortProxy proxy;
+            proxy.setSourceModel(&source);
+            run("IncrementalSortProxy", rows, &proxy, source);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+/******************************************************************************
+ * CandleAggregator.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Implementation of the streaming OHLCV aggregator.
+ ******************************************************************************/
+
+#include "candleaggregator.h"
+
+static const qint64 INTERVALS_MS[CandleAggregator::TIMEFRAME_COUNT] = { 1000, 60000, 300000, 3600000 };
+static const char *const BAR_NAMES[CandleAggregator::TIMEFRAME_COUNT] = { "1s", "1m", "5m", "1H" };
+static const size_t MAX_PENDING_PRINTS = 65536;   // Per instrument; ~3 MB at most, only while backfills are in flight
+
+qint64 CandleAggregator::intervalMs(int timeframe)
+{
+    return INTERVALS_MS[timeframe];
+}
+
+QString CandleAggregator::barName(int timeframe)
+{
+    return QString::fromLatin1(BAR_NAMES[timeframe]);
+}
+
+int CandleAggregator::timeframeOf(const QString &bar)
+{
+    for (int tf = 0; tf < TIMEFRAME_COUNT; ++tf) {
+        if (bar == QLatin1String(BAR_NAMES[tf])) return tf;
+    }
+    return -1;
+}
+
+CandleAggregator::CandleAggregator(int historyBars)
+    : m_historyBars(qMax(2, historyBars))
+{
+}
+
+CandleAggregator::Instrument *CandleAggregator::find(int instrument) const
+{
+    if (instrument < 0 || instrument >= int(m_instruments.size())) return nullptr;
+    return m_instruments[size_t(instrument)].get();
+}
+
+void CandleAggregator::open(int instrument)
+{
+    if (instrument < 0 || find(instrument)) return;
+    if (instrument >= int(m_instruments.size())) m_instruments.resize(size_t(instrument) + 1);
+
+    Instrument *inst = new Instrument;
+    for (Series &s : inst->series) {
+        s.bars.resize(size_t(m_historyBars));   // The only allocation of a series
+        s.awaitingBackfill = true;
+    }
+    m_instruments[size_t(instrument)].reset(inst);
+}
+
+void CandleAggregator::close(int instrument)
+{
+    if (find(instrument)) m_instruments[size_t(instrument)].reset();
+}
+
+void CandleAggregator::onTrade(const CryptoCV::TradePrint &print)
+{
+    Instrument *found = find(print.instrument);
+    if (!found) return;
+    Instrument &inst = *found;
+    ++m_stats.prints;
+
+    bool buffering = false;
+    for (int tf = 0; tf < TIMEFRAME_COUNT; ++tf) {
+        buffering |= inst.series[tf].awaitingBackfill;
+        add(inst.series[tf], tf, print);
+    }
+    if (buffering && !inst.pendingOverflow) {
+        if (inst.pending.size() < MAX_PENDING_PRINTS)
+            inst.pending.push_back(print);
+        else
+            inst.pendingOverflow = true;
+    }
+}
+
+void CandleAggregator::add(Series &s, int timeframe, const CryptoCV::TradePrint &print)
+{
+    if (print.ts <= s.cutoverTs) {
+        ++m_stats.beforeCutover;
+        return;
+    }
+    const qint64 bucket = print.ts - print.ts % INTERVALS_MS[timeframe];
+
+    CryptoCV::Candle *c = s.size > 0 ? &s.at(0) : nullptr;
+    if (c && bucket < c->openTime) {
+        ++m_stats.latePrints;   // Out-of-order print for a closed bar
+        return;
+    }
+    if (!c || bucket > c->openTime) {
+        if (c) c->confirmed = true;
+        c = &s.push();
+        c->openTime = bucket;
+        c->open = c->high = c->low = print.price;
+    }
+
+    c->high = qMax(c->high, print.price);
+    c->low = qMin(c->low, print.price);
+    c->close = print.price;
+    c->volume += print.size;
+    c->turnover += print.price * print.size;
+    ++c->trades;
+    s.dirty = true;
+}
+
+void CandleAggregator::applyBackfill(int instrument, int timeframe, const QVector<CryptoCV::Candle> &bars, qint64 snapshotTs)
+{
+    Instrument *inst = find(instrument);
+    if (!inst || timeframe < 0 || timeframe >= TIMEFRAME_COUNT) return;
+    if (bars.isEmpty()) {
+        abandonBackfill(instrument, timeframe);
+        return;
+    }
+    Series &s = inst->series[timeframe];
+    ++m_stats.backfills;
+
+    // With every print since open() at hand, the series is REST plus the
+    // buffered prints after the snapshot. If the buffer overflowed, the live
+    // bars newer than everything REST returned are the best that is left.
+    const bool replay = s.awaitingBackfill && !inst->pendingOverflow;
+    if (s.awaitingBackfill && inst->pendingOverflow) ++m_stats.bufferOverflows;
+    const qint64 newestRest = bars.first().openTime;
+    QVector<CryptoCV::Candle> live;
+    if (!replay) {
+        for (int age = 0; age < s.size && s.at(age).openTime > newestRest; ++age)
+            live.prepend(s.at(age));
+    }
+
+    s.head = 0;
+    s.size = 0;
+    const int keepRest = qMin(bars.size(), m_historyBars - live.size());
+    for (int i = keepRest - 1; i >= 0; --i)
+        s.push() = bars.at(i);
+    for (const CryptoCV::Candle &c : std::as_const(live))
+        s.push() = c;
+
+    s.cutoverTs = qMax(s.cutoverTs, snapshotTs);
+    if (replay) {
+        for (const CryptoCV::TradePrint &print : inst->pending) {
+            if (print.ts <= s.cutoverTs) continue;
+            add(s, timeframe, print);
+            ++m_stats.replayedPrints;
+        }
+    }
+    s.awaitingBackfill = false;
+    s.dirty = true;
+    releasePending(*inst);
+}
+
+void CandleAggregator::abandonBackfill(int instrument, int timeframe)
+{
+    Instrument *inst = find(instrument);
+    if (!inst || timeframe < 0 || timeframe >= TIMEFRAME_COUNT) return;
+    inst->series[timeframe].awaitingBackfill = false;
+    releasePending(*inst);
+}
+
+void CandleAggregator::releasePending(Instrument &inst)
+{
+    for (const Series &s : inst.series) {
+        if (s.awaitingBackfill) return;
+    }
+    std::vector<CryptoCV::TradePrint>().swap(inst.pending);
+    inst.pendingOverflow = false;
+}
+
+int CandleAggregator::barCount(int instrument, int timeframe) const
+{
+    Instrument *inst = find(instrument);
+    return inst ? inst->series[timeframe].size : 0;
+}
+
+const CryptoCV::Candle &CandleAggregator::bar(int instrument, int timeframe, int age) const
+{
+    return find(instrument)->series[timeframe].at(age);
+}
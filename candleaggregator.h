@@ -0,0 +1,171 @@
+/******************************************************************************
+ * CandleAggregator.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Streaming OHLCV bars (1s / 1m / 5m / 1H) built from the trades channel.
+ *   - O(1) work per print per timeframe: only the open bar is touched
+ *   - Bounded memory: each instrument/timeframe keeps a fixed ring of bars
+ *   - REST history (GET /api/v5/market/candles) backfills the ring. Live prints
+ *     are buffered from open() until the reply; those stamped after the REST
+ *     snapshot (exchange clock) are re-applied on top, so none is lost or
+ *     counted twice
+ ******************************************************************************/
+
+#ifndef CANDLEAGGREGATOR_H
+#define CANDLEAGGREGATOR_H
+
+#include <QString>
+#include <QVector>
+#include <vector>
+#include <memory>
+#include "protocol.h"
+
+/**
+ * @class CandleAggregator
+ * @brief Owns the bar series of every instrument with candles enabled (single-threaded use).
+ */
+class CandleAggregator
+{
+public:
+    static const int TIMEFRAME_COUNT = 4;
+
+    /**
+     * Bucket length of a timeframe index (1 s, 1 min, 5 min, 1 h).
+     */
+    static qint64 intervalMs(int timeframe);
+
+    /**
+     * OKX "bar" parameter of a timeframe index ("1s", "1m", "5m", "1H").
+     */
+    static QString barName(int timeframe);
+
+    /**
+     * Timeframe index of an OKX bar name, -1 if not aggregated here.
+     */
+    static int timeframeOf(const QString &bar);
+
+    /**
+     * Counters across all series.
+     */
+    struct Stats {
+        quint64 prints = 0;
+        quint64 latePrints = 0;      ///< Older than the open bar; dropped
+        quint64 beforeCutover = 0;   ///< Already covered by a REST backfill
+        quint64 backfills = 0;
+        quint64 replayedPrints = 0;  ///< Buffered prints re-applied over a backfill
+        quint64 bufferOverflows = 0; ///< Backfills that found the print buffer full
+    };
+
+    /**
+     * @param historyBars Bars kept per instrument and timeframe (Feed/candleHistory)
+     */
+    explicit CandleAggregator(int historyBars);
+
+    /**
+     * Starts aggregating an instrument (no-op if already open). Prints are
+     * buffered until every timeframe got its backfill (or gave up on it).
+     * @param instrument InstrumentRegistry id
+     */
+    void open(int instrument);
+
+    /**
+     * Drops all bars of an instrument.
+     */
+    void close(int instrument);
+
+    /**
+     * Adds one trade to every timeframe of its instrument (ignored if not open).
+     */
+    void onTrade(const CryptoCV::TradePrint &print);
+
+    /**
+     * Replaces a timeframe with REST bars and re-applies the buffered live
+     * prints stamped after the snapshot.
+     * @param bars       Newest-first rows of /api/v5/market/candles
+     * @param snapshotTs Exchange time (ms) the REST bars were taken at: prints
+     *                   up to it are inside them and are skipped from now on
+     */
+    void applyBackfill(int instrument, int timeframe, const QVector<CryptoCV::Candle> &bars, qint64 snapshotTs);
+
+    /**
+     * A backfill request failed: the timeframe keeps its live bars and stops
+     * holding the print buffer.
+     */
+    void abandonBackfill(int instrument, int timeframe);
+
+    /**
+     * Number of bars held (open bar included).
+     */
+    int barCount(int instrument, int timeframe) const;
+
+    /**
+     * Bar by age (0 = open bar). No bounds check.
+     */
+    const CryptoCV::Candle &bar(int instrument, int timeframe, int age) const;
+
+    /**
+     * Visits the open bar of every series changed since the last call.
+     * @param fn Called as fn(instrument, timeframe, candle)
+     */
+    template <typename Fn>
+    void forEachDirty(Fn fn)
+    {
+        for (int id = 0; id < int(m_instruments.size()); ++id) {
+            Instrument *inst = m_instruments[size_t(id)].get();
+            if (!inst) continue;
+            for (int tf = 0; tf < TIMEFRAME_COUNT; ++tf) {
+                Series &s = inst->series[tf];
+                if (!s.dirty || s.size == 0) continue;
+                s.dirty = false;
+                fn(id, tf, s.at(0));
+            }
+        }
+    }
+
+    const Stats &stats() const { return m_stats; }
+
+private:
+    // Fixed ring of bars, newest at head - 1
+    struct Series {
+        std::vector<CryptoCV::Candle> bars;
+        int head = 0;
+        int size = 0;
+        qint64 cutoverTs = 0;   // Prints at or before this are in the backfill
+        bool awaitingBackfill = false;
+        bool dirty = false;
+
+        CryptoCV::Candle &at(int age)
+        {
+            int index = head - 1 - age;
+            if (index < 0) index += int(bars.size());
+            return bars[size_t(index)];
+        }
+        CryptoCV::Candle &push()
+        {
+            CryptoCV::Candle &c = bars[size_t(head)];
+            head = (head + 1) % int(bars.size());
+            if (size < int(bars.size())) ++size;
+            c = CryptoCV::Candle();
+            return c;
+        }
+    };
+
+    struct Instrument {
+        Series series[TIMEFRAME_COUNT];
+        std::vector<CryptoCV::TradePrint> pending;   // Prints since open(), while a backfill is due
+        bool pendingOverflow = false;                // pending hit MAX_PENDING_PRINTS
+    };
+
+    Instrument *find(int instrument) const;
+    void add(Series &s, int timeframe, const CryptoCV::TradePrint &print);   // One print into one timeframe
+    static void releasePending(Instrument &inst);                          // Frees the buffer once no backfill is due
+
+    int m_historyBars;
+    std::vector<std::unique_ptr<Instrument>> m_instruments;   // Indexed by instrument id, null if closed
+    Stats m_stats;
+};
+
+#endif // CANDLEAGGREGATOR_H
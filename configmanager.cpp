@@ -60,6 +60,33 @@ void ConfigManager::loadConfig()
         m_settings->sync();  // Save defaults immediately
     }
 
+    // Feed options (defaults keep the single-threaded behaviour)
+    m_threadedIngest = m_settings->value("Feed/threadedIngest", false).toBool();
+    m_tickQueueCapacity = m_settings->value("Feed/tickQueueCapacity", 16384).toInt();
+    m_conflationIntervalMs = m_settings->value("Feed/conflationMs", 16).toInt();
+    m_feedShardCount = m_settings->value("Feed/shards", 1).toInt();
+    m_feedShardPolicy = m_settings->value("Feed/shardPolicy", "hash").toString();
+    m_maxInstrumentsPerShard = m_settings->value("Feed/maxInstrumentsPerShard", 500).toInt();
+    m_feedStaleSeconds = m_settings->value("Feed/staleSeconds", 30).toInt();
+    m_feedQuietSeconds = m_settings->value("Feed/quietSeconds", 300).toInt();
+    m_reconnectMaxBackoffMs = m_settings->value("Feed/maxBackoffMs", 30000).toInt();
+    m_orderBookChannel = m_settings->value("Feed/bookChannel", "books").toString();
+    m_tradeQueueCapacity = m_settings->value("Feed/tradeQueueCapacity", 32768).toInt();
+    m_tapeCapacity = m_settings->value("Feed/tapeCapacity", 5000).toInt();
+    m_candleHistory = m_settings->value("Feed/candleHistory", 720).toInt();
+    m_recordFile = m_settings->value("Feed/recordFile", "").toString();
+    m_replayFile = m_settings->value("Feed/replayFile", "").toString();
+    m_replaySpeed = m_settings->value("Feed/replaySpeed", 1.0).toDouble();
+    m_wsUrl = m_settings->value("Feed/wsUrl", "wss://ws.okx.com:8443/ws/v5/public").toString();
+    m_restUrl = m_settings->value("Feed/restUrl", "https://www.okx.com").toString();
+    while (m_restUrl.endsWith('/'))
+        m_restUrl.chop(1);
+    m_metricsPort = m_settings->value("Metrics/port", 9469).toInt();
+    m_flashMs = m_settings->value("MarketWatch/flashMs", 150).toInt();
+    m_flashFade = m_settings->value("MarketWatch/flashFade", false).toBool();
+    m_allInstrumentTypes = m_settings->value("MarketWatch/allInstrumentTypes",
+                                             QStringList{"SPOT", "SWAP", "FUTURES"}).toStringList();
+    m_viewportMarginRows = m_settings->value("MarketWatch/viewportMargin", 20).toInt();
 
 }
 
@@ -117,6 +144,120 @@ void ConfigManager::removeFavoritePair(const QString& pair)
 }
 
 
+bool ConfigManager::getThreadedIngest() const
+{
+    return m_threadedIngest;
+}
+
+int ConfigManager::getTickQueueCapacity() const
+{
+    return m_tickQueueCapacity;
+}
+
+int ConfigManager::getConflationIntervalMs() const
+{
+    return m_conflationIntervalMs;
+}
+
+int ConfigManager::getFeedShardCount() const
+{
+    return m_feedShardCount;
+}
+
+QString ConfigManager::getFeedShardPolicy() const
+{
+    return m_feedShardPolicy;
+}
+
+int ConfigManager::getMaxInstrumentsPerShard() const
+{
+    return m_maxInstrumentsPerShard;
+}
+
+int ConfigManager::getFeedStaleSeconds() const
+{
+    return m_feedStaleSeconds;
+}
+
+int ConfigManager::getFeedQuietSeconds() const
+{
+    return m_feedQuietSeconds;
+}
+
+int ConfigManager::getReconnectMaxBackoffMs() const
+{
+    return m_reconnectMaxBackoffMs;
+}
+
+QString ConfigManager::getOrderBookChannel() const
+{
+    return m_orderBookChannel;
+}
+
+int ConfigManager::getTradeQueueCapacity() const
+{
+    return m_tradeQueueCapacity;
+}
+
+int ConfigManager::getTapeCapacity() const
+{
+    return m_tapeCapacity;
+}
+
+int ConfigManager::getCandleHistory() const
+{
+    return m_candleHistory;
+}
+
+QString ConfigManager::getRecordFile() const
+{
+    return m_recordFile;
+}
+
+QString ConfigManager::getReplayFile() const
+{
+    return m_replayFile;
+}
+
+double ConfigManager::getReplaySpeed() const
+{
+    return m_replaySpeed;
+}
+
+QString ConfigManager::getWsUrl() const
+{
+    return m_wsUrl;
+}
+
+QString ConfigManager::getRestUrl() const
+{
+    return m_restUrl;
+}
+
+int ConfigManager::getMetricsPort() const
+{
+    return m_metricsPort;
+}
+
+int ConfigManager::getFlashMs() const
+{
+    return m_flashMs;
+}
+
+bool ConfigManager::getFlashFade() const
+{
+    return m_flashFade;
+}
+
+QStringList ConfigManager::getAllInstrumentTypes() const
+{
+    return m_allInstrumentTypes;
+}
+
+int ConfigManager::getViewportMarginRows() const
+{
+    return m_viewportMarginRows;
+}
 
 void ConfigManager::save()
 {
@@ -26,6 +26,32 @@ public:
     void addFavoritePair(const QString& pair);
     void removeFavoritePair(const QString& pair);
 
+    // Market data feed
+    bool getThreadedIngest() const;       // Run socket + parsing on a dedicated thread
+    int getTickQueueCapacity() const;     // Slots in the network -> GUI tick queue
+    int getConflationIntervalMs() const;  // Tick release cadence, 0 = no conflation
+    int getFeedShardCount() const;        // WebSocket connections in the subscription pool
+    QString getFeedShardPolicy() const;   // "hash" (stable by instId) or "load" (least loaded)
+    int getMaxInstrumentsPerShard() const; // Pool grows past Feed/shards to stay under this, 0 = fixed pool
+    int getFeedStaleSeconds() const;      // Reconnect a shard silent (not even pongs) for this long, 0 = off
+    int getFeedQuietSeconds() const;      // Resubscribe a shard with pongs but no data for this long, 0 = off
+    int getReconnectMaxBackoffMs() const; // Cap for the exponential reconnect delay
+    QString getOrderBookChannel() const;  // Streaming book channel: books, books5 or bbo-tbt
+    int getTradeQueueCapacity() const;    // Network -> GUI trade queue slots
+    int getTapeCapacity() const;          // Prints kept per Time & Sales tape
+    int getCandleHistory() const;         // Bars kept per instrument and timeframe
+    QString getRecordFile() const;        // Capture every inbound frame/reply here, empty = off
+    QString getReplayFile() const;        // Replay this capture instead of connecting, empty = off
+    double getReplaySpeed() const;        // 1 = real time, N = N x, 0 = as fast as possible
+    QString getWsUrl() const;             // Public WebSocket endpoint (point at okxmockserver offline)
+    QString getRestUrl() const;           // REST base URL, no trailing slash
+    int getMetricsPort() const;           // Localhost /metrics (Prometheus) port, 0 = off
+
+    // Market watch display
+    int getFlashMs() const;               // How long a changed cell stays coloured
+    bool getFlashFade() const;            // Fade the colour out instead of dropping it at once
+    QStringList getAllInstrumentTypes() const; // instTypes listed by the "All instruments" view
+    int getViewportMarginRows() const;    // Rows kept live above/below the visible ones (all instruments)
 
 
     // Save and load (automatic, but can call manually)
@@ -40,6 +66,29 @@ private:
     QString m_password;
     QString m_configFile;
     QStringList m_favoritePairs;
+    bool m_threadedIngest = false;
+    int m_tickQueueCapacity = 16384;
+    int m_conflationIntervalMs = 16;
+    int m_feedShardCount = 1;
+    QString m_feedShardPolicy;
+    int m_maxInstrumentsPerShard = 500;
+    int m_feedStaleSeconds = 30;
+    int m_feedQuietSeconds = 300;
+    int m_reconnectMaxBackoffMs = 30000;
+    QString m_orderBookChannel = "books";
+    int m_tradeQueueCapacity = 32768;
+    int m_tapeCapacity = 5000;
+    int m_candleHistory = 720;
+    QString m_recordFile;
+    QString m_replayFile;
+    double m_replaySpeed = 1.0;
+    QString m_wsUrl = "wss://ws.okx.com:8443/ws/v5/public";
+    QString m_restUrl = "https://www.okx.com";
+    int m_metricsPort = 9469;
+    int m_flashMs = 150;
+    bool m_flashFade = false;
+    QStringList m_allInstrumentTypes = {"SPOT", "SWAP", "FUTURES"};
+    int m_viewportMarginRows = 20;
 
 
     void loadConfig();
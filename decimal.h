@@ -0,0 +1,181 @@
+/******************************************************************************
+ * Decimal.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Fixed-point decimal for prices and quantities.
+ *   - int64 mantissa + number of fraction digits, exactly as sent by OKX
+ *     ("43250.10" -> 4325010, scale 2); no floating-point on the way in
+ *   - Equality and ordering are integer compares (values of different
+ *     scale are compared after widening the coarser one)
+ *   - A default-constructed Decimal is null: the field was absent or empty
+ ******************************************************************************/
+
+#ifndef DECIMAL_H
+#define DECIMAL_H
+#pragma once
+
+#include <QString>
+#include <limits>
+
+namespace CryptoCV {
+
+/**
+ * @struct Decimal
+ * @brief Optional exact decimal value (mantissa * 10^-scale).
+ */
+struct Decimal {
+    static const int MAX_SCALE = 18;
+
+    qint64 mantissa = 0;
+    qint8 scale = -1;          ///< Fraction digits; -1 = no value
+
+    Decimal() = default;
+    Decimal(qint64 m, int s) : mantissa(m), scale(static_cast<qint8>(s)) {}
+
+    /**
+     * 10^n for 0 <= n <= 18.
+     */
+    static qint64 pow10(int n)
+    {
+        static const qint64 table[] = {
+            1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL,
+            1000000000LL, 10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL,
+            100000000000000LL, 1000000000000000LL, 10000000000000000LL, 100000000000000000LL,
+            1000000000000000000LL
+        };
+        return table[n];
+    }
+
+    /**
+     * Parses plain decimal text ("-0.0125"); null for empty or malformed text,
+     * more than 18 significant digits or more than 18 fraction digits.
+     * Used on the REST/QJson path; the stream goes through OkxFrameParser::toDecimal,
+     * which accepts and rejects the same text.
+     */
+    static Decimal fromString(const QString &text)
+    {
+        Decimal d;
+        const int n = text.size();
+        int i = 0;
+        const bool negative = n > 0 && text.at(0) == QLatin1Char('-');
+        if (negative) ++i;
+        qint64 m = 0;
+        int digits = 0, fraction = 0;   // Significant digits: leading zeros do not grow m
+        bool any = false, seenDot = false;
+        for (; i < n; ++i) {
+            const ushort c = text.at(i).unicode();
+            if (c >= '0' && c <= '9') {
+                any = true;
+                if ((m != 0 || c != '0') && ++digits > MAX_SCALE) return d;
+                m = m * 10 + qint64(c - '0');
+                if (seenDot && ++fraction > MAX_SCALE) return d;
+            } else if (c == '.' && !seenDot) {
+                seenDot = true;
+            } else {
+                return d;
+            }
+        }
+        if (!any) return d;
+        return Decimal(negative ? -m : m, fraction);
+    }
+
+    /**
+     * True if m * 10^n still fits in 64 bits.
+     */
+    static bool fitsWidened(qint64 m, int n)
+    {
+        const qint64 limit = std::numeric_limits<qint64>::max() / pow10(n);
+        return m <= limit && m >= -limit;
+    }
+
+    bool isNull() const { return scale < 0; }
+
+    double toDouble() const
+    {
+        return isNull() ? 0.0 : double(mantissa) / double(pow10(scale));
+    }
+
+    /**
+     * Same value with more fraction digits (exact). Null stays null; a value
+     * whose mantissa would overflow keeps its scale.
+     */
+    Decimal widened(int toScale) const
+    {
+        if (isNull() || toScale <= scale || !fitsWidened(mantissa, toScale - scale)) return *this;
+        return Decimal(mantissa * pow10(toScale - scale), toScale);
+    }
+
+    /**
+     * -1 / 0 / 1; null compares below every value and equal to null.
+     */
+    int compare(const Decimal &o) const
+    {
+        if (isNull() || o.isNull()) return int(!isNull()) - int(!o.isNull());
+        qint64 a = mantissa, b = o.mantissa;
+        // A mantissa too large to widen is beyond any 64-bit one: its sign decides
+        if (scale < o.scale) {
+            if (!fitsWidened(a, o.scale - scale)) return a < 0 ? -1 : 1;
+            a *= pow10(o.scale - scale);
+        } else if (o.scale < scale) {
+            if (!fitsWidened(b, scale - o.scale)) return b < 0 ? 1 : -1;
+            b *= pow10(scale - o.scale);
+        }
+        return a < b ? -1 : (a > b ? 1 : 0);
+    }
+
+    bool operator==(const Decimal &o) const
+    {
+        // Fast path: same scale is a plain integer compare
+        if (scale == o.scale) return mantissa == o.mantissa;
+        return compare(o) == 0;
+    }
+    bool operator!=(const Decimal &o) const { return !(*this == o); }
+    bool operator<(const Decimal &o) const { return compare(o) < 0; }
+    bool operator>(const Decimal &o) const { return compare(o) > 0; }
+
+    /**
+     * Exact text with the given number of fraction digits (-1 = as stored).
+     * Fewer digits than stored rounds half away from zero. Null gives "".
+     */
+    QString toString(int decimals = -1) const
+    {
+        if (isNull()) return QString();
+        if (decimals < 0) decimals = scale;
+        qint64 m = mantissa;
+        int digits = scale;   // Fraction digits printed from the mantissa
+        if (decimals < scale) {
+            const qint64 div = pow10(scale - decimals);
+            const qint64 half = div / 2;
+            m = (m >= 0 ? m + half : m - half) / div;
+            digits = decimals;
+        }
+
+        const bool negative = m < 0;
+        quint64 u = negative ? quint64(0) - quint64(m) : quint64(m);
+        char buf[48];
+        char *p = buf + sizeof(buf);
+        int written = 0;
+        do {
+            *--p = char('0' + u % 10);
+            u /= 10;
+            if (++written == digits) *--p = '.';
+        } while (u > 0 || written < digits);
+        if (*p == '.') *--p = '0';
+        if (negative) *--p = '-';
+        QString text = QString::fromLatin1(p, int(buf + sizeof(buf) - p));
+
+        // More digits than stored: pad with zeros rather than scale the mantissa
+        if (decimals > digits) {
+            if (digits == 0) text += QLatin1Char('.');
+            text += QString(decimals - digits, QLatin1Char('0'));
+        }
+        return text;
+    }
+};
+
+} // namespace CryptoCV
+
+#endif // DECIMAL_H
@@ -0,0 +1,163 @@
+/******************************************************************************
+ * FeedJournal.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Implementation of the feed journal writer and memory-mapped reader.
+ ******************************************************************************/
+
+#include "feedjournal.h"
+#include <QDateTime>
+#include <QStringEncoder>
+#include <QDebug>
+#include <cstring>
+
+// Records are written in chunks of about this size
+static const int FLUSH_BYTES = 256 * 1024;
+
+static const char MAGIC[4] = { 'C', 'M', 'W', 'J' };
+
+FeedJournalWriter::~FeedJournalWriter()
+{
+    close();
+}
+
+bool FeedJournalWriter::open(const QString &path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Cannot create feed journal" << path << ":" << m_file.errorString();
+        return false;
+    }
+
+    FeedJournal::FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FeedJournal::VERSION;
+    header.startMs = QDateTime::currentMSecsSinceEpoch();
+    m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    m_buffer.reserve(FLUSH_BYTES + 64 * 1024);
+    m_records = 0;
+    m_bytes = sizeof(header);
+    m_clock.start();
+    return true;
+}
+
+void FeedJournalWriter::close()
+{
+    if (!m_file.isOpen()) return;
+    flush();
+    m_file.close();
+    qDebug() << "Feed journal closed:" << m_records << "records," << m_bytes << "bytes";
+}
+
+void FeedJournalWriter::append(FeedJournal::RecordKind kind, int source, int tag, const char *data, int size)
+{
+    if (!m_file.isOpen() || size < 0) return;
+
+    FeedJournal::RecordHeader header;
+    header.offsetNs = m_clock.nsecsElapsed();
+    header.size = static_cast<quint32>(size);
+    header.kind = static_cast<quint8>(kind);
+    header.source = static_cast<quint8>(source);
+    header.tag = static_cast<quint16>(tag);
+    m_buffer.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    m_buffer.append(data, size);
+    ++m_records;
+    m_bytes += sizeof(header) + quint64(size);
+
+    if (m_buffer.size() >= FLUSH_BYTES)
+        flush();
+}
+
+void FeedJournalWriter::append(FeedJournal::RecordKind kind, int source, int tag, const QString &text)
+{
+    // Encode into a reused buffer: no per-frame QByteArray once it has grown
+    QStringEncoder toUtf8(QStringEncoder::Utf8);
+    m_utf8.resize(toUtf8.requiredSpace(text.size()));
+    char *end = toUtf8.appendToBuffer(m_utf8.data(), text);
+    append(kind, source, tag, m_utf8.constData(), int(end - m_utf8.constData()));
+}
+
+void FeedJournalWriter::flush()
+{
+    if (m_buffer.isEmpty() || !m_file.isOpen()) return;
+    if (m_file.write(m_buffer) != m_buffer.size())
+        qWarning() << "Feed journal write failed:" << m_file.errorString();
+    m_buffer.clear();   // Keeps capacity
+}
+
+FeedJournalReader::~FeedJournalReader()
+{
+    close();
+}
+
+bool FeedJournalReader::open(const QString &path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot open feed journal" << path << ":" << m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    if (m_size < qint64(sizeof(FeedJournal::FileHeader))) {
+        qWarning() << "Feed journal" << path << "is too short";
+        close();
+        return false;
+    }
+    m_map = m_file.map(0, m_size);
+    if (!m_map) {
+        qWarning() << "Cannot map feed journal" << path << ":" << m_file.errorString();
+        close();
+        return false;
+    }
+
+    FeedJournal::FileHeader header;
+    std::memcpy(&header, m_map, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != FeedJournal::VERSION) {
+        qWarning() << "Feed journal" << path << "has an unknown format";
+        close();
+        return false;
+    }
+    m_startMs = header.startMs;
+    rewind();
+    return true;
+}
+
+void FeedJournalReader::close()
+{
+    if (m_map) m_file.unmap(const_cast<uchar *>(m_map));
+    m_map = nullptr;
+    m_size = 0;
+    m_pos = 0;
+    if (m_file.isOpen()) m_file.close();
+}
+
+void FeedJournalReader::rewind()
+{
+    m_pos = sizeof(FeedJournal::FileHeader);
+}
+
+bool FeedJournalReader::next(Record &record)
+{
+    if (!m_map || m_size - m_pos < qint64(sizeof(FeedJournal::RecordHeader)))
+        return false;
+
+    FeedJournal::RecordHeader header;
+    std::memcpy(&header, m_map + m_pos, sizeof(header));
+    const qint64 payload = m_pos + qint64(sizeof(header));
+    if (m_size - payload < qint64(header.size))
+        return false;   // Truncated tail (capture killed mid-write)
+
+    record.offsetNs = header.offsetNs;
+    record.kind = static_cast<FeedJournal::RecordKind>(header.kind);
+    record.source = header.source;
+    record.tag = header.tag;
+    record.data = reinterpret_cast<const char *>(m_map + payload);
+    record.size = static_cast<int>(header.size);
+    m_pos = payload + qint64(header.size);
+    return true;
+}
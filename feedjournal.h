@@ -0,0 +1,151 @@
+/******************************************************************************
+ * FeedJournal.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Binary capture of everything the feed receives, for offline replay.
+ *   - FeedJournalWriter appends each raw WebSocket frame and REST reply with
+ *     its receive time (ns since capture start) to a compact journal file
+ *   - FeedJournalReader memory-maps a journal and walks its records without
+ *     copying; payloads point straight into the mapping
+ *
+ *   File layout (little-endian, native struct packing):
+ *     FileHeader { "CMWJ", version, startMs }
+ *     RecordHeader { offsetNs, size, kind, source, tag } + size payload bytes
+ *   WebSocket frames are stored as UTF-8, REST replies as received.
+ ******************************************************************************/
+
+#ifndef FEEDJOURNAL_H
+#define FEEDJOURNAL_H
+
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+namespace FeedJournal {
+
+static const quint32 VERSION = 1;
+
+/**
+ * @enum RecordKind
+ * @brief What a record's payload is.
+ */
+enum class RecordKind : quint8 {
+    WsFrame = 1,      ///< Text frame from a shard (source = shard index)
+    RestTickers,      ///< Ticker snapshot reply (single or bulk seed)
+    RestApi           ///< makeApiRequest reply (tag = ApiRequestType)
+};
+
+struct FileHeader {
+    char magic[4];            ///< "CMWJ"
+    quint32 version;
+    qint64 startMs;           ///< Wall clock at capture start (ms since epoch)
+};
+
+struct RecordHeader {
+    qint64 offsetNs;          ///< Receive time, ns since capture start
+    quint32 size;             ///< Payload bytes following this header
+    quint8 kind;              ///< RecordKind
+    quint8 source;            ///< Shard index (WsFrame), 0 otherwise
+    quint16 tag;              ///< ApiRequestType (RestApi), 0 otherwise
+};
+
+static_assert(sizeof(FileHeader) == 16, "journal file header must stay 16 bytes");
+static_assert(sizeof(RecordHeader) == 16, "journal record header must stay 16 bytes");
+
+} // namespace FeedJournal
+
+/**
+ * @class FeedJournalWriter
+ * @brief Appends records to a journal through a write buffer (connection thread).
+ */
+class FeedJournalWriter
+{
+public:
+    ~FeedJournalWriter();
+
+    /**
+     * Creates (truncates) the journal and writes its header.
+     */
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    /**
+     * Stamps and buffers one record; written out once the buffer is full.
+     */
+    void append(FeedJournal::RecordKind kind, int source, int tag, const char *data, int size);
+    void append(FeedJournal::RecordKind kind, int source, int tag, const QString &text);
+
+    /**
+     * Writes the buffered records to the file.
+     */
+    void flush();
+
+    quint64 records() const { return m_records; }
+    quint64 bytes() const { return m_bytes; }
+
+private:
+    QFile m_file;
+    QByteArray m_buffer;       // Pending records, flushed at FLUSH_BYTES
+    QByteArray m_utf8;         // Reused UTF-16 -> UTF-8 scratch
+    QElapsedTimer m_clock;     // Started at open(); gives offsetNs
+    quint64 m_records = 0;
+    quint64 m_bytes = 0;
+};
+
+/**
+ * @class FeedJournalReader
+ * @brief Sequential, zero-copy access to a memory-mapped journal.
+ */
+class FeedJournalReader
+{
+public:
+    /**
+     * @struct Record
+     * @brief One record; data points into the mapping (valid until close()).
+     */
+    struct Record {
+        qint64 offsetNs = 0;
+        FeedJournal::RecordKind kind = FeedJournal::RecordKind::WsFrame;
+        int source = 0;
+        int tag = 0;
+        const char *data = nullptr;
+        int size = 0;
+    };
+
+    ~FeedJournalReader();
+
+    /**
+     * Maps the journal and validates its header.
+     */
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_map != nullptr; }
+
+    /**
+     * Advances to the next record.
+     * @return false at the end of the journal or on a truncated record
+     */
+    bool next(Record &record);
+
+    /**
+     * Back to the first record.
+     */
+    void rewind();
+
+    qint64 startMs() const { return m_startMs; }
+    qint64 fileSize() const { return m_size; }
+
+private:
+    QFile m_file;
+    const uchar *m_map = nullptr;
+    qint64 m_size = 0;
+    qint64 m_pos = 0;
+    qint64 m_startMs = 0;
+};
+
+#endif // FEEDJOURNAL_H
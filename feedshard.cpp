@@ -0,0 +1,217 @@
+/******************************************************************************
+ * FeedShard.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Implementation of one pooled OKX WebSocket connection.
+ ******************************************************************************/
+
+#include "feedshard.h"
+#include "metricsregistry.h"
+#include <QDebug>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+
+// First reconnect delay; doubles per failed attempt up to the configured cap
+static const int BASE_BACKOFF_MS = 250;
+
+// OKX closes idle sessions after 30 s; a pong every 25 s at most keeps ours open
+static const int MAX_PING_INTERVAL_MS = 25000;
+
+FeedShard::FeedShard(int index, const QUrl &url, QObject *parent)
+    : QObject(parent),
+      m_index(index),
+      // Members are parented so moveToThread() on the pool carries them along
+      m_socket(QString(), QWebSocketProtocol::VersionLatest, this),
+      m_url(url),
+      m_reconnectTimer(this),
+      m_pingTimer(this),
+      m_staleTimer(this)
+{
+    connect(&m_socket, &QWebSocket::connected, this, &FeedShard::onConnected);
+    connect(&m_socket, &QWebSocket::disconnected, this, &FeedShard::onDisconnected);
+    connect(&m_socket, &QWebSocket::textMessageReceived, this, &FeedShard::onTextMessageReceived);
+    connect(&m_socket, QOverload<QAbstractSocket::SocketError>::of(&QWebSocket::error), this, &FeedShard::onSocketError);
+
+    m_reconnectTimer.setSingleShot(true);
+    connect(&m_reconnectTimer, &QTimer::timeout, this, [this]() {
+        qDebug() << "Shard" << m_index << "attempting to reconnect..." << m_reconnectAttempts;
+        m_reconnects++;
+        MetricsRegistry::instance().reconnects.add();
+        connectToServer();
+    });
+
+    m_pingTimer.setInterval(MAX_PING_INTERVAL_MS);
+    connect(&m_pingTimer, &QTimer::timeout, this, &FeedShard::onPingTimeout);
+
+    m_staleTimer.setInterval(1000);
+    connect(&m_staleTimer, &QTimer::timeout, this, &FeedShard::onStaleCheck);
+}
+
+void FeedShard::setReconnectPolicy(int staleSeconds, int quietSeconds, int maxBackoffMs)
+{
+    m_staleMs = qMax(0, staleSeconds) * 1000;
+    m_quietMs = qMax(0, quietSeconds) * 1000;
+    m_maxBackoffMs = qMax(BASE_BACKOFF_MS, maxBackoffMs);
+    // At least two pongs per stale window, so a healthy idle session is never "stale"
+    m_pingTimer.setInterval(m_staleMs > 0 ? qBound(1000, m_staleMs / 2, MAX_PING_INTERVAL_MS) : MAX_PING_INTERVAL_MS);
+}
+
+void FeedShard::connectToServer()
+{
+    if (m_socket.state() == QAbstractSocket::ConnectedState) return;
+    // A half-open attempt (e.g. stuck in ConnectingState) is dropped before retrying
+    if (m_socket.state() != QAbstractSocket::UnconnectedState)
+        m_socket.abort();
+    qDebug() << "Shard" << m_index << "connecting to" << m_url.toString();
+    m_socket.open(m_url);
+}
+
+void FeedShard::scheduleReconnect()
+{
+    if (m_reconnectTimer.isActive()) return;
+    if (m_outageStartMs == 0) {
+        m_outageStartMs = QDateTime::currentMSecsSinceEpoch();
+        ++m_outages;
+        MetricsRegistry::instance().outages.add();
+    }
+
+    // Exponential backoff with "equal jitter": half fixed, half random, capped
+    const int exponent = qMin(m_reconnectAttempts, 16);
+    const qint64 ceiling = qMin<qint64>(m_maxBackoffMs, qint64(BASE_BACKOFF_MS) << exponent);
+    const qint64 delay = ceiling / 2 + QRandomGenerator::global()->bounded(ceiling / 2 + 1);
+    ++m_reconnectAttempts;
+    m_reconnectTimer.start(static_cast<int>(delay));
+}
+
+void FeedShard::sendJson(const QJsonObject &obj)
+{
+    if (m_socket.state() != QAbstractSocket::ConnectedState) {
+        qWarning() << "Shard" << m_index << "not connected - cannot send message.";
+        return;
+    }
+    QJsonDocument doc(obj);
+    m_socket.sendTextMessage(QString::fromUtf8(doc.toJson(QJsonDocument::Compact)));
+}
+
+void FeedShard::onConnected()
+{
+    qDebug() << "Shard" << m_index << "connected successfully.";
+    m_reconnectTimer.stop();
+    m_pingTimer.start();
+    m_lastAliveMs = m_lastDataMs = QDateTime::currentMSecsSinceEpoch();
+    m_staleTimer.start();
+    // Backoff is only reset once data flows again (see onTextMessageReceived), so a
+    // server that accepts and immediately drops us keeps backing off
+    emit connected();
+}
+
+void FeedShard::onDisconnected()
+{
+    qDebug() << "Shard" << m_index << "disconnected.";
+    m_pingTimer.stop();
+    m_staleTimer.stop();
+    emit disconnected();
+    scheduleReconnect();
+}
+
+void FeedShard::onStaleCheck()
+{
+    if (!isConnected()) return;
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+
+    // Pongs but no market data: the instruments may just be illiquid (tickers only
+    // push on change), so the session stays and its subscriptions are refreshed
+    if (m_quietMs > 0 && !m_instIds.isEmpty() && nowMs - m_lastDataMs >= m_quietMs) {
+        qDebug() << "Shard" << m_index << "quiet: no market data for" << nowMs - m_lastDataMs << "ms, resubscribing";
+        m_lastDataMs = nowMs;   // One report per window
+        emit quiet();
+    }
+
+    if (m_staleMs <= 0) return;
+    const qint64 silentMs = nowMs - m_lastAliveMs;
+    if (silentMs < m_staleMs) return;
+
+    qWarning() << "Shard" << m_index << "stale: no frame (not even a pong) for" << silentMs << "ms, reconnecting";
+    ++m_staleDrops;
+    MetricsRegistry::instance().staleDrops.add();
+    m_staleTimer.stop();
+    m_socket.abort();   // Emits disconnected() -> scheduleReconnect()
+    if (!m_reconnectTimer.isActive())
+        scheduleReconnect();
+}
+
+void FeedShard::onPingTimeout()
+{
+    if (m_socket.state() == QAbstractSocket::ConnectedState) {
+        m_socket.sendTextMessage("ping");
+    }
+}
+
+void FeedShard::onTextMessageReceived(const QString &msg)
+{
+    ++m_messages;
+    m_bytes += static_cast<quint64>(msg.size());   // OKX frames are ASCII: 1 byte per QChar
+
+    const bool isPong = (msg == QLatin1String("pong"));
+    // Any frame proves the transport; only market data ends an outage or the quiet window
+    m_lastAliveMs = QDateTime::currentMSecsSinceEpoch();
+    if (!isPong) {
+        m_lastDataMs = m_lastAliveMs;
+        if (m_outageStartMs != 0) {
+            m_lastRecoveryMs = m_lastDataMs - m_outageStartMs;
+            m_maxRecoveryMs = qMax(m_maxRecoveryMs, m_lastRecoveryMs);
+            m_outageStartMs = 0;
+            m_reconnectAttempts = 0;
+            qDebug() << "Shard" << m_index << "recovered in" << m_lastRecoveryMs << "ms";
+        }
+    }
+
+    if (isPong)
+        return;
+    emit textMessageReceived(msg);
+}
+
+void FeedShard::onSocketError(QAbstractSocket::SocketError)
+{
+    QString err = m_socket.errorString();
+    qWarning() << "Shard" << m_index << "WebSocket error:" << err;
+    emit errorOccured(err);
+    // A failed open never reaches disconnected(); keep the retry loop going
+    if (!isConnected())
+        scheduleReconnect();
+}
+
+void FeedShard::noteExchangeTs(qint64 exchangeTs)
+{
+    if (exchangeTs <= 0) return;
+    const qint64 lag = QDateTime::currentMSecsSinceEpoch() - exchangeTs;
+    // EWMA (1/8) so a single slow frame does not dominate the gauge
+    m_lagMs = m_lagMs == 0 ? lag : m_lagMs + (lag - m_lagMs) / 8;
+}
+
+CryptoCV::FeedShardStats FeedShard::sampleStats(qint64 elapsedMs)
+{
+    CryptoCV::FeedShardStats s;
+    s.shard = m_index;
+    s.connected = isConnected();
+    s.subscriptions = m_instIds.size();
+    s.messages = m_messages;
+    s.bytes = m_bytes;
+    if (elapsedMs > 0) {
+        s.msgsPerSec = double(m_messages - m_sampledMessages) * 1000.0 / double(elapsedMs);
+        s.bytesPerSec = double(m_bytes - m_sampledBytes) * 1000.0 / double(elapsedMs);
+    }
+    s.lagMs = m_lagMs;
+    s.reconnects = m_reconnects;
+    s.outages = m_outages;
+    s.staleDrops = m_staleDrops;
+    s.lastRecoveryMs = m_lastRecoveryMs;
+    s.maxRecoveryMs = m_maxRecoveryMs;
+
+    m_sampledMessages = m_messages;
+    m_sampledBytes = m_bytes;
+    return s;
+}
@@ -0,0 +1,151 @@
+/******************************************************************************
+ * FeedShard.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   One OKX public WebSocket connection owned by WebSocketConnection's pool.
+ *   - Owns its QWebSocket, ping timer and reconnect timer (reconnects independently)
+ *   - Reconnects with exponential backoff + jitter and never gives up
+ *   - Detects a stale transport (socket "connected" but not even pongs for
+ *     N seconds) and reconnects; a live transport that carries no market data
+ *     for a longer window only asks for a resubscribe (illiquid instruments
+ *     push nothing for minutes)
+ *   - Remembers which instruments were routed to it (load, resubscription)
+ *   - Remembers extra per-instrument channels (order books) for resubscription
+ *   - Counts messages/bytes and tracks exchange-to-receive lag for stats
+ *   Frames are not parsed here; they are forwarded to WebSocketConnection so
+ *   every shard feeds the same merged tick stream.
+ ******************************************************************************/
+
+#ifndef FEEDSHARD_H
+#define FEEDSHARD_H
+
+#include <QObject>
+#include <QWebSocket>
+#include <QAbstractSocket>
+#include <QTimer>
+#include <QJsonObject>
+#include <QSet>
+#include <QUrl>
+#include "protocol.h"
+#include "instrumentregistry.h"
+
+/**
+ * @class FeedShard
+ * @brief Single WebSocket session in the subscription pool.
+ */
+class FeedShard : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param index Position of this shard in the pool (used in logs/stats)
+     * @param url   WebSocket endpoint
+     * @param parent Owning WebSocketConnection (so the shard follows it across threads)
+     */
+    FeedShard(int index, const QUrl &url, QObject *parent);
+
+    /**
+     * Reconnect/staleness tuning.
+     * @param staleSeconds Drop and reconnect when no frame (data or pong) arrives for this long (0 = off)
+     * @param quietSeconds Emit quiet() when pongs arrive but no market data for this long (0 = off)
+     * @param maxBackoffMs Upper bound for the reconnect delay
+     */
+    void setReconnectPolicy(int staleSeconds, int quietSeconds, int maxBackoffMs);
+
+    int index() const { return m_index; }
+    bool isConnected() const { return m_socket.state() == QAbstractSocket::ConnectedState; }
+
+    /**
+     * Opens the socket unless already connected.
+     */
+    void connectToServer();
+
+    /**
+     * Sends a compact JSON op frame; dropped with a warning while disconnected.
+     */
+    void sendJson(const QJsonObject &obj);
+
+    // Instrument bookkeeping (routing/load)
+    void addInstrument(const QString &instId) { m_instIds.insert(instId); m_instrumentCache.intern(instId); }
+    void removeInstrument(const QString &instId) { m_instIds.remove(instId); }
+    const QSet<QString> &instruments() const { return m_instIds; }
+    int load() const { return m_instIds.size(); }
+
+    // Registry ids of the symbols in this shard's frames, resolved without the registry lock
+    InstrumentRegistry::Cache &instrumentCache() { return m_instrumentCache; }
+
+    // Non-ticker channels on this shard, keyed "channel:instId" (resubscribed on connect)
+    void addChannel(const QString &key) { m_channels.insert(key); }
+    void removeChannel(const QString &key) { m_channels.remove(key); }
+    const QSet<QString> &channels() const { return m_channels; }
+
+    /**
+     * Records the exchange timestamp of a tick parsed from this shard's stream.
+     * @param exchangeTs OKX "ts" (ms since epoch); 0 is ignored
+     */
+    void noteExchangeTs(qint64 exchangeTs);
+
+    /**
+     * Returns counters and rates since the previous call.
+     * @param elapsedMs Time since the previous sample
+     */
+    CryptoCV::FeedShardStats sampleStats(qint64 elapsedMs);
+
+signals:
+    void connected();
+    void disconnected();
+    void errorOccured(const QString &err);
+    void textMessageReceived(const QString &msg);   ///< Any non-pong frame
+    void quiet();                                   ///< Transport alive, no market data for the quiet window
+
+private slots:
+    void onConnected();
+    void onDisconnected();
+    void onTextMessageReceived(const QString &msg);
+    void onSocketError(QAbstractSocket::SocketError error);
+    void onPingTimeout();
+    void onStaleCheck();
+
+private:
+    // Arms m_reconnectTimer with the next backoff delay (no-op if already armed)
+    void scheduleReconnect();
+
+    int m_index;
+    QWebSocket m_socket;
+    QUrl m_url;
+    QTimer m_reconnectTimer;              // Single-shot, re-armed with backoff
+    QTimer m_pingTimer;                   // Send periodic pings to keep alive
+    QTimer m_staleTimer;                  // Watchdog for silent connections
+
+    QSet<QString> m_instIds;              // Instruments routed to this shard (resubscribed on connect)
+    QSet<QString> m_channels;             // "channel:instId" of order book subscriptions
+    InstrumentRegistry::Cache m_instrumentCache;   // Filled on addInstrument() and on first sight in a frame
+
+    int m_reconnectAttempts = 0;          // Since the last successful data frame
+    int m_staleMs = 30000;
+    int m_quietMs = 300000;
+    int m_maxBackoffMs = 30000;
+    qint64 m_lastAliveMs = 0;             // Wall clock of the last frame, pongs included
+    qint64 m_lastDataMs = 0;              // Wall clock of the last data frame (or quiet() report)
+
+    // Outage / time-to-recover tracking
+    qint64 m_outageStartMs = 0;           // 0 while healthy
+    qint64 m_lastRecoveryMs = 0;
+    qint64 m_maxRecoveryMs = 0;
+    int m_outages = 0;
+    int m_staleDrops = 0;
+
+    // Stats
+    quint64 m_messages = 0;
+    quint64 m_bytes = 0;
+    quint64 m_sampledMessages = 0;
+    quint64 m_sampledBytes = 0;
+    qint64 m_lagMs = 0;                   // Smoothed receive time - exchange ts
+    int m_reconnects = 0;
+};
+
+#endif // FEEDSHARD_H
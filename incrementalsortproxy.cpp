@@ -0,0 +1,566 @@
+/******************************************************************************
+ * IncrementalSortProxy.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Implementation of the incrementally sorted Market Watch proxy.
+ ******************************************************************************/
+
+#include "incrementalsortproxy.h"
+#include <algorithm>
+
+IncrementalSortProxy::IncrementalSortProxy(QObject *parent)
+    : QAbstractProxyModel(parent)
+{
+}
+
+void IncrementalSortProxy::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    beginResetModel();
+    for (const QMetaObject::Connection &c : std::as_const(m_sourceConnections))
+        disconnect(c);
+    m_sourceConnections.clear();
+
+    QAbstractProxyModel::setSourceModel(sourceModel);
+    if (sourceModel) {
+        using M = QAbstractItemModel;
+        m_sourceConnections
+            << connect(sourceModel, &M::dataChanged, this, &IncrementalSortProxy::onSourceDataChanged)
+            << connect(sourceModel, &M::headerDataChanged, this, &M::headerDataChanged)
+            // Inserted/removed rows are placed/taken at their ranks; selection and scroll survive
+            << connect(sourceModel, &M::rowsInserted, this, &IncrementalSortProxy::onSourceRowsInserted)
+            << connect(sourceModel, &M::rowsAboutToBeRemoved, this, &IncrementalSortProxy::onSourceRowsAboutToBeRemoved)
+            << connect(sourceModel, &M::rowsRemoved, this, &IncrementalSortProxy::onSourceRowsRemoved)
+            // Anything else structural never comes from the Market Watch model: rebuild behind a reset
+            << connect(sourceModel, &M::rowsAboutToBeMoved, this, &IncrementalSortProxy::onSourceAboutToChange)
+            << connect(sourceModel, &M::rowsMoved, this, &IncrementalSortProxy::onSourceChanged)
+            << connect(sourceModel, &M::columnsAboutToBeInserted, this, &IncrementalSortProxy::onSourceAboutToChange)
+            << connect(sourceModel, &M::columnsInserted, this, &IncrementalSortProxy::onSourceChanged)
+            << connect(sourceModel, &M::columnsAboutToBeRemoved, this, &IncrementalSortProxy::onSourceAboutToChange)
+            << connect(sourceModel, &M::columnsRemoved, this, &IncrementalSortProxy::onSourceChanged)
+            << connect(sourceModel, &M::modelAboutToBeReset, this, &IncrementalSortProxy::onSourceAboutToChange)
+            << connect(sourceModel, &M::modelReset, this, &IncrementalSortProxy::onSourceChanged)
+            << connect(sourceModel, &M::layoutAboutToBeChanged, this, &IncrementalSortProxy::onSourceAboutToChange)
+            << connect(sourceModel, &M::layoutChanged, this, &IncrementalSortProxy::onSourceChanged);
+    }
+    rebuild();
+    endResetModel();
+}
+
+//------------------------------------------------------------------------------
+// Mapping
+//------------------------------------------------------------------------------
+QModelIndex IncrementalSortProxy::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if (!proxyIndex.isValid() || !sourceModel())
+        return QModelIndex();
+    const int sourceRow = select(proxyIndex.row());
+    return sourceRow < 0 ? QModelIndex() : sourceModel()->index(sourceRow, proxyIndex.column());
+}
+
+QModelIndex IncrementalSortProxy::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if (!sourceIndex.isValid() || sourceIndex.parent().isValid())
+        return QModelIndex();
+    const int row = sourceIndex.row();
+    if (row < 0 || row >= int(m_accepted.size()) || !m_accepted[size_t(row)])
+        return QModelIndex();   // Filtered out
+    return index(rankOf(row), sourceIndex.column());
+}
+
+QModelIndex IncrementalSortProxy::index(int row, int column, const QModelIndex &parent) const
+{
+    if (parent.isValid() || row < 0 || row >= rowCount() || column < 0 || column >= columnCount())
+        return QModelIndex();
+    return createIndex(row, column);
+}
+
+QModelIndex IncrementalSortProxy::parent(const QModelIndex &) const
+{
+    return QModelIndex();
+}
+
+int IncrementalSortProxy::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : sizeOf(m_root);
+}
+
+int IncrementalSortProxy::columnCount(const QModelIndex &parent) const
+{
+    return (parent.isValid() || !sourceModel()) ? 0 : sourceModel()->columnCount();
+}
+
+//------------------------------------------------------------------------------
+// Sort and filter settings
+//------------------------------------------------------------------------------
+void IncrementalSortProxy::sort(int column, Qt::SortOrder order)
+{
+    // Re-orders every row once; persistent indexes (selection, current) follow their rows
+    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+    const QModelIndexList from = persistentIndexList();
+    QModelIndexList sources;
+    sources.reserve(from.size());
+    for (const QModelIndex &i : from)
+        sources << mapToSource(i);
+
+    m_sortColumn = column;
+    m_sortOrder = order;
+    rebuild();
+
+    QModelIndexList to;
+    to.reserve(sources.size());
+    for (const QModelIndex &i : std::as_const(sources))
+        to << mapFromSource(i);
+    changePersistentIndexList(from, to);
+    emit layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+}
+
+void IncrementalSortProxy::setSortRole(int role)
+{
+    if (role == m_sortRole) return;
+    m_sortRole = role;
+    if (m_sortColumn >= 0)
+        sort(m_sortColumn, m_sortOrder);
+}
+
+void IncrementalSortProxy::setFilterKeyColumn(int column)
+{
+    if (column == m_filterColumn) return;
+    m_filterColumn = column;
+    if (!m_filterString.isEmpty())
+        refilter();
+}
+
+void IncrementalSortProxy::setFilterCaseSensitivity(Qt::CaseSensitivity cs)
+{
+    if (cs == m_filterCase) return;
+    m_filterCase = cs;
+    if (!m_filterString.isEmpty())
+        refilter();
+}
+
+void IncrementalSortProxy::setFilterFixedString(const QString &pattern)
+{
+    if (pattern == m_filterString) return;
+    m_filterString = pattern;
+    refilter();
+}
+
+void IncrementalSortProxy::refilter()
+{
+    beginResetModel();
+    rebuild();
+    endResetModel();
+}
+
+//------------------------------------------------------------------------------
+// Source changes
+//------------------------------------------------------------------------------
+void IncrementalSortProxy::onSourceAboutToChange()
+{
+    if (m_inSourceChange) return;
+    m_inSourceChange = true;
+    beginResetModel();
+}
+
+void IncrementalSortProxy::onSourceChanged()
+{
+    rebuild();
+    if (!m_inSourceChange) return;
+    m_inSourceChange = false;
+    endResetModel();
+}
+
+void IncrementalSortProxy::onSourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+    renumber(first, last - first + 1);
+
+    // Accepted new rows in proxy order, each with the number of old rows ordered before it
+    std::vector<int> added;
+    for (int row = first; row <= last; ++row) {
+        if (!acceptsRow(row)) continue;
+        m_keys[size_t(row)] = keyOf(row);
+        added.push_back(row);
+    }
+    std::sort(added.begin(), added.end(), [this](int a, int b) {
+        return less(m_keys[size_t(a)], a, m_keys[size_t(b)], b);
+    });
+    std::vector<int> before(added.size());
+    for (size_t i = 0; i < added.size(); ++i)
+        before[i] = countBefore(m_keys[size_t(added[i])], added[i]);   // The tree holds old rows only
+
+    // One insert per run of new rows landing between the same two old rows
+    int inserted = 0;
+    for (size_t i = 0; i < added.size();) {
+        size_t j = i;
+        while (j + 1 < added.size() && before[j + 1] == before[i])
+            ++j;
+        const int at = before[i] + inserted;
+        beginInsertRows(QModelIndex(), at, at + int(j - i));
+        for (size_t k = i; k <= j; ++k) {
+            m_accepted[size_t(added[k])] = 1;
+            insertNode(added[k]);
+        }
+        endInsertRows();
+        inserted += int(j - i + 1);
+        i = j + 1;
+    }
+}
+
+void IncrementalSortProxy::onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    // (proxy row, source row) of the accepted rows going away, in proxy order
+    std::vector<std::pair<int, int>> gone;
+    for (int row = first; row <= last && row < int(m_accepted.size()); ++row) {
+        if (m_accepted[size_t(row)])
+            gone.emplace_back(rankOf(row), row);
+    }
+    std::sort(gone.begin(), gone.end());
+
+    // One remove per run of adjacent proxy rows, bottom-up so the runs above keep their ranks
+    for (size_t end = gone.size(); end > 0;) {
+        size_t begin = end - 1;
+        while (begin > 0 && gone[begin - 1].first == gone[begin].first - 1)
+            --begin;
+        beginRemoveRows(QModelIndex(), gone[begin].first, gone[end - 1].first);
+        for (size_t k = begin; k < end; ++k) {
+            m_root = eraseFrom(m_root, gone[k].second);
+            m_accepted[size_t(gone[k].second)] = 0;
+        }
+        endRemoveRows();
+        end = begin;
+    }
+}
+
+void IncrementalSortProxy::onSourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+    renumber(first, -(last - first + 1));
+}
+
+void IncrementalSortProxy::renumber(int first, int delta)
+{
+    // Opens (delta > 0) or closes (delta < 0) slots at first; closed slots are out of the tree
+    if (delta > 0) {
+        const size_t at = size_t(first), n = size_t(delta);
+        m_keys.insert(m_keys.begin() + at, n, SortKey());
+        m_accepted.insert(m_accepted.begin() + at, n, quint8(0));
+        m_left.insert(m_left.begin() + at, n, -1);
+        m_right.insert(m_right.begin() + at, n, -1);
+        m_size.insert(m_size.begin() + at, n, 1);
+        m_priority.insert(m_priority.begin() + at, n, 0u);
+    } else {
+        const auto erase = [first, delta](auto &v) { v.erase(v.begin() + first, v.begin() + (first - delta)); };
+        erase(m_keys);
+        erase(m_accepted);
+        erase(m_left);
+        erase(m_right);
+        erase(m_size);
+        erase(m_priority);
+    }
+
+    // Node ids are source rows: every link to a row behind the change moves with it.
+    // Shifting keeps the relative order of the old rows, so ties still break the same way.
+    const int from = delta > 0 ? first : first - delta;
+    const auto shift = [from, delta](int &node) { if (node >= from) node += delta; };
+    shift(m_root);
+    for (size_t i = 0; i < m_left.size(); ++i) {
+        shift(m_left[i]);
+        shift(m_right[i]);
+    }
+}
+
+void IncrementalSortProxy::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                               const QList<int> &roles)
+{
+    if (!topLeft.isValid() || !bottomRight.isValid() || topLeft.parent().isValid())
+        return;
+
+    // Display changes are taken to move derived roles (the sort role) too, and
+    // a sort role change to move the text the filter reads (both come from one value)
+    const bool display = roles.isEmpty() || roles.contains(Qt::DisplayRole);
+    const bool sortRole = display || roles.contains(m_sortRole);
+    const bool rekey = m_sortColumn >= topLeft.column() && m_sortColumn <= bottomRight.column() && sortRole;
+    const bool refilterRows = !m_filterString.isEmpty() && sortRole
+                              && m_filterColumn >= topLeft.column() && m_filterColumn <= bottomRight.column();
+
+    m_changedRows.clear();
+    const int lastRow = qMin(bottomRight.row(), int(m_keys.size()) - 1);
+    for (int row = topLeft.row(); row <= lastRow; ++row) {
+        if (refilterRows) {
+            const bool accept = acceptsRow(row);
+            if (accept != bool(m_accepted[size_t(row)])) {
+                // Inserted rows are read fresh, removed ones need no dataChanged
+                if (accept) {
+                    m_keys[size_t(row)] = keyOf(row);
+                    const int at = countBefore(m_keys[size_t(row)], row);
+                    beginInsertRows(QModelIndex(), at, at);
+                    m_accepted[size_t(row)] = 1;
+                    insertNode(row);
+                    endInsertRows();
+                } else {
+                    const int at = rankOf(row);
+                    beginRemoveRows(QModelIndex(), at, at);
+                    m_root = eraseFrom(m_root, row);
+                    m_accepted[size_t(row)] = 0;
+                    endRemoveRows();
+                }
+                continue;
+            }
+        }
+        if (!m_accepted[size_t(row)])
+            continue;
+        if (rekey)
+            reposition(row);
+        m_changedRows.push_back(row);
+    }
+
+    // Ranks are final only after every move: map, then one dataChanged per run of proxy rows
+    for (int &row : m_changedRows)
+        row = rankOf(row);
+    std::sort(m_changedRows.begin(), m_changedRows.end());
+    for (size_t i = 0; i < m_changedRows.size();) {
+        size_t j = i;
+        while (j + 1 < m_changedRows.size() && m_changedRows[j + 1] == m_changedRows[j] + 1)
+            ++j;
+        emit dataChanged(index(m_changedRows[i], topLeft.column()), index(m_changedRows[j], bottomRight.column()), roles);
+        i = j + 1;
+    }
+}
+
+void IncrementalSortProxy::reposition(int sourceRow)
+{
+    SortKey key = keyOf(sourceRow);
+    SortKey &current = m_keys[size_t(sourceRow)];
+    if (key == current)
+        return;
+
+    // New rank among the other rows: the row itself is counted if it moves towards the end
+    const int from = rankOf(sourceRow);
+    int to = countBefore(key, sourceRow);
+    if (less(current, sourceRow, key, sourceRow))
+        --to;
+    if (to == from) {
+        current = std::move(key);   // Same neighbours: the tree order still holds
+        return;
+    }
+
+    beginMoveRows(QModelIndex(), from, from, QModelIndex(), to > from ? to + 1 : to);
+    m_root = eraseFrom(m_root, sourceRow);
+    current = std::move(key);
+    insertNode(sourceRow);
+    endMoveRows();
+    ++m_rowMoves;
+}
+
+//------------------------------------------------------------------------------
+// Keys
+//------------------------------------------------------------------------------
+IncrementalSortProxy::SortKey IncrementalSortProxy::keyOf(int sourceRow) const
+{
+    SortKey key;
+    if (m_sortColumn < 0 || !sourceModel())
+        return key;   // Source order: all keys equal, rows break the tie
+    const QVariant v = sourceModel()->data(sourceModel()->index(sourceRow, m_sortColumn), m_sortRole);
+    switch (v.typeId()) {
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Double:
+    case QMetaType::Float:
+        key.kind = SortKey::Number;
+        key.number = v.toDouble();
+        break;
+    default:
+        key.text = v.toString();
+        key.kind = key.text.isEmpty() ? SortKey::Empty : SortKey::Text;
+        break;
+    }
+    return key;
+}
+
+bool IncrementalSortProxy::acceptsRow(int sourceRow) const
+{
+    if (m_filterString.isEmpty() || !sourceModel())
+        return true;
+    return sourceModel()->data(sourceModel()->index(sourceRow, m_filterColumn), Qt::DisplayRole)
+        .toString().contains(m_filterString, m_filterCase);
+}
+
+bool IncrementalSortProxy::less(const SortKey &ka, int a, const SortKey &kb, int b) const
+{
+    if (m_sortColumn >= 0) {
+        int c = 0;
+        if (ka.kind != kb.kind)
+            c = ka.kind < kb.kind ? -1 : 1;
+        else if (ka.kind == SortKey::Number)
+            c = ka.number < kb.number ? -1 : (kb.number < ka.number ? 1 : 0);
+        else if (ka.kind == SortKey::Text)
+            c = ka.text.compare(kb.text);
+        if (c != 0)
+            return m_sortOrder == Qt::AscendingOrder ? c < 0 : c > 0;
+    }
+    return a < b;
+}
+
+//------------------------------------------------------------------------------
+// Order-statistics treap
+//------------------------------------------------------------------------------
+int IncrementalSortProxy::select(int rank) const
+{
+    int node = m_root;
+    while (node >= 0) {
+        const int leftSize = sizeOf(m_left[size_t(node)]);
+        if (rank < leftSize) {
+            node = m_left[size_t(node)];
+        } else if (rank == leftSize) {
+            return node;
+        } else {
+            rank -= leftSize + 1;
+            node = m_right[size_t(node)];
+        }
+    }
+    return -1;
+}
+
+int IncrementalSortProxy::rankOf(int sourceRow) const
+{
+    return countBefore(m_keys[size_t(sourceRow)], sourceRow);
+}
+
+int IncrementalSortProxy::countBefore(const SortKey &key, int sourceRow) const
+{
+    int count = 0;
+    int node = m_root;
+    while (node >= 0) {
+        if (less(m_keys[size_t(node)], node, key, sourceRow)) {
+            count += sizeOf(m_left[size_t(node)]) + 1;
+            node = m_right[size_t(node)];
+        } else {
+            node = m_left[size_t(node)];
+        }
+    }
+    return count;
+}
+
+void IncrementalSortProxy::split(int node, const SortKey &key, int row, int *left, int *right)
+{
+    if (node < 0) {
+        *left = *right = -1;
+        return;
+    }
+    if (less(m_keys[size_t(node)], node, key, row)) {
+        split(m_right[size_t(node)], key, row, &m_right[size_t(node)], right);
+        *left = node;
+    } else {
+        split(m_left[size_t(node)], key, row, left, &m_left[size_t(node)]);
+        *right = node;
+    }
+    update(node);
+}
+
+int IncrementalSortProxy::merge(int left, int right)
+{
+    if (left < 0) return right;
+    if (right < 0) return left;
+    if (m_priority[size_t(left)] > m_priority[size_t(right)]) {
+        m_right[size_t(left)] = merge(m_right[size_t(left)], right);
+        update(left);
+        return left;
+    }
+    m_left[size_t(right)] = merge(left, m_left[size_t(right)]);
+    update(right);
+    return right;
+}
+
+void IncrementalSortProxy::insertNode(int sourceRow)
+{
+    const size_t n = size_t(sourceRow);
+    m_left[n] = m_right[n] = -1;
+    m_size[n] = 1;
+    m_priority[n] = nextPriority();
+    int left = -1, right = -1;
+    split(m_root, m_keys[n], sourceRow, &left, &right);
+    m_root = merge(merge(left, sourceRow), right);
+}
+
+int IncrementalSortProxy::eraseFrom(int node, int sourceRow)
+{
+    // Found by its current key, so it must be erased before the key changes
+    if (node < 0)
+        return -1;
+    if (node == sourceRow)
+        return merge(m_left[size_t(node)], m_right[size_t(node)]);
+    if (less(m_keys[size_t(sourceRow)], sourceRow, m_keys[size_t(node)], node))
+        m_left[size_t(node)] = eraseFrom(m_left[size_t(node)], sourceRow);
+    else
+        m_right[size_t(node)] = eraseFrom(m_right[size_t(node)], sourceRow);
+    update(node);
+    return node;
+}
+
+int IncrementalSortProxy::fixSizes(int node)
+{
+    if (node < 0)
+        return 0;
+    m_size[size_t(node)] = 1 + fixSizes(m_left[size_t(node)]) + fixSizes(m_right[size_t(node)]);
+    return m_size[size_t(node)];
+}
+
+quint32 IncrementalSortProxy::nextPriority()
+{
+    // xorshift32: only has to look random to the treap
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+    return m_seed;
+}
+
+void IncrementalSortProxy::rebuild()
+{
+    const int n = sourceModel() ? sourceModel()->rowCount() : 0;
+    m_keys.assign(size_t(n), SortKey());
+    m_accepted.assign(size_t(n), 0);
+    m_left.assign(size_t(n), -1);
+    m_right.assign(size_t(n), -1);
+    m_size.assign(size_t(n), 1);
+    m_priority.assign(size_t(n), 0);
+    m_root = -1;
+
+    std::vector<int> order;
+    order.reserve(size_t(n));
+    for (int row = 0; row < n; ++row) {
+        if (!acceptsRow(row)) continue;
+        m_accepted[size_t(row)] = 1;
+        m_keys[size_t(row)] = keyOf(row);
+        order.push_back(row);
+    }
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return less(m_keys[size_t(a)], a, m_keys[size_t(b)], b);
+    });
+
+    // Cartesian tree of the sorted rows in one pass: the right spine is the stack
+    std::vector<int> spine;
+    for (int row : order) {
+        m_priority[size_t(row)] = nextPriority();
+        int last = -1;
+        while (!spine.empty() && m_priority[size_t(spine.back())] < m_priority[size_t(row)]) {
+            last = spine.back();
+            spine.pop_back();
+        }
+        m_left[size_t(row)] = last;
+        if (!spine.empty())
+            m_right[size_t(spine.back())] = row;
+        spine.push_back(row);
+    }
+    m_root = spine.empty() ? -1 : spine.front();
+    fixSizes(m_root);
+}
@@ -0,0 +1,153 @@
+/******************************************************************************
+ * IncrementalSortProxy.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Sort/filter proxy for the Market Watch table that keeps its order
+ *   incrementally instead of re-sorting on every dataChanged.
+ *   - Accepted source rows live in an order-statistics treap (subtree sizes),
+ *     so proxy row -> source row and source row -> proxy row are O(log n)
+ *   - A dataChanged touching the sort column re-keys only the rows it names;
+ *     a row whose rank changed is moved with one beginMoveRows/endMoveRows,
+ *     a row that kept its rank is not touched
+ *   - Rows whose filter result flips are inserted/removed one by one
+ *   - Source inserts/removes renumber the rows (node id = source row) in O(n)
+ *     and insert/remove the accepted ones at their ranks, one signal per run
+ *     of adjacent proxy rows, so selection, current index and scroll survive
+ *   - Source resets and layout changes rebuild the order (O(n log n)) behind a
+ *     reset (row moves and column changes too; the Market Watch model emits neither)
+ *   Same filter/sort calls as QSortFilterProxyModel (fixed-string filter on
+ *   one column, sort role). Numbers compare as numbers; empty cells come
+ *   before any value in ascending order.
+ *   GUI thread only.
+ ******************************************************************************/
+
+#ifndef INCREMENTALSORTPROXY_H
+#define INCREMENTALSORTPROXY_H
+
+#include <QAbstractProxyModel>
+#include <QString>
+#include <vector>
+
+/**
+ * @class IncrementalSortProxy
+ * @brief Flat table proxy with incremental re-sorting and row moves.
+ */
+class IncrementalSortProxy : public QAbstractProxyModel
+{
+    Q_OBJECT
+public:
+    explicit IncrementalSortProxy(QObject *parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    /**
+     * Orders by column (-1 = source order). Called by the view's sort indicator.
+     */
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+    int sortColumn() const { return m_sortColumn; }
+    Qt::SortOrder sortOrder() const { return m_sortOrder; }
+
+    /**
+     * Role the sort keys are read with (default Qt::DisplayRole). A dataChanged
+     * carrying DisplayRole is taken to change it as well; one carrying only the
+     * sort role also re-tests the filter.
+     */
+    void setSortRole(int role);
+
+    // Keeps rows whose filter column text contains the string (empty = all rows)
+    void setFilterKeyColumn(int column);
+    int filterKeyColumn() const { return m_filterColumn; }
+    void setFilterCaseSensitivity(Qt::CaseSensitivity cs);
+    void setFilterFixedString(const QString &pattern);
+
+    /**
+     * Rows moved since construction (repositioned after a key change).
+     */
+    quint64 rowMoves() const { return m_rowMoves; }
+
+private slots:
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+    void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceAboutToChange();   // Other structural change: announce the reset
+    void onSourceChanged();         // ... and rebuild once it is done
+
+private:
+    /**
+     * @struct SortKey
+     * @brief Sort role value of a row, reduced to something cheap to compare.
+     */
+    struct SortKey {
+        enum Kind : quint8 { Empty, Number, Text };
+        Kind kind = Empty;
+        double number = 0.0;
+        QString text;
+        bool operator==(const SortKey &o) const
+        {
+            return kind == o.kind && number == o.number && text == o.text;
+        }
+    };
+
+    SortKey keyOf(int sourceRow) const;
+    bool acceptsRow(int sourceRow) const;
+
+    // Proxy order of (key a, row a) and (key b, row b); ties keep source order
+    bool less(const SortKey &ka, int a, const SortKey &kb, int b) const;
+
+    // ---- Treap over source rows (node id = source row) ----
+    int select(int rank) const;                         // Source row at proxy row
+    int rankOf(int sourceRow) const;                    // Proxy row of an accepted source row
+    int countBefore(const SortKey &key, int sourceRow) const;   // Accepted rows ordered before (key, row)
+    void split(int node, const SortKey &key, int row, int *left, int *right);   // left < (key, row) <= right
+    int merge(int left, int right);
+    void insertNode(int sourceRow);
+    int eraseFrom(int node, int sourceRow);            // Subtree without sourceRow (found by its current key)
+    int fixSizes(int node);
+    void update(int node) { m_size[size_t(node)] = 1 + sizeOf(m_left[size_t(node)]) + sizeOf(m_right[size_t(node)]); }
+    int sizeOf(int node) const { return node < 0 ? 0 : m_size[size_t(node)]; }
+    quint32 nextPriority();
+
+    // Re-keys one accepted row; moves it (one row move signal) if its rank changed
+    void reposition(int sourceRow);
+
+    // Source rows from first on moved by delta: shifts the per-row arrays and every link (O(n))
+    void renumber(int first, int delta);
+
+    // Recomputes keys/filter of every source row and rebuilds the treap in O(n log n)
+    void rebuild();
+
+    // Filter change: rebuild behind a reset
+    void refilter();
+
+    std::vector<SortKey> m_keys;        // Source row -> current sort key
+    std::vector<quint8> m_accepted;     // Source row -> passes the filter (in the treap)
+    std::vector<int> m_left, m_right, m_size;
+    std::vector<quint32> m_priority;
+    int m_root = -1;
+    quint32 m_seed = 0x9E3779B9u;
+
+    int m_sortColumn = -1;
+    Qt::SortOrder m_sortOrder = Qt::AscendingOrder;
+    int m_sortRole = Qt::DisplayRole;
+    int m_filterColumn = 0;
+    Qt::CaseSensitivity m_filterCase = Qt::CaseSensitive;
+    QString m_filterString;
+
+    quint64 m_rowMoves = 0;
+    std::vector<int> m_changedRows;     // onSourceDataChanged scratch
+    bool m_inSourceChange = false;      // Between a source's about-to and done signals
+    QList<QMetaObject::Connection> m_sourceConnections;
+};
+
+#endif // INCREMENTALSORTPROXY_H
@@ -0,0 +1,145 @@
+/******************************************************************************
+ * InstrumentRegistry.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Implementation of the symbol interning table.
+ ******************************************************************************/
+
+#include "instrumentregistry.h"
+
+InstrumentRegistry &InstrumentRegistry::instance()
+{
+    static InstrumentRegistry registry;
+    return registry;
+}
+
+template <typename Char>
+uint InstrumentRegistry::hashOf(const Char *begin, int length)
+{
+    // FNV-1a; identical for UTF-8 and UTF-16 input (ASCII symbols)
+    uint h = 2166136261u;
+    for (int i = 0; i < length; ++i)
+        h = (h ^ uint(static_cast<char16_t>(begin[i]))) * 16777619u;
+    return h;
+}
+
+template <typename Char>
+bool InstrumentRegistry::sameSymbol(const QString &symbol, const Char *begin, int length)
+{
+    if (symbol.size() != length) return false;
+    int i = 0;
+    while (i < length && symbol.at(i).unicode() == static_cast<char16_t>(begin[i])) ++i;
+    return i == length;
+}
+
+template <typename Char>
+int InstrumentRegistry::lookup(uint hash, const Char *begin, int length) const
+{
+    for (auto it = m_idOf.constFind(hash); it != m_idOf.cend() && it.key() == hash; ++it) {
+        if (sameSymbol(m_symbols.at(it.value()), begin, length)) return it.value();
+    }
+    return -1;
+}
+
+template <typename Char>
+int InstrumentRegistry::intern(const Char *begin, int length)
+{
+    const uint hash = hashOf(begin, length);
+    {
+        QReadLocker read(&m_lock);
+        const int id = lookup(hash, begin, length);
+        if (id >= 0) return id;
+    }
+
+    QString symbol(length, Qt::Uninitialized);
+    for (int i = 0; i < length; ++i)
+        symbol[i] = QChar(static_cast<char16_t>(begin[i]));
+
+    QWriteLocker write(&m_lock);
+    int id = lookup(hash, begin, length);   // Another thread may have won the race
+    if (id < 0) {
+        id = m_symbols.size();
+        m_symbols.append(symbol);
+        m_idOf.insert(hash, id);
+    }
+    return id;
+}
+
+int InstrumentRegistry::intern(const QString &symbol)
+{
+    return intern(reinterpret_cast<const char16_t *>(symbol.utf16()), symbol.size());
+}
+
+template <typename Char>
+int InstrumentRegistry::find(const Char *begin, int length) const
+{
+    QReadLocker read(&m_lock);
+    return lookup(hashOf(begin, length), begin, length);
+}
+
+int InstrumentRegistry::find(const QString &symbol) const
+{
+    return find(reinterpret_cast<const char16_t *>(symbol.utf16()), symbol.size());
+}
+
+QString InstrumentRegistry::symbol(int id) const
+{
+    QReadLocker read(&m_lock);
+    return id >= 0 && id < m_symbols.size() ? m_symbols.at(id) : QString();
+}
+
+int InstrumentRegistry::count() const
+{
+    QReadLocker read(&m_lock);
+    return m_symbols.size();
+}
+
+template <typename Char>
+int InstrumentRegistry::Cache::intern(const Char *begin, int length)
+{
+    const uint hash = hashOf(begin, length);
+    for (auto it = m_idOf.constFind(hash); it != m_idOf.cend() && it.key() == hash; ++it) {
+        if (sameSymbol(it->symbol, begin, length)) return it->id;
+    }
+
+    // First sight on this thread: one trip through the shared, locked table
+    InstrumentRegistry &registry = InstrumentRegistry::instance();
+    const int id = registry.intern(begin, length);
+    m_idOf.insert(hash, Entry{registry.symbol(id), id});
+    return id;
+}
+
+int InstrumentRegistry::Cache::intern(const QString &symbol)
+{
+    return intern(reinterpret_cast<const char16_t *>(symbol.utf16()), symbol.size());
+}
+
+void InstrumentRegistry::setPrecision(int id, int priceDecimals, int sizeDecimals)
+{
+    QWriteLocker write(&m_lock);
+    if (id < 0 || id >= m_symbols.size()) return;
+    if (id >= m_priceDecimals.size()) {
+        m_priceDecimals.resize(m_symbols.size(), -1);
+        m_sizeDecimals.resize(m_symbols.size(), -1);
+    }
+    m_priceDecimals[id] = qint8(priceDecimals);
+    m_sizeDecimals[id] = qint8(sizeDecimals);
+}
+
+bool InstrumentRegistry::precision(int id, int *priceDecimals, int *sizeDecimals) const
+{
+    QReadLocker read(&m_lock);
+    if (id < 0 || id >= m_priceDecimals.size() || m_priceDecimals.at(id) < 0) return false;
+    *priceDecimals = m_priceDecimals.at(id);
+    *sizeDecimals = m_sizeDecimals.at(id);
+    return true;
+}
+
+template int InstrumentRegistry::intern<char>(const char *, int);
+template int InstrumentRegistry::intern<char16_t>(const char16_t *, int);
+template int InstrumentRegistry::find<char>(const char *, int) const;
+template int InstrumentRegistry::find<char16_t>(const char16_t *, int) const;
+template int InstrumentRegistry::Cache::intern<char>(const char *, int);
+template int InstrumentRegistry::Cache::intern<char16_t>(const char16_t *, int);
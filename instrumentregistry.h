@@ -0,0 +1,124 @@
+/******************************************************************************
+ * InstrumentRegistry.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Process-wide interning of instrument symbols ("BTC-USDT") into dense
+ *   integer ids (0, 1, 2, ...).
+ *   - The parser interns the instId once per record, straight from the frame
+ *     text; everything downstream carries the int
+ *   - Each feed shard resolves through its own Cache, so only symbols the
+ *     shard has never seen take the registry lock
+ *   - Per-instrument state (conflation, tapes, candles, books) is a plain
+ *     array indexed by id
+ *   - Ids are never reused, so an id stays valid for the whole process;
+ *     the symbol string is only looked up for display and REST/WS requests
+ *   - Display precision from /public/instruments (tickSz/lotSz) is kept
+ *     per id once the metadata has been fetched
+ ******************************************************************************/
+
+#ifndef INSTRUMENTREGISTRY_H
+#define INSTRUMENTREGISTRY_H
+
+#include <QString>
+#include <QVector>
+#include <QMultiHash>
+#include <QReadWriteLock>
+
+/**
+ * @class InstrumentRegistry
+ * @brief Symbol <-> id table, safe to use from the network and GUI threads.
+ */
+class InstrumentRegistry
+{
+public:
+    static InstrumentRegistry &instance();
+
+    /**
+     * Id of a symbol, assigning the next free id on first sight.
+     */
+    int intern(const QString &symbol);
+
+    /**
+     * Same as intern(QString) on raw frame text (UTF-8 or UTF-16); no
+     * allocation once the symbol is known.
+     */
+    template <typename Char>
+    int intern(const Char *begin, int length);
+
+    /**
+     * Id of a symbol, -1 if it was never interned.
+     */
+    int find(const QString &symbol) const;
+    template <typename Char>
+    int find(const Char *begin, int length) const;
+
+    /**
+     * Symbol of an id (empty for an unknown id).
+     */
+    QString symbol(int id) const;
+
+    /**
+     * Number of ids handed out; every valid id is below this.
+     */
+    int count() const;
+
+    /**
+     * @class Cache
+     * @brief Lock-free front of the registry for a single thread (one per feed shard).
+     *
+     * Known symbols resolve from a private table; a miss goes through
+     * InstrumentRegistry::intern once and is remembered.
+     */
+    class Cache
+    {
+    public:
+        int intern(const QString &symbol);
+        template <typename Char>
+        int intern(const Char *begin, int length);
+
+        int size() const { return m_idOf.size(); }
+
+    private:
+        struct Entry {
+            QString symbol;
+            int id;
+        };
+        QMultiHash<uint, Entry> m_idOf;   // FNV-1a of the symbol -> entry
+    };
+
+    /**
+     * Native display precision of an instrument (fraction digits of tickSz / lotSz).
+     */
+    void setPrecision(int id, int priceDecimals, int sizeDecimals);
+
+    /**
+     * Precision set by setPrecision(); false (outputs untouched) if unknown.
+     */
+    bool precision(int id, int *priceDecimals, int *sizeDecimals) const;
+
+private:
+    InstrumentRegistry() = default;
+    InstrumentRegistry(const InstrumentRegistry &) = delete;
+    InstrumentRegistry &operator=(const InstrumentRegistry &) = delete;
+
+    template <typename Char>
+    static uint hashOf(const Char *begin, int length);
+
+    template <typename Char>
+    static bool sameSymbol(const QString &symbol, const Char *begin, int length);
+
+    // Caller holds m_lock
+    template <typename Char>
+    int lookup(uint hash, const Char *begin, int length) const;
+
+    mutable QReadWriteLock m_lock;
+    QMultiHash<uint, int> m_idOf;   // FNV-1a of the symbol -> id
+    QVector<QString> m_symbols;     // id -> symbol
+    QVector<qint8> m_priceDecimals; // id -> tickSz digits, -1 = unknown
+    QVector<qint8> m_sizeDecimals;  // id -> lotSz digits, -1 = unknown
+};
+
+#endif // INSTRUMENTREGISTRY_H
@@ -0,0 +1,108 @@
+/******************************************************************************
+ * LatencyHistogram.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Fixed-memory log-linear histogram for latencies (HDR-style).
+ *   - Values below 2^SubBucketBits are counted exactly; above that every
+ *     power of two is split into 2^(SubBucketBits-1) equal buckets, so the
+ *     relative error stays below 2^-(SubBucketBits-1) at any magnitude
+ *   - record() is an index computation and one increment: no allocation,
+ *     no sorting, no floating-point
+ *   - Range is 0 .. 2^36 units (about 19 h in microseconds); larger values
+ *     land in the last bucket
+ ******************************************************************************/
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+#pragma once
+
+#include <QtGlobal>
+#include <QtAlgorithms>
+#include <array>
+#include <cmath>
+
+/**
+ * @class LatencyHistogram
+ * @brief Counts per log-linear bucket; percentiles are read back by a bucket walk.
+ *
+ * SubBucketBits = 7 gives 1984 buckets (~8 KB) and < 1.6% error;
+ * SubBucketBits = 4 gives 272 buckets (~1 KB) and < 12.5% error.
+ */
+template <int SubBucketBits>
+class LatencyHistogram
+{
+public:
+    static const int SUB_BUCKETS = 1 << SubBucketBits;
+    static const int HALF = SUB_BUCKETS / 2;
+    static const int MAX_MSB = 35;
+    static const int BUCKETS = SUB_BUCKETS + (MAX_MSB - (SubBucketBits - 1)) * HALF;
+
+    void record(qint64 value)
+    {
+        if (value < 0) value = 0;
+        ++m_counts[indexOf(quint64(value))];
+        ++m_total;
+        m_sum += quint64(value);
+        if (value > m_max) m_max = value;
+    }
+
+    void reset()
+    {
+        m_counts.fill(0);
+        m_total = 0;
+        m_sum = 0;
+        m_max = 0;
+    }
+
+    quint64 count() const { return m_total; }
+    qint64 max() const { return m_max; }
+    double mean() const { return m_total ? double(m_sum) / double(m_total) : 0.0; }
+
+    /**
+     * Smallest bucket bound that at least percentile % of the samples are at or below.
+     * @param percentile 0..100 (e.g. 99.9)
+     */
+    qint64 valueAt(double percentile) const
+    {
+        if (m_total == 0) return 0;
+        const quint64 target = qMax<quint64>(1, quint64(std::ceil(percentile / 100.0 * double(m_total))));
+        quint64 seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += m_counts[i];
+            if (seen >= target) return qMin(highestIn(i), m_max);
+        }
+        return m_max;
+    }
+
+private:
+    static int indexOf(quint64 v)
+    {
+        if (v < quint64(SUB_BUCKETS)) return int(v);
+        int msb = 63 - qCountLeadingZeroBits(v);
+        if (msb > MAX_MSB) {
+            msb = MAX_MSB;
+            v = (quint64(1) << (MAX_MSB + 1)) - 1;
+        }
+        const int shift = msb - (SubBucketBits - 1);   // v >> shift is in [HALF, SUB_BUCKETS)
+        return SUB_BUCKETS + (shift - 1) * HALF + int(v >> shift) - HALF;
+    }
+
+    static qint64 highestIn(int index)
+    {
+        if (index < SUB_BUCKETS) return index;
+        const int k = index - SUB_BUCKETS;
+        const int shift = k / HALF + 1;
+        const qint64 sub = k % HALF + HALF;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::array<quint32, BUCKETS> m_counts{};
+    quint64 m_total = 0;
+    quint64 m_sum = 0;
+    qint64 m_max = 0;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,165 @@
+/******************************************************************************
+ * LatencyRecorder.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Implementation of the ticker latency histograms.
+ ******************************************************************************/
+
+#include "latencyrecorder.h"
+#include "version.h"
+#include <QDebug>
+#include <chrono>
+
+// Rows announced but not repainted are kept this long, and at most this many
+static const qint64 MAX_PENDING_AGE_NS = 5LL * 1000 * 1000 * 1000;
+static const int MAX_PENDING = 8192;
+
+static const char *const STAGE_NAMES[LatencyRecorder::STAGE_COUNT] = {
+    "Network", "Parse", "Queue", "Model", "Paint", "EndToEnd"
+};
+
+// Both clocks read once, together: wallUs() maps the monotonic clock onto the wall clock
+struct ClockBase {
+    std::chrono::steady_clock::time_point steady = std::chrono::steady_clock::now();
+    qint64 wallUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::system_clock::now().time_since_epoch()).count();
+};
+
+static const ClockBase &clockBase()
+{
+    static const ClockBase base;
+    return base;
+}
+
+LatencyRecorder &LatencyRecorder::instance()
+{
+    static LatencyRecorder recorder;
+    return recorder;
+}
+
+qint64 LatencyRecorder::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - clockBase().steady).count();
+}
+
+qint64 LatencyRecorder::wallUs(qint64 ns)
+{
+    return clockBase().wallUs + ns / 1000;
+}
+
+QString LatencyRecorder::stageName(int stage)
+{
+    return (stage >= 0 && stage < STAGE_COUNT) ? QString::fromLatin1(STAGE_NAMES[stage]) : QString();
+}
+
+void LatencyRecorder::setClockOffset(qint64 offsetMs, qint64 rttMs)
+{
+    m_offsetMs.store(offsetMs, std::memory_order_relaxed);
+    m_rttMs.store(rttMs, std::memory_order_relaxed);
+}
+
+void LatencyRecorder::record(int instrument, Stage s, qint64 us)
+{
+    m_stages[s].record(us);
+    if (instrument < 0) return;
+    if (instrument >= int(m_perInstrument.size()))
+        m_perInstrument.resize(instrument + 1);
+    std::unique_ptr<InstrumentHistograms> &h = m_perInstrument[instrument];
+    if (!h) h.reset(new InstrumentHistograms());
+    (*h)[s].record(us);
+}
+
+void LatencyRecorder::onTickApplied(const CryptoCV::OkxTicker &tick, int row, qint64 appliedNs, qint64 emittedNs)
+{
+    if (tick.recvNs <= 0) return;   // REST snapshot: no receive stamp
+
+    if (tick.networkUs >= 0)
+        record(tick.instrument, Network, tick.networkUs);
+    record(tick.instrument, Parse, (tick.parsedNs - tick.recvNs) / 1000);
+    record(tick.instrument, Queue, (appliedNs - tick.parsedNs) / 1000);
+    record(tick.instrument, Model, (emittedNs - appliedNs) / 1000);
+
+    if (m_pending.size() >= MAX_PENDING) {
+        ++m_droppedPaints;   // Nothing is being painted (window hidden?)
+        return;
+    }
+    m_pending.append(PendingPaint{tick.instrument, row, tick.recvNs, emittedNs, tick.networkUs});
+}
+
+void LatencyRecorder::onPainted(qint64 paintedNs, const std::function<PaintState(int)> &rowState)
+{
+    int kept = 0;
+    for (int i = 0; i < m_pending.size(); ++i) {
+        const PendingPaint &p = m_pending.at(i);
+        const PaintState state = rowState(p.row);
+        if (state == PaintState::Painted) {
+            record(p.instrument, Paint, (paintedNs - p.emittedNs) / 1000);
+            if (p.networkUs >= 0)
+                record(p.instrument, EndToEnd, p.networkUs + (paintedNs - p.recvNs) / 1000);
+        } else if (state == PaintState::Pending && paintedNs - p.emittedNs < MAX_PENDING_AGE_NS) {
+            m_pending[kept++] = p;   // On screen, outside this paint's area
+        } else if (state == PaintState::Pending) {
+            ++m_droppedPaints;
+        }
+        // Hidden: scrolled away or filtered out, it will not be painted for this tick
+    }
+    m_pending.resize(kept);
+
+#ifdef __DEBUGMODE__
+    if (paintedNs - m_lastReportNs > 10LL * 1000 * 1000 * 1000) {
+        m_lastReportNs = paintedNs;
+        qDebug().noquote() << report();
+    }
+#endif
+}
+
+template <typename Histogram>
+LatencyRecorder::Summary LatencyRecorder::summarize(const Histogram &h)
+{
+    Summary s;
+    s.count = h.count();
+    s.p50 = h.valueAt(50.0);
+    s.p90 = h.valueAt(90.0);
+    s.p99 = h.valueAt(99.0);
+    s.p999 = h.valueAt(99.9);
+    s.max = h.max();
+    s.mean = h.mean();
+    return s;
+}
+
+LatencyRecorder::Summary LatencyRecorder::stage(Stage s) const
+{
+    return summarize(m_stages[s]);
+}
+
+LatencyRecorder::Summary LatencyRecorder::instrument(int instrument, Stage s) const
+{
+    if (instrument < 0 || instrument >= int(m_perInstrument.size()) || !m_perInstrument[instrument])
+        return Summary();
+    return summarize((*m_perInstrument[instrument])[s]);
+}
+
+QString LatencyRecorder::report() const
+{
+    QString out = QString("Latency (us), clock offset %1 ms (rtt %2 ms):")
+                      .arg(clockOffsetMs()).arg(clockRttMs());
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        const Summary s = stage(Stage(i));
+        out += QString("\n  %1 n=%2 p50=%3 p90=%4 p99=%5 p99.9=%6 max=%7")
+                   .arg(stageName(i), -9).arg(s.count).arg(s.p50).arg(s.p90)
+                   .arg(s.p99).arg(s.p999).arg(s.max);
+    }
+    return out;
+}
+
+void LatencyRecorder::reset()
+{
+    for (StageHistogram &h : m_stages)
+        h.reset();
+    m_perInstrument.clear();
+    m_pending.clear();
+    m_droppedPaints = 0;
+}
@@ -0,0 +1,137 @@
+/******************************************************************************
+ * LatencyRecorder.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   End-to-end latency of ticker updates, from exchange timestamp to painted
+ *   Market Watch cell, split into stages:
+ *     Network   exchange ts -> frame received (corrected by the clock offset)
+ *     Parse     frame received -> ticker parsed
+ *     Queue     parsed -> applied to the model (queue + conflation wait)
+ *     Model     applied -> dataChanged returned (frame flush wait + the proxy's work)
+ *     Paint     dataChanged -> row repainted by the view
+ *     EndToEnd  exchange ts -> row repainted
+ *   - One fine LatencyHistogram per stage and one coarse set per instrument,
+ *     in microseconds, fixed memory once an instrument has been seen
+ *   - Only ticks that change a row are measured: those are the ones painted
+ *   - The exchange clock offset comes from WebSocketConnection's periodic
+ *     /public/time round-trips (minimum-RTT sample)
+ *   GUI thread only, except the clock offset setters/getters.
+ ******************************************************************************/
+
+#ifndef LATENCYRECORDER_H
+#define LATENCYRECORDER_H
+
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "latencyhistogram.h"
+#include "protocol.h"
+
+/**
+ * @class LatencyRecorder
+ * @brief Per-stage and per-instrument latency histograms of the ticker path.
+ */
+class LatencyRecorder
+{
+public:
+    enum Stage { Network = 0, Parse, Queue, Model, Paint, EndToEnd, STAGE_COUNT };
+
+    /**
+     * @enum PaintState
+     * @brief Where a row stands after a paint event (answered by the view).
+     */
+    enum class PaintState { Painted, Pending, Hidden };
+
+    /**
+     * @struct Summary
+     * @brief Percentiles of one histogram, in microseconds.
+     */
+    struct Summary {
+        quint64 count = 0;
+        qint64 p50 = 0, p90 = 0, p99 = 0, p999 = 0, max = 0;
+        double mean = 0.0;
+    };
+
+    static LatencyRecorder &instance();
+
+    /**
+     * Monotonic clock shared by all threads (ns since process start).
+     */
+    static qint64 nowNs();
+
+    /**
+     * Wall clock (us since epoch) at a nowNs() reading.
+     */
+    static qint64 wallUs(qint64 ns);
+
+    static QString stageName(int stage);
+
+    // ---- Exchange clock (any thread) ----
+    void setClockOffset(qint64 offsetMs, qint64 rttMs);
+    qint64 clockOffsetMs() const { return m_offsetMs.load(std::memory_order_relaxed); }
+    qint64 clockRttMs() const { return m_rttMs.load(std::memory_order_relaxed); }
+
+    // ---- Recording (GUI thread) ----
+
+    /**
+     * A stream tick changed a model row and dataChanged has returned.
+     * @param row Source row announced in dataChanged
+     */
+    void onTickApplied(const CryptoCV::OkxTicker &tick, int row, qint64 appliedNs, qint64 emittedNs);
+
+    bool hasPendingPaints() const { return !m_pending.isEmpty(); }
+
+    /**
+     * Called by the view after each paint; rowState tells whether a source row
+     * was repainted, is visible but outside the repainted area, or is not on screen.
+     */
+    void onPainted(qint64 paintedNs, const std::function<PaintState(int sourceRow)> &rowState);
+
+    // ---- Read-out ----
+    Summary stage(Stage s) const;
+    Summary instrument(int instrument, Stage s) const;
+    int instrumentCount() const { return int(m_perInstrument.size()); }
+    quint64 droppedPaints() const { return m_droppedPaints; }
+
+    /**
+     * One line per stage plus the clock offset, for logs.
+     */
+    QString report() const;
+    void reset();
+
+private:
+    LatencyRecorder() = default;
+
+    using StageHistogram = LatencyHistogram<7>;
+    using InstrumentHistograms = std::array<LatencyHistogram<4>, STAGE_COUNT>;
+
+    struct PendingPaint {
+        int instrument;
+        int row;
+        qint64 recvNs;
+        qint64 emittedNs;
+        qint32 networkUs;       // -1 = unknown (replay)
+    };
+
+    void record(int instrument, Stage s, qint64 us);
+
+    template <typename Histogram>
+    static Summary summarize(const Histogram &h);
+
+    std::array<StageHistogram, STAGE_COUNT> m_stages;
+    std::vector<std::unique_ptr<InstrumentHistograms>> m_perInstrument;   // Indexed by id, null until seen
+    QVector<PendingPaint> m_pending;          // Announced rows not yet repainted
+    quint64 m_droppedPaints = 0;              // Pending entries given up (window full / too old)
+    qint64 m_lastReportNs = 0;
+
+    std::atomic<qint64> m_offsetMs{0};        // Exchange clock - local clock
+    std::atomic<qint64> m_rttMs{-1};          // RTT of the offset sample, -1 = not synced
+};
+
+#endif // LATENCYRECORDER_H
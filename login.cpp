@@ -74,7 +74,7 @@ void Login::on_buttonBox_accepted()
         qDebug() << "Credentials saved: username =" << username;
 
         // Create WebSocket connection
-        WEB_SOCKET_CONNECTION = new WebSocketConnection();
+        WEB_SOCKET_CONNECTION = new WebSocketConnection(QUrl(ConfigManager::instance().getWsUrl()));
         qDebug() << "Connecting via WebSocket...";
         WEB_SOCKET_CONNECTION->connectToServer();
 
@@ -10,6 +10,8 @@
 */
 
 #include "mainwindow.h"
+#include "metricsserver.h"
+#include "configmanager.h"
 #include <QApplication>
 #include <QTimer>
 
@@ -20,6 +22,11 @@ mainWindow::mainWindow(QWidget *parent)
     loginPage = new Login(this);
     marketWatchDockWindowPtr = new marketWatchDockWindow(this);
     addDockWidget(Qt::LeftDockWidgetArea, marketWatchDockWindowPtr);
+
+    // Localhost Prometheus endpoint (Metrics/port, 0 = off)
+    const int metricsPort = ConfigManager::instance().getMetricsPort();
+    if (metricsPort > 0)
+        new MetricsServer(marketWatchDockWindowPtr, quint16(metricsPort), this);
 }
 
 void mainWindow::connectLogin()
@@ -16,12 +16,17 @@
 #include "configmanager.h"
 #include "websocketconnection.h"
 #include "orderbookwindow.h"
+#include "timeandsaleswindow.h"
+#include "latencyrecorder.h"
 #include "globals.h"
 #include <QDebug>
+#include <QPaintEvent>
+#include <QAbstractProxyModel>
 #include <QMessageBox>
 #include <QSettings>
 #include <QHeaderView>
 #include <QShortcut>
+#include <QScrollBar>
 #include <QMenu>
 #include <QTimer>
 
@@ -43,6 +48,30 @@ MarketWatchDataTable::MarketWatchDataTable(QWidget *parent)
     // Ctrl+H shortcut for columns menu
     QShortcut *shortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_H), this);
     connect(shortcut, &QShortcut::activated, this, &MarketWatchDataTable::showHideColumnsMenuShortcut);
+
+    // Whole rows, Ctrl/Shift multi-select; Delete removes the selection
+    setSelectionBehavior(QAbstractItemView::SelectRows);
+    setSelectionMode(QAbstractItemView::ExtendedSelection);
+    QShortcut *deleteShortcut = new QShortcut(QKeySequence::Delete, this);
+    deleteShortcut->setContext(Qt::WidgetShortcut);
+    connect(deleteShortcut, &QShortcut::activated, this, [this]() {
+        if (!m_rowsDeletable) return;
+        const QList<int> rows = selectedRowList();
+        if (!rows.isEmpty())
+            emit deleteRowsRequested(rows);
+    });
+}
+
+QList<int> MarketWatchDataTable::selectedRowList() const
+{
+    QList<int> rows;
+    if (!selectionModel())
+        return rows;
+    const QModelIndexList selected = selectionModel()->selectedRows();
+    rows.reserve(selected.size());
+    for (const QModelIndex &index : selected)
+        rows << index.row();
+    return rows;
 }
 
 void MarketWatchDataTable::showHideColumnsMenuShortcut()
@@ -92,14 +121,56 @@ void MarketWatchDataTable::contextMenuEvent(QContextMenuEvent *event)
                                  QString("Row %1, Column %2\nValue: %3").arg(row).arg(col).arg(data.toString()));
     });
 
-    QAction *deleteAction = menu.addAction("Delete Row");
-    connect(deleteAction, &QAction::triggered, this, [this, row]() {
-        emit deleteRowRequested(row);
+    QAction *tapeAction = menu.addAction("Time && Sales");
+    connect(tapeAction, &QAction::triggered, this, [this, row]() {
+        emit timeAndSalesRequested(row);
+    });
+
+    if (!m_rowsDeletable) {
+        menu.exec(event->globalPos());
+        return;
+    }
+
+    // Right-clicking outside the selection acts on the clicked row only
+    QList<int> rows = selectedRowList();
+    if (!rows.contains(row))
+        rows = QList<int>() << row;
+    QAction *deleteAction = menu.addAction(rows.size() > 1 ? QString("Delete %1 Rows").arg(rows.size())
+                                                           : QString("Delete Row"));
+    connect(deleteAction, &QAction::triggered, this, [this, rows]() {
+        emit deleteRowsRequested(rows);
     });
 
     menu.exec(event->globalPos());
 }
 
+void MarketWatchDataTable::paintEvent(QPaintEvent *event)
+{
+    QTableView::paintEvent(event);
+
+    LatencyRecorder &latency = LatencyRecorder::instance();
+    if (!latency.hasPendingPaints()) return;
+
+    // Rows announced by dataChanged count as painted once their rect was redrawn
+    const QAbstractProxyModel *proxyModel = qobject_cast<const QAbstractProxyModel*>(model());
+    const QRect painted = event->rect();
+    const int viewportHeight = viewport()->height();
+    latency.onPainted(LatencyRecorder::nowNs(), [&](int sourceRow) {
+        const QModelIndex index = proxyModel
+            ? proxyModel->mapFromSource(proxyModel->sourceModel()->index(sourceRow, 0))
+            : model()->index(sourceRow, 0);
+        if (!index.isValid() || isRowHidden(index.row()))
+            return LatencyRecorder::PaintState::Hidden;   // Filtered out
+        const int y = rowViewportPosition(index.row());
+        const int h = rowHeight(index.row());
+        if (y + h <= 0 || y >= viewportHeight)
+            return LatencyRecorder::PaintState::Hidden;   // Scrolled away
+        return (y < painted.bottom() + 1 && y + h > painted.top())
+            ? LatencyRecorder::PaintState::Painted
+            : LatencyRecorder::PaintState::Pending;
+    });
+}
+
 /*---------------------------------------------------------------------------
  * marketWatchDockWindow implementation
  *--------------------------------------------------------------------------*/
@@ -132,10 +203,14 @@ marketWatchDockWindow::marketWatchDockWindow(QWidget *parent)
         "QPushButton { background-color: #0078d4; color: white; border: none; padding: 5px 15px; border-radius: 3px; }"
         );
     addButton->setMaximumWidth(60);
+    allCheck = new QCheckBox("All instruments", headerWidget);
+    allCheck->setStyleSheet("color: white; font-size: 12px;");
+    allCheck->setToolTip("Every " + ConfigManager::instance().getAllInstrumentTypes().join('/') + " instrument");
 
     selectionLayout->addWidget(symbolLabel);
     selectionLayout->addWidget(symbolCombo, 1);
     selectionLayout->addWidget(addButton);
+    selectionLayout->addWidget(allCheck);
     mainLayout->addLayout(selectionLayout);
 
     headerWidget->setLayout(mainLayout);
@@ -143,7 +218,12 @@ marketWatchDockWindow::marketWatchDockWindow(QWidget *parent)
 
     //-- Main table/model setup --
     model = new MarketWatchModel(this);
-    proxy = new QSortFilterProxyModel(this);
+    model->setFlash(ConfigManager::instance().getFlashMs(), ConfigManager::instance().getFlashFade());
+    conflator = new TickConflator(ConfigManager::instance().getConflationIntervalMs(), this);
+    connect(conflator, &TickConflator::batchReady, model, &MarketWatchModel::onTickBatch);
+    tradeTapes = new TradeTapeStore(ConfigManager::instance().getTapeCapacity(), this);
+    proxy = new IncrementalSortProxy(this);
+    proxy->setSortRole(MarketWatchModel::SortRole);
     proxy->setSourceModel(model);
     table = new MarketWatchDataTable(this);
     table->setModel(proxy);
@@ -193,13 +273,43 @@ marketWatchDockWindow::marketWatchDockWindow(QWidget *parent)
             this, &marketWatchDockWindow::onTableDoubleClicked);
 
     connect(table, &MarketWatchDataTable::columnhideSignal, this, &marketWatchDockWindow::saveColumnVisibilityToIni);
-    connect(table, &MarketWatchDataTable::deleteRowRequested, this, [this](int proxyRow) {
-        QModelIndex proxyIndex = proxy->index(proxyRow, 0);
-        QModelIndex sourceIndex = proxy->mapToSource(proxyIndex);
+    connect(table, &MarketWatchDataTable::deleteRowsRequested, this, [this](const QList<int> &proxyRows) {
+        QList<int> sourceRows;
+        sourceRows.reserve(proxyRows.size());
+        for (int proxyRow : proxyRows) {
+            QModelIndex sourceIndex = proxy->mapToSource(proxy->index(proxyRow, 0));
+            if (sourceIndex.isValid())
+                sourceRows << sourceIndex.row();
+        }
+        deleteRowsByIndex(sourceRows);
+    });
+    connect(table, &MarketWatchDataTable::timeAndSalesRequested, this, [this](int proxyRow) {
+        QModelIndex sourceIndex = proxy->mapToSource(proxy->index(proxyRow, 0));
         if (sourceIndex.isValid())
-            deleteRowByIndex(sourceIndex.row());
+            openTimeAndSales(sourceIndex.row());
     });
 
+    //--- All instruments mode: the visible proxy rows follow scrolling, resizing and re-sorting
+    viewportTimer = new QTimer(this);
+    viewportTimer->setSingleShot(true);
+    viewportTimer->setInterval(0);
+    connect(viewportTimer, &QTimer::timeout, this, &marketWatchDockWindow::updateViewport);
+    auto scheduleViewport = [this]() { if (allModel) viewportTimer->start(); };
+    connect(table->verticalScrollBar(), &QScrollBar::valueChanged, this, scheduleViewport);
+    connect(table->verticalScrollBar(), &QScrollBar::rangeChanged, this, scheduleViewport);
+    connect(proxy, &QAbstractItemModel::layoutChanged, this, scheduleViewport);
+    connect(proxy, &QAbstractItemModel::rowsInserted, this, scheduleViewport);
+    connect(proxy, &QAbstractItemModel::rowsRemoved, this, scheduleViewport);
+    connect(proxy, &QAbstractItemModel::rowsMoved, this, scheduleViewport);
+    connect(proxy, &QAbstractItemModel::modelReset, this, scheduleViewport);
+    // Off-screen rows of that model only report changes to the sorted/filtered columns
+    auto syncKeyColumns = [this]() {
+        if (allModel) allModel->setKeyColumns(proxy->sortColumn(), proxy->filterKeyColumn());
+    };
+    connect(proxy, &QAbstractItemModel::layoutChanged, this, syncKeyColumns);
+    connect(proxy, &QAbstractItemModel::modelReset, this, syncKeyColumns);
+    connect(allCheck, &QCheckBox::toggled, this, &marketWatchDockWindow::setAllInstrumentsMode);
+
     //--- Persistent config
     loadColumnVisibilityFromIni();
 }
@@ -211,21 +321,37 @@ void marketWatchDockWindow::onTableDoubleClickedResponse(QJsonObject data)
 {
     OrderBookLevel5 book = OrderBookLevel5::fromJson(data);
     OrderBookWindow *dlg = new OrderBookWindow(book, this, OrderBookReqSymbol);
+
+    // Stream the book while the dialog is open; the REST snapshot covers the first paint
+    extern WebSocketConnection* WEB_SOCKET_CONNECTION;
+    const QString symbol = OrderBookReqSymbol;
+    connect(WEB_SOCKET_CONNECTION, &WebSocketConnection::orderBookUpdated, dlg, &OrderBookWindow::onDepthUpdated);
+    WEB_SOCKET_CONNECTION->subscribeOrderBook(symbol);
     dlg->exec();
+    WEB_SOCKET_CONNECTION->unsubscribeOrderBook(symbol);
+    dlg->deleteLater();
 }
 
 void marketWatchDockWindow::onTableDoubleClicked(const QModelIndex &index)
 {
     QModelIndex sourceIndex = proxy->mapToSource(index);
-    int uid = model->data(model->index(sourceIndex.row(), CryptoCV::MarketWatchColumn::MarketWatch_UID), Qt::DisplayRole).toInt();
+    const MarketWatchModel *shown = shownModel();
+    int uid = shown->data(shown->index(sourceIndex.row(), CryptoCV::MarketWatchColumn::MarketWatch_UID), Qt::DisplayRole).toInt();
     extern WebSocketConnection* WEB_SOCKET_CONNECTION;
     int modelIdx = sourceIndex.row();
-    auto it = model->rows.begin();
-    std::advance(it, modelIdx);
-    OrderBookReqSymbol = it->second.symbol;
+    if (modelIdx < 0 || modelIdx >= shown->rows.size()) return;
+    OrderBookReqSymbol = shown->rows.at(modelIdx).symbol;
     WEB_SOCKET_CONNECTION->makeApiRequest(CryptoCV::ApiRequestType::OrderBookSnapshot, OrderBookReqSymbol, 5);
 }
 
+void marketWatchDockWindow::openTimeAndSales(int sourceRow)
+{
+    const MarketWatchModel *shown = shownModel();
+    if (sourceRow < 0 || sourceRow >= shown->rows.size()) return;
+    TimeAndSalesWindow *dlg = new TimeAndSalesWindow(tradeTapes, shown->rows.at(sourceRow).symbol, this);
+    dlg->show();
+}
+
 void marketWatchDockWindow::onSymbolSelected(const QString &symbol)
 {
     qDebug() << "Symbol selected:" << symbol;
@@ -238,12 +364,7 @@ void marketWatchDockWindow::onAddButtonClicked()
     qDebug() << "Adding symbol to table:" << symbol;
 
     CryptoCV::MarketWatchRowData row;
-    row.symbol = symbol;
-    row.lastPrice = 0;
-    row.bidPrice = 0;
-    row.askPrice = 0;
-    row.bidQty = 0;
-    row.askQty = 0;
+    row.symbol = symbol;   // Prices stay empty until the first tick
     model->addRow(row);
     saveCryptoRowsToIni();
 }
@@ -280,8 +401,8 @@ void marketWatchDockWindow::saveCryptoRowsToIni()
     settings.beginGroup("MarketWatch/CryptoRows");
     settings.remove("");
     QStringList symbolList;
-    for (const auto& kv : model->rows) {
-        symbolList << kv.second.symbol;
+    for (const auto& row : std::as_const(model->rows)) {
+        symbolList << row.symbol;
     }
     settings.setValue("symbols", symbolList);
     settings.endGroup();
@@ -296,32 +417,118 @@ void marketWatchDockWindow::loadCryptoRowsFromIni()
     settings.endGroup();
     if (symbolList.isEmpty())
         return;
-    int *rowIdx = new int(0);
-    QTimer *timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, [this, symbolList, rowIdx, timer]() mutable {
-        if (*rowIdx < symbolList.size()) {
-            const QString& symbol = symbolList[*rowIdx];
-            CryptoCV::MarketWatchRowData row;
-            row.symbol = symbol;
-            row.lastPrice = 0;
-            row.bidPrice = 0;
-            row.askPrice = 0;
-            row.bidQty = 0;
-            row.askQty = 0;
-            model->addRow(row);
-            (*rowIdx)++;
-        } else {
-            timer->stop();
-            timer->deleteLater();
-            delete rowIdx;
-        }
-    });
-    timer->start(100);
+
+    // Restore the whole watchlist in one pass: single model insert, single bulk subscribe
+    QVector<CryptoCV::MarketWatchRowData> restoredRows;
+    restoredRows.reserve(symbolList.size());
+    for (const QString &symbol : std::as_const(symbolList)) {
+        CryptoCV::MarketWatchRowData row;
+        row.symbol = symbol;   // Prices stay empty until the first tick
+        restoredRows.append(row);
+    }
+    model->addRows(restoredRows);
 }
 
 //------------------ Delete Row Logic ------------------
-void marketWatchDockWindow::deleteRowByIndex(int sourceRow)
+void marketWatchDockWindow::deleteRowsByIndex(const QList<int> &sourceRows)
 {
-    model->removeRowAt(sourceRow); // Use the model's method from earlier
-    saveCryptoRowsToIni();
+    if (sourceRows.isEmpty() || shownModel() != model)
+        return;
+    model->removeRowsAt(sourceRows);   // One notification per contiguous range
+    saveCryptoRowsToIni();             // Once for the whole selection
+}
+
+//------------------ All Instruments Mode ------------------
+MarketWatchModel *marketWatchDockWindow::shownModel() const
+{
+    return (allModel && proxy->sourceModel() == allModel) ? allModel : model;
+}
+
+void marketWatchDockWindow::setAllInstrumentsMode(bool on)
+{
+    extern WebSocketConnection* WEB_SOCKET_CONNECTION;
+    if (on && !allModel) {
+        // Rows arrive per instType; the whole universe shares the watchlist's conflator
+        allModel = new MarketWatchModel(this);
+        allModel->setViewportLimited(true);
+        allModel->setKeyColumns(proxy->sortColumn(), proxy->filterKeyColumn());
+        allModel->setFlash(ConfigManager::instance().getFlashMs(), ConfigManager::instance().getFlashFade());
+        connect(conflator, &TickConflator::batchReady, allModel, &MarketWatchModel::onTickBatch);
+        connect(allModel, &MarketWatchModel::subscribeRequested, WEB_SOCKET_CONNECTION, &WebSocketConnection::subscribeTickers);
+        connect(allModel, &MarketWatchModel::unsubscribeRequested, WEB_SOCKET_CONNECTION, &WebSocketConnection::unsubscribeTickers);
+        connect(WEB_SOCKET_CONNECTION, &WebSocketConnection::instrumentSpecsReceived, allModel, &MarketWatchModel::onInstrumentSpecs);
+        connect(WEB_SOCKET_CONNECTION, &WebSocketConnection::instrumentListReceived,
+                this, &marketWatchDockWindow::onInstrumentListReceived, Qt::UniqueConnection);
+        for (const QString &type : ConfigManager::instance().getAllInstrumentTypes()) {
+            pendingInstTypes.insert(type);
+            WEB_SOCKET_CONNECTION->fetchInstrumentList(type);
+        }
+    }
+    if (!allModel)
+        return;
+
+    MarketWatchModel *shown = on ? allModel : model;
+    proxy->setSourceModel(shown);
+    loadColumnVisibilityFromIni();   // The reset forgot the hidden columns
+    model->setLatencyTracking(!on);
+    allModel->setLatencyTracking(on);
+    table->setRowsDeletable(!on);
+    symbolCombo->setEnabled(!on);
+    addButton->setEnabled(!on);
+
+    if (on) {
+        viewportTimer->start();
+    } else {
+        // Leaving the mode drops the universe: one remove, one bulk unsubscribe
+        pendingInstTypes.clear();
+        QList<int> all;
+        all.reserve(allModel->rows.size());
+        for (int row = 0; row < allModel->rows.size(); ++row)
+            all << row;
+        allModel->removeRowsAt(all);
+        allModel->deleteLater();
+        allModel = nullptr;
+    }
+}
+
+void marketWatchDockWindow::onInstrumentListReceived(const QString &instType, const QStringList &instIds)
+{
+    if (!allModel || !pendingInstTypes.remove(instType))
+        return;   // A precision refresh for the watchlist, not asked for here
+
+    QVector<CryptoCV::MarketWatchRowData> newRows;
+    newRows.reserve(instIds.size());
+    for (const QString &symbol : instIds) {
+        CryptoCV::MarketWatchRowData row;
+        row.symbol = symbol;
+        newRows.append(row);
+    }
+    allModel->addRows(newRows);   // One insert, one bulk subscribe and seed
+    qDebug() << "All instruments:" << instIds.size() << instType << "added," << allModel->rows.size() << "rows";
+}
+
+void marketWatchDockWindow::updateViewport()
+{
+    if (!allModel || proxy->sourceModel() != allModel)
+        return;
+
+    // Visible proxy rows plus a margin either side, mapped to source rows
+    QVector<int> sourceRows;
+    const int rowCount = proxy->rowCount();
+    if (rowCount > 0) {
+        const int margin = qMax(0, ConfigManager::instance().getViewportMarginRows());
+        int first = table->rowAt(0);
+        int last = table->rowAt(table->viewport()->height() - 1);
+        if (first < 0) first = 0;
+        if (last < 0) last = rowCount - 1;   // Rows end above the bottom edge
+        first = qMax(0, first - margin);
+        last = qMin(rowCount - 1, last + margin);
+        sourceRows.reserve(last - first + 1);
+        for (int row = first; row <= last; ++row) {
+            const QModelIndex sourceIndex = proxy->mapToSource(proxy->index(row, 0));
+            if (sourceIndex.isValid())
+                sourceRows << sourceIndex.row();
+        }
+    }
+    allModel->setViewportRows(sourceRows);
 }
@@ -7,9 +7,11 @@
  * Description:
  *   Market Watch dock window UI classes for Crypto Trading Platform.
  *   - Data table for market instruments and prices
- *   - Proxy for sorting/filtering
+ *   - Incremental proxy for sorting/filtering (no full re-sort per tick)
  *   - Combo/filter controls for instruments
  *   - Handles double-click events for detailed row view
+ *   - "All instruments" mode: every SPOT/SWAP/FUTURES instrument in a
+ *     viewport-limited model, only the visible rows are kept live
  *   - Saves and loads watched crypto rows and column visibility from INI file
  ******************************************************************************/
 
@@ -18,7 +20,6 @@
 
 #include <QDockWidget>
 #include <QTableView>
-#include <QSortFilterProxyModel>
 #include <QComboBox>
 #include <QPushButton>
 #include <QCheckBox>
@@ -36,8 +37,13 @@
 #include <QSettings>
 #include <QShortcut>
 #include <QKeySequence>
+#include <QSet>
+#include <QTimer>
 #include "protocol.h"
 #include "marketwatchmodel.h"
+#include "tickconflator.h"
+#include "incrementalsortproxy.h"
+#include "tradetape.h"
 
 /**
  * @class MarketWatchDataBase
@@ -59,16 +65,30 @@ class MarketWatchDataTable : public QTableView
 public:
     explicit MarketWatchDataTable(QWidget *parent = nullptr);
 
+    /**
+     * Selected rows (view/proxy indexes).
+     */
+    QList<int> selectedRowList() const;
+
+    /**
+     * Offers "Delete Row" and the Delete key (off for the all instruments view).
+     */
+    void setRowsDeletable(bool deletable) { m_rowsDeletable = deletable; }
+
 public slots:
     void onHeaderContextMenuRequested(const QPoint &pos);
     void showHideColumnsMenuShortcut();
 
 protected:
     void contextMenuEvent(QContextMenuEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;   // Also closes the Paint latency stage
 signals:
     void columnhideSignal();
-    void deleteRowRequested(int row);
+    void deleteRowsRequested(const QList<int> &rows);   // View/proxy rows
+    void timeAndSalesRequested(int row);
 
+private:
+    bool m_rowsDeletable = true;
 };
 
 /**
@@ -84,8 +104,10 @@ public:
 
     // Public members for table/proxy/model UI access
     MarketWatchDataTable *table;
-    QSortFilterProxyModel *proxy;
+    IncrementalSortProxy *proxy;               // Sort/filter, re-sorted per changed row
     MarketWatchModel *model;
+    TickConflator *conflator;                  // Feed -> model batching stage
+    TradeTapeStore *tradeTapes;                // Trades queue -> Time & Sales tapes
 
 public slots:
     void onTableDoubleClickedResponse(QJsonObject data);
@@ -95,10 +117,21 @@ private slots:
     void onTableDoubleClicked(const QModelIndex &index);
     void onSymbolSelected(const QString &symbol);
     void onAddButtonClicked();
-    void deleteRowByIndex(int sourceRow);
+    void deleteRowsByIndex(const QList<int> &sourceRows);
+    void openTimeAndSales(int sourceRow);
+    void setAllInstrumentsMode(bool on);       // Swaps the table between the watchlist and every instrument
+    void onInstrumentListReceived(const QString &instType, const QStringList &instIds);
+    void updateViewport();                     // Tells the all instruments model which rows are on screen
 private:
+    // Model behind the table: the watchlist, or the all instruments one
+    MarketWatchModel *shownModel() const;
+
     QComboBox *symbolCombo;
     QPushButton *addButton;
+    QCheckBox *allCheck;                       // "All instruments" mode
+    MarketWatchModel *allModel = nullptr;      // Viewport-limited, exists while the mode is on
+    QSet<QString> pendingInstTypes;            // instTypes whose instrument list is awaited
+    QTimer *viewportTimer;                     // Coalesces viewport updates (scroll, resize, re-sort)
     QString OrderBookReqSymbol;                // Symbol for orderbook dialog
     QVector<QLineEdit*> filterEdits;           // Inline filter controls
 
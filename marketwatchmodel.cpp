@@ -6,17 +6,37 @@
  *
  * Implementation of MarketWatchModel for the Crypto Trading Platform.
  * Handles table display, row updates, color-coding, deletion, and integration with
- * WebSocket tickers (via OkxTicker). Uses std::map for UID-based storage.
+ * WebSocket tickers (via OkxTicker). Rows live in a QVector indexed by instrument id.
  ******************************************************************************/
 
 #include "marketwatchmodel.h"
-#include "websocketconnection.h"
-#include "globals.h"
+#include "instrumentregistry.h"
+#include "latencyrecorder.h"
+#include "metricsregistry.h"
 #include <QDebug>
 #include <QColor>
-#include <QTimer>
-#include <QMap>
-#include <cmath>
+#include <QGuiApplication>
+#include <QPalette>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <iterator>
+
+// Frame clock (~60 Hz); it only runs while a cell is flashing or dirty
+static const int FRAME_INTERVAL_MS = 16;
+
+// Off-screen sort keys are re-announced at most this often (viewport-limited mode)
+static const qint64 KEY_REFRESH_NS = 250LL * 1000 * 1000;
+
+// Column bit of a dirty mask
+static inline quint8 columnBit(int column)
+{
+    return quint8(1u << column);
+}
+
+static const quint8 PRICE_COLUMNS = columnBit(CryptoCV::MarketWatch_LAST_PRICE) | columnBit(CryptoCV::MarketWatch_BID_PRICE)
+                                    | columnBit(CryptoCV::MarketWatch_ASK_PRICE);
+static const quint8 SIZE_COLUMNS = columnBit(CryptoCV::MarketWatch_ASK_QUANTITY) | columnBit(CryptoCV::MarketWatch_BID_QUANTITY);
+static const quint8 QUOTE_COLUMNS = PRICE_COLUMNS | SIZE_COLUMNS;
 
 // Static unique ID for each row
 int MarketWatchModel::uid = 0;
@@ -32,21 +52,26 @@ const QStringList marketwatchColumnInfo = {
     "Bid Quantity"
 };
 
-// Color flash threshold: any change triggers flash
-static const double FLASH_THRESHOLD = 0.00;
-
 //------------------------------------------------------------------------------
 // Constructor & Destructor
 //------------------------------------------------------------------------------
 MarketWatchModel::MarketWatchModel(QObject *parent)
-    : QAbstractTableModel(parent)
+    : QAbstractTableModel(parent),
+      m_frameTimer(this)
 {
+    m_textColor = QGuiApplication::palette().color(QPalette::Text);
+    m_frameTimer.setInterval(FRAME_INTERVAL_MS);
+    connect(&m_frameTimer, &QTimer::timeout, this, &MarketWatchModel::onFrame);
 }
 
 MarketWatchModel::~MarketWatchModel()
 {
-    qDeleteAll(colorTimers);
-    colorTimers.clear();
+}
+
+void MarketWatchModel::setFlash(int flashMs, bool fade)
+{
+    m_flashNs = qint64(qMax(0, flashMs)) * 1000 * 1000;
+    m_flashFade = fade;
 }
 
 //------------------------------------------------------------------------------
@@ -67,52 +92,58 @@ QVariant MarketWatchModel::data(const QModelIndex &index, int role) const
     if (!index.isValid())
         return QVariant();
 
-    // Use iterator math for std::map access by row index
-    auto it = rows.cbegin();
-    std::advance(it, index.row());
-    if (it == rows.cend())
+    if (index.row() >= rows.size())
         return QVariant();
-    const CryptoCV::MarketWatchRowData &r = it->second;
+    const CryptoCV::MarketWatchRowData &r = rows.at(index.row());
 
     // Display data in cells
     if (role == Qt::DisplayRole) {
         switch (index.column()) {
         case CryptoCV::MarketWatchColumn::MarketWatch_UID:         return r.uid;
         case CryptoCV::MarketWatchColumn::MarketWatch_SYMBOL:      return r.symbol;
-        case CryptoCV::MarketWatchColumn::MarketWatch_LAST_PRICE:  return QString::number(r.lastPrice, 'f', 2);
-        case CryptoCV::MarketWatchColumn::MarketWatch_BID_PRICE:   return QString::number(r.bidPrice, 'f', 2);
-        case CryptoCV::MarketWatchColumn::MarketWatch_ASK_PRICE:   return QString::number(r.askPrice, 'f', 2);
-        case CryptoCV::MarketWatchColumn::MarketWatch_ASK_QUANTITY:return QString::number(r.askQty, 'f', 4);
-        case CryptoCV::MarketWatchColumn::MarketWatch_BID_QUANTITY:return QString::number(r.bidQty, 'f', 4);
+        // Formatted when the value changed (formatCells); the QString is shared, not rebuilt
+        case CryptoCV::MarketWatchColumn::MarketWatch_LAST_PRICE:
+        case CryptoCV::MarketWatchColumn::MarketWatch_BID_PRICE:
+        case CryptoCV::MarketWatchColumn::MarketWatch_ASK_PRICE:
+        case CryptoCV::MarketWatchColumn::MarketWatch_ASK_QUANTITY:
+        case CryptoCV::MarketWatchColumn::MarketWatch_BID_QUANTITY: {
+            const int f = index.column() - CryptoCV::MarketWatch_LAST_PRICE;
+            if (r.textStale)   // Off-viewport row asked anyway (sort, filter): format on the spot
+                return m_quotes.value(QuoteStore::Field(f), index.row())
+                    .toString((PRICE_COLUMNS & columnBit(index.column())) ? r.priceDecimals : r.sizeDecimals);
+            return r.text[f];
+        }
         }
     }
     // Color coding for cell updates
     else if (role == Qt::ForegroundRole) {
         switch (index.column()) {
         case CryptoCV::MarketWatchColumn::MarketWatch_LAST_PRICE:
-            if (r.lastPrice > r.prevPrice + FLASH_THRESHOLD) return QColor(Qt::green);
-            else if (r.lastPrice < r.prevPrice - FLASH_THRESHOLD) return QColor(Qt::red);
-            break;
         case CryptoCV::MarketWatchColumn::MarketWatch_BID_PRICE:
-            if (r.bidPrice > r.prevBid + FLASH_THRESHOLD) return QColor(Qt::green);
-            else if (r.bidPrice < r.prevBid - FLASH_THRESHOLD) return QColor(Qt::red);
-            break;
         case CryptoCV::MarketWatchColumn::MarketWatch_ASK_PRICE:
-            if (r.askPrice > r.prevAsk + FLASH_THRESHOLD) return QColor(Qt::green);
-            else if (r.askPrice < r.prevAsk - FLASH_THRESHOLD) return QColor(Qt::red);
-            break;
         case CryptoCV::MarketWatchColumn::MarketWatch_ASK_QUANTITY:
-            if (r.askQty > r.prevAskQty + FLASH_THRESHOLD) return QColor(Qt::green);
-            else if (r.askQty < r.prevAskQty - FLASH_THRESHOLD) return QColor(Qt::red);
-            break;
         case CryptoCV::MarketWatchColumn::MarketWatch_BID_QUANTITY:
-            if (r.bidQty > r.prevBidQty + FLASH_THRESHOLD) return QColor(Qt::green);
-            else if (r.bidQty < r.prevBidQty - FLASH_THRESHOLD) return QColor(Qt::red);
-            break;
+            return flashColor(r, index.column(),
+                              m_quotes.rising(QuoteStore::Field(index.column() - CryptoCV::MarketWatch_LAST_PRICE), index.row()));
         default:
             break;
         }
     }
+    // Sort keys for the proxy: prices compare as numbers, not as text
+    else if (role == SortRole) {
+        switch (index.column()) {
+        case CryptoCV::MarketWatchColumn::MarketWatch_UID:         return r.uid;
+        case CryptoCV::MarketWatchColumn::MarketWatch_SYMBOL:      return r.symbol;
+        case CryptoCV::MarketWatchColumn::MarketWatch_LAST_PRICE:
+        case CryptoCV::MarketWatchColumn::MarketWatch_BID_PRICE:
+        case CryptoCV::MarketWatchColumn::MarketWatch_ASK_PRICE:
+        case CryptoCV::MarketWatchColumn::MarketWatch_ASK_QUANTITY:
+        case CryptoCV::MarketWatchColumn::MarketWatch_BID_QUANTITY: {
+            const CryptoCV::Decimal value = m_quotes.value(QuoteStore::Field(index.column() - CryptoCV::MarketWatch_LAST_PRICE), index.row());
+            return value.isNull() ? QVariant() : QVariant(value.toDouble());
+        }
+        }
+    }
     // Center text alignment
     else if (role == Qt::TextAlignmentRole) {
         return Qt::AlignCenter;
@@ -120,6 +151,24 @@ QVariant MarketWatchModel::data(const QModelIndex &index, int role) const
     return QVariant();
 }
 
+QVariant MarketWatchModel::flashColor(const CryptoCV::MarketWatchRowData &r, int column, bool up) const
+{
+    const qint64 changedNs = r.changedNs[column - CryptoCV::MarketWatch_LAST_PRICE];
+    if (changedNs == 0)
+        return QVariant();
+    const qint64 age = qMax<qint64>(0, m_frameNs - changedNs);
+    if (age >= m_flashNs)
+        return QVariant();   // Expired, the frame clock has not cleared it yet
+
+    const QColor hot = up ? QColor(Qt::green) : QColor(Qt::red);
+    if (!m_flashFade)
+        return hot;
+    const double k = 1.0 - double(age) / double(m_flashNs);   // 1 = just changed
+    return QColor::fromRgbF(hot.redF() * k + m_textColor.redF() * (1.0 - k),
+                            hot.greenF() * k + m_textColor.greenF() * (1.0 - k),
+                            hot.blueF() * k + m_textColor.blueF() * (1.0 - k));
+}
+
 QVariant MarketWatchModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
     if (role == Qt::DisplayRole && orientation == Qt::Horizontal)
@@ -133,118 +182,428 @@ QVariant MarketWatchModel::headerData(int section, Qt::Orientation orientation,
 //------------------------------------------------------------------------------
 // Add New Row
 //------------------------------------------------------------------------------
-void MarketWatchModel::addRow(const CryptoCV::MarketWatchRowData &Data)
+bool MarketWatchModel::prepareRow(CryptoCV::MarketWatchRowData &row, int rowIndex)
 {
-    int rowIndex = static_cast<int>(rows.size());
-    beginInsertRows(QModelIndex(), rowIndex, rowIndex);
+    row.instrument = InstrumentRegistry::instance().intern(row.symbol);
+    if (rowOfInstrument(row.instrument) >= 0)
+        return false;
+    if (row.instrument >= m_rowOfInstrument.size())
+        m_rowOfInstrument.resize(row.instrument + 1, -1);
+    m_rowOfInstrument[row.instrument] = rowIndex;
 
+    row.uid = ++uid;
+    row.inViewport = !m_viewportLimited;
+    applyKnownPrecision(row);   // Quotes start null: the cell text stays empty until the first tick
+    return true;
+}
+
+quint8 MarketWatchModel::applyKnownPrecision(CryptoCV::MarketWatchRowData &r) const
+{
+    int priceDecimals = 0, sizeDecimals = 0;
+    if (!InstrumentRegistry::instance().precision(r.instrument, &priceDecimals, &sizeDecimals))
+        return 0;
+    quint8 columns = 0;
+    if (priceDecimals != r.priceDecimals) columns |= PRICE_COLUMNS;
+    if (sizeDecimals != r.sizeDecimals) columns |= SIZE_COLUMNS;
+    r.priceDecimals = priceDecimals;
+    r.sizeDecimals = sizeDecimals;
+    r.knownPrecision = true;
+    return columns;
+}
+
+void MarketWatchModel::formatCells(int row, quint8 columns)
+{
+    CryptoCV::MarketWatchRowData &r = rows[row];
+    for (int f = 0; f < QuoteStore::FIELD_COUNT; ++f) {
+        const int column = CryptoCV::MarketWatch_LAST_PRICE + f;
+        if (!(columns & columnBit(column))) continue;
+        const int decimals = (PRICE_COLUMNS & columnBit(column)) ? r.priceDecimals : r.sizeDecimals;
+        r.text[f] = m_quotes.value(QuoteStore::Field(f), row).toString(decimals);
+    }
+}
+
+void MarketWatchModel::onInstrumentSpecs()
+{
+    for (int row = 0; row < rows.size(); ++row) {
+        const quint8 columns = applyKnownPrecision(rows[row]);
+        if (!columns) continue;
+        if (!rows.at(row).inViewport) {
+            rows[row].textStale = true;   // Formatted when it scrolls in
+            continue;
+        }
+        formatCells(row, columns);
+        markDirty(rows.at(row).instrument, columns, 0);
+    }
+}
+
+void MarketWatchModel::addRow(const CryptoCV::MarketWatchRowData &Data)
+{
     CryptoCV::MarketWatchRowData newRow = Data;
-    newRow.uid = ++uid;
-    newRow.prevPrice = newRow.lastPrice;
-    newRow.prevBid   = newRow.bidPrice;
-    newRow.prevAsk   = newRow.askPrice;
-    newRow.prevAskQty = newRow.askQty;
-    newRow.prevBidQty = newRow.bidQty;
-    rows[newRow.uid] = newRow;
+    int rowIndex = int(rows.size());
+    if (!prepareRow(newRow, rowIndex)) {
+        qDebug() << Data.symbol << "is already in the market watch";
+        return;
+    }
+    beginInsertRows(QModelIndex(), rowIndex, rowIndex);
+    rows.append(newRow);
+    m_quotes.append();
     endInsertRows();
 
-    extern WebSocketConnection* WEB_SOCKET_CONNECTION;
-    WEB_SOCKET_CONNECTION->subscribeTickers(QStringList() << Data.symbol);
+    emit subscribeRequested(QStringList() << Data.symbol);
 }
 
 void MarketWatchModel::addRows(const QVector<CryptoCV::MarketWatchRowData> &Data)
 {
+    // Index first, so duplicates (within the batch too) are known before the insert is announced
+    QVector<CryptoCV::MarketWatchRowData> newRows;
+    newRows.reserve(Data.size());
     QStringList listOfSymbol;
-    for(const auto& symbolRow : Data) {
-        int rowIndex = static_cast<int>(rows.size());
-        beginInsertRows(QModelIndex(), rowIndex, rowIndex);
+    listOfSymbol.reserve(Data.size());
+    for (const auto &symbolRow : Data) {
         CryptoCV::MarketWatchRowData newRow = symbolRow;
-        newRow.uid = ++uid;
-        newRow.prevPrice = newRow.lastPrice;
-        newRow.prevBid   = newRow.bidPrice;
-        newRow.prevAsk   = newRow.askPrice;
-        newRow.prevAskQty = newRow.askQty;
-        newRow.prevBidQty = newRow.bidQty;
-        rows[newRow.uid] = newRow;
-        endInsertRows();
+        if (!prepareRow(newRow, int(rows.size() + newRows.size()))) continue;
+        newRows.append(newRow);
         listOfSymbol << symbolRow.symbol;
     }
-    extern WebSocketConnection* WEB_SOCKET_CONNECTION;
-    WEB_SOCKET_CONNECTION->subscribeTickers(listOfSymbol);
+    if (newRows.isEmpty())
+        return;
+
+    // One insert notification for the whole batch
+    int firstRow = int(rows.size());
+    beginInsertRows(QModelIndex(), firstRow, firstRow + newRows.size() - 1);
+    rows.append(newRows);
+    m_quotes.append(int(newRows.size()));
+    endInsertRows();
+
+    // One bulk subscription for the whole batch
+    emit subscribeRequested(listOfSymbol);
 }
 
 
 void MarketWatchModel::removeRowAt(int row)
 {
-    if (row < 0 || row >= static_cast<int>(rows.size()))
+    removeRowsAt(QList<int>() << row);
+}
+
+void MarketWatchModel::removeRowsAt(const QList<int> &rowList)
+{
+    QList<int> sorted;
+    sorted.reserve(rowList.size());
+    for (int row : rowList) {
+        if (row >= 0 && row < rows.size())
+            sorted << row;
+    }
+    if (sorted.isEmpty())
         return;
-    auto it = rows.begin();
-    std::advance(it, row);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    // Bottom-up, one remove notification per contiguous range, so the ranges
+    // still to go keep their indexes
+    QStringList listOfSymbol;
+    listOfSymbol.reserve(sorted.size());
+    int last = int(sorted.size()) - 1;
+    while (last >= 0) {
+        int first = last;
+        while (first > 0 && sorted.at(first - 1) == sorted.at(first) - 1)
+            --first;
+        const int firstRow = sorted.at(first);
+        const int count = last - first + 1;
+
+        beginRemoveRows(QModelIndex(), firstRow, firstRow + count - 1);   // Tell the view
+        for (int i = firstRow; i < firstRow + count; ++i) {
+            m_rowOfInstrument[rows.at(i).instrument] = -1;
+            listOfSymbol << rows.at(i).symbol;
+        }
+        rows.remove(firstRow, count);
+        m_quotes.remove(firstRow, count);
+        endRemoveRows();                               // Tell the view
+
+        last = first - 1;
+    }
+    for (int i = sorted.first(); i < rows.size(); ++i)   // Rows below moved up, indexed once
+        m_rowOfInstrument[rows.at(i).instrument] = i;
 
-    beginRemoveRows(QModelIndex(), row, row);   // Tell the view
-    rows.erase(it);                             // Remove from map
-    endRemoveRows();                            // Tell the view
+    // One bulk unsubscription for the whole selection
+    emit unsubscribeRequested(listOfSymbol);
 }
 
 
+//------------------------------------------------------------------------------
+// Tick updates
+//------------------------------------------------------------------------------
+void MarketWatchModel::onTickBatch(const QVector<CryptoCV::OkxTicker> &batch)
+{
+    applyTicks(batch.constData(), int(batch.size()));
+    // A conflated batch already is a frame (the conflator paces it); only
+    // unconflated ticks and flashes wait for the frame clock
+    flushDirty();
+}
+
 void MarketWatchModel::onBrodcastRcv(CryptoCV::OkxTicker Tick)
 {
-    int rowIndex = 0;
-    for (const auto &kv : rows) {
-        auto& r = const_cast<CryptoCV::MarketWatchRowData&>(kv.second); // modifiable reference
-        if (Tick.instId == r.symbol) {
-            bool changed = std::fabs(Tick.last - r.lastPrice) > FLASH_THRESHOLD ||
-                           std::fabs(Tick.bid  - r.bidPrice) > FLASH_THRESHOLD ||
-                           std::fabs(Tick.ask  - r.askPrice) > FLASH_THRESHOLD ||
-                           std::fabs(Tick.bidQty - r.bidQty) > FLASH_THRESHOLD ||
-                           std::fabs(Tick.askQty - r.askQty) > FLASH_THRESHOLD;
-            if (!changed) { ++rowIndex; continue; }
-
-            r.prevPrice = r.lastPrice;
-            r.prevBid   = r.bidPrice;
-            r.prevAsk   = r.askPrice;
-            r.prevAskQty = r.askQty;
-            r.prevBidQty = r.bidQty;
-
-            r.lastPrice = Tick.last;
-            r.bidPrice  = Tick.bid;
-            r.askPrice  = Tick.ask;
-            r.bidQty    = Tick.bidQty;
-            r.askQty    = Tick.askQty;
-
-            QModelIndex topLeft = index(rowIndex, 0);
-            QModelIndex bottomRight = index(rowIndex, columnCount() - 1);
-            emit dataChanged(topLeft, bottomRight,
-                             {Qt::DisplayRole, Qt::ForegroundRole, Qt::TextAlignmentRole});
-
-            if (colorTimers.contains(kv.first)) {
-                colorTimers[kv.first]->stop();
-                colorTimers[kv.first]->deleteLater();
+    applyTicks(&Tick, 1);
+}
+
+void MarketWatchModel::applyTicks(const CryptoCV::OkxTicker *ticks, int count)
+{
+    // Keep the ticks of shown instruments, then compare the whole batch at once
+    m_batchRows.clear();
+    m_batchTicks.clear();
+    for (int i = 0; i < count; ++i) {
+        const int row = rowOfInstrument(ticks[i].instrument);   // Int lookup; the symbol is display-only
+        if (row < 0) continue;
+        m_batchRows.push_back(row);
+        m_batchTicks.push_back(ticks[i]);
+    }
+    if (m_batchRows.empty())
+        return;
+    const int n = int(m_batchRows.size());
+    m_batchChanged.resize(size_t(n));
+    // Exact compares: no tolerance, no spurious flashes from rounding
+    m_quotes.applyBatch(m_batchRows.data(), m_batchTicks.data(), n, m_batchChanged.data());
+
+    const qint64 appliedNs = LatencyRecorder::nowNs();
+    m_frameNs = appliedNs;
+    for (int i = 0; i < n; ++i) {
+        const quint8 fields = m_batchChanged[size_t(i)];
+        if (!fields) continue;
+        const int rowIndex = m_batchRows[size_t(i)];
+        const CryptoCV::OkxTicker &Tick = m_batchTicks[size_t(i)];
+        CryptoCV::MarketWatchRowData &r = rows[rowIndex];
+
+        quint8 changed = quint8(fields << CryptoCV::MarketWatch_LAST_PRICE);   // Field bit -> column bit
+
+        // Without metadata the precision is the widest scale seen; widening re-formats the group
+        if (!r.knownPrecision) {
+            const int priceDecimals = qMax(r.priceDecimals, qMax<int>(Tick.last.scale, qMax(Tick.bid.scale, Tick.ask.scale)));
+            const int sizeDecimals = qMax(r.sizeDecimals, qMax<int>(Tick.bidQty.scale, Tick.askQty.scale));
+            if (priceDecimals != r.priceDecimals) changed |= PRICE_COLUMNS;
+            if (sizeDecimals != r.sizeDecimals) changed |= SIZE_COLUMNS;
+            r.priceDecimals = priceDecimals;
+            r.sizeDecimals = sizeDecimals;
+        }
+        if (!r.inViewport) {   // Off-screen: stored only, formatted (not flashed) when it scrolls in
+            r.textStale = true;
+            if (changed & m_keyColumns)
+                markKeyDirty(Tick.instrument);
+            continue;
+        }
+        // Stamped only with startFlash below, so the frame clock expires every flash it colours
+        for (int f = 0; f < QuoteStore::FIELD_COUNT; ++f) {
+            if (fields & (1u << f))
+                r.changedNs[f] = appliedNs;
+        }
+        formatCells(rowIndex, changed);
+
+        markDirty(Tick.instrument, changed, 0);
+        if (m_latencyTracking && Tick.recvNs > 0)   // Only stream ticks are measured
+            m_appliedTicks.append(AppliedTick{Tick, appliedNs});
+        startFlash(Tick.instrument);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Viewport
+//------------------------------------------------------------------------------
+void MarketWatchModel::setViewportRows(const QVector<int> &sourceRows)
+{
+    if (!m_viewportLimited)
+        return;
+
+    for (int instrument : std::as_const(m_viewportInstruments)) {
+        const int row = rowOfInstrument(instrument);
+        if (row >= 0)
+            rows[row].inViewport = false;
+    }
+    QVector<int> previous;
+    previous.swap(m_viewportInstruments);
+
+    m_viewportInstruments.reserve(sourceRows.size());
+    for (int row : sourceRows) {
+        if (row < 0 || row >= rows.size()) continue;
+        CryptoCV::MarketWatchRowData &r = rows[row];
+        if (r.inViewport) continue;   // Listed twice
+        r.inViewport = true;
+        m_viewportInstruments.append(r.instrument);
+        if (r.textStale) {
+            r.textStale = false;
+            formatCells(row, QUOTE_COLUMNS);
+            markDirty(r.instrument, QUOTE_COLUMNS, 0);
+        }
+    }
+
+    // Rows that left: drop their flash (the frame clock forgets them)
+    for (int instrument : std::as_const(previous)) {
+        const int row = rowOfInstrument(instrument);
+        if (row < 0 || rows.at(row).inViewport) continue;
+        std::fill(std::begin(rows[row].changedNs), std::end(rows[row].changedNs), qint64(0));
+    }
+}
+
+void MarketWatchModel::setKeyColumns(int sortColumn, int filterColumn)
+{
+    quint8 columns = 0;
+    for (int column : {sortColumn, filterColumn}) {
+        if (column >= 0 && column < CryptoCV::MarketWatch_TOTAL_COLUMNS)
+            columns |= columnBit(column);
+    }
+    m_keyColumns = columns & QUOTE_COLUMNS;   // Uid and symbol never change on a tick
+}
+
+void MarketWatchModel::markKeyDirty(int instrument)
+{
+    if (instrument >= m_isKeyDirty.size())
+        m_isKeyDirty.resize(instrument + 1, 0);
+    if (!m_isKeyDirty.at(instrument)) {
+        m_isKeyDirty[instrument] = 1;
+        m_keyDirty.append(instrument);
+    }
+    if (!m_frameTimer.isActive())
+        m_frameTimer.start();
+}
+
+void MarketWatchModel::flushKeys()
+{
+    if (m_keyDirty.isEmpty() || m_frameNs - m_lastKeyFlushNs < KEY_REFRESH_NS)
+        return;
+    m_lastKeyFlushNs = m_frameNs;
+
+    QVector<DirtyRow> keys;
+    keys.reserve(m_keyDirty.size());
+    for (int instrument : std::as_const(m_keyDirty)) {
+        m_isKeyDirty[instrument] = 0;
+        const int row = rowOfInstrument(instrument);
+        if (row >= 0 && m_keyColumns)
+            keys.append(DirtyRow{row, m_keyColumns});
+    }
+    m_keyDirty.clear();
+    emitRanges(keys, {SortRole});
+}
+
+//------------------------------------------------------------------------------
+// Dirty cells
+//------------------------------------------------------------------------------
+void MarketWatchModel::markDirty(int instrument, quint8 valueColumns, quint8 colourColumns)
+{
+    if (instrument >= m_dirtyValues.size()) {
+        m_dirtyValues.resize(instrument + 1, 0);
+        m_dirtyColours.resize(instrument + 1, 0);
+    }
+    if (m_dirtyValues.at(instrument) == 0 && m_dirtyColours.at(instrument) == 0)
+        m_dirty.append(instrument);
+    m_dirtyValues[instrument] |= valueColumns;
+    m_dirtyColours[instrument] |= colourColumns;
+    if (!m_frameTimer.isActive())
+        m_frameTimer.start();
+}
+
+void MarketWatchModel::flushDirty()
+{
+    if (m_dirty.isEmpty())
+        return;
+
+    QVector<DirtyRow> values;    // Text changed: DisplayRole + ForegroundRole
+    QVector<DirtyRow> colours;   // Only the flash colour changed
+    for (int instrument : std::as_const(m_dirty)) {
+        const quint8 valueColumns = m_dirtyValues.at(instrument);
+        const quint8 colourColumns = m_dirtyColours.at(instrument);
+        m_dirtyValues[instrument] = 0;
+        m_dirtyColours[instrument] = 0;
+        const int row = rowOfInstrument(instrument);
+        if (row < 0)
+            continue;   // Removed since it was marked
+        if (valueColumns)
+            values.append(DirtyRow{row, quint8(valueColumns | colourColumns)});
+        else
+            colours.append(DirtyRow{row, colourColumns});
+    }
+    m_dirty.clear();
+
+    emitRanges(values, {Qt::DisplayRole, Qt::ForegroundRole});
+    emitRanges(colours, {Qt::ForegroundRole});
+
+    const qint64 emittedNs = LatencyRecorder::nowNs();
+    for (const AppliedTick &applied : std::as_const(m_appliedTicks)) {
+        const int row = rowOfInstrument(applied.tick.instrument);
+        if (row >= 0)
+            LatencyRecorder::instance().onTickApplied(applied.tick, row, applied.appliedNs, emittedNs);
+    }
+    m_appliedTicks.clear();
+}
+
+void MarketWatchModel::emitRanges(QVector<DirtyRow> &dirty, const QVector<int> &roles)
+{
+    std::sort(dirty.begin(), dirty.end(), [](const DirtyRow &a, const DirtyRow &b) { return a.row < b.row; });
+    for (int i = 0; i < dirty.size();) {
+        quint8 columns = dirty.at(i).columns;
+        int j = i;
+        while (j + 1 < dirty.size() && dirty.at(j + 1).row == dirty.at(j).row + 1)
+            columns |= dirty.at(++j).columns;
+        const int firstColumn = qCountTrailingZeroBits(columns);
+        const int lastColumn = 7 - qCountLeadingZeroBits(columns);
+        emit dataChanged(index(dirty.at(i).row, firstColumn), index(dirty.at(j).row, lastColumn), roles);
+        MetricsRegistry::instance().dataChanged.add();
+        i = j + 1;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Flash frame clock
+//------------------------------------------------------------------------------
+void MarketWatchModel::startFlash(int instrument)
+{
+    if (m_flashNs <= 0)
+        return;
+    if (instrument >= m_isFlashing.size())
+        m_isFlashing.resize(instrument + 1, false);
+    if (!m_isFlashing.at(instrument)) {
+        m_isFlashing[instrument] = true;
+        m_flashing.append(instrument);
+    }
+    if (!m_frameTimer.isActive())
+        m_frameTimer.start();
+}
+
+void MarketWatchModel::onFrame()
+{
+    m_frameNs = LatencyRecorder::nowNs();
+
+    // Cells whose colour changes this frame: expired ones, or every live one when fading
+    int kept = 0;
+    for (int i = 0; i < m_flashing.size(); ++i) {
+        const int instrument = m_flashing.at(i);
+        const int row = rowOfInstrument(instrument);
+        if (row < 0) {   // Removed while flashing
+            m_isFlashing[instrument] = false;
+            continue;
+        }
+        CryptoCV::MarketWatchRowData &r = rows[row];
+        quint8 repaint = 0;
+        bool live = false;
+        for (int c = 0; c < CryptoCV::MarketWatch_FLASH_COLUMNS; ++c) {
+            qint64 &changedNs = r.changedNs[c];
+            if (changedNs == 0) continue;
+            if (m_frameNs - changedNs >= m_flashNs) {
+                changedNs = 0;
+                repaint |= columnBit(CryptoCV::MarketWatch_LAST_PRICE + c);
+            } else {
+                live = true;
+                if (m_flashFade)
+                    repaint |= columnBit(CryptoCV::MarketWatch_LAST_PRICE + c);
             }
-            QTimer* timer = new QTimer(this);
-            colorTimers[kv.first] = timer;
-            timer->setSingleShot(true);
-
-            connect(timer, &QTimer::timeout, this, [this, rowIndex, key=kv.first]() {
-                auto it = rows.find(key);
-                if (it != rows.end()) {
-                    auto &r = it->second;
-                    r.prevPrice = r.lastPrice;
-                    r.prevBid   = r.bidPrice;
-                    r.prevAsk   = r.askPrice;
-                    r.prevAskQty = r.askQty;
-                    r.prevBidQty = r.bidQty;
-                    QModelIndex topLeft = index(rowIndex, 0);
-                    QModelIndex bottomRight = index(rowIndex, columnCount() - 1);
-                    emit dataChanged(topLeft, bottomRight,
-                                     {Qt::ForegroundRole, Qt::TextAlignmentRole});
-                }
-                colorTimers.remove(key);
-                sender()->deleteLater();
-            });
-
-            timer->start(150);
         }
-        ++rowIndex;
+        if (repaint)
+            markDirty(instrument, 0, repaint);
+        if (live)
+            m_flashing[kept++] = instrument;
+        else
+            m_isFlashing[instrument] = false;
     }
+    m_flashing.resize(kept);
+
+    flushDirty();
+    flushKeys();
+    if (m_flashing.isEmpty() && m_keyDirty.isEmpty())
+        m_frameTimer.stop();
 }
@@ -6,30 +6,48 @@
  *
  * Description:
  *   Model class for the Market Watch table. Handles row data, updates from
- *   tickers, and UI color change timers.
+ *   tickers, and the green/red flash of changed cells.
  *   Inherits from QAbstractTableModel for use with QTableView.
- *   Supports batch row add and mapped row storage for deletion by UID.
+ *   Rows are stored contiguously in display order, with a dense
+ *   instrument id -> row index, so cell reads and tick routing are O(1).
+ *   Quotes live in a columnar QuoteStore; a tick batch is compared against
+ *   it in one vectorized pass.
+ *   Flashes are per-cell "changed at" stamps; one frame clock expires (or
+ *   fades) them.
+ *   Price/qty text is formatted once per change (native precision from
+ *   instrument metadata) and data() hands out the stored string.
+ *   Changed cells are marked in per-row column bitmasks and flushed at most
+ *   once per frame: adjacent rows merge into one dataChanged carrying only
+ *   the changed columns and roles.
+ *   Viewport-limited mode (all instruments view) keeps every quote current
+ *   but formats, flashes and announces only the rows on screen plus a margin.
  ******************************************************************************/
 
 #ifndef MARKETWATCHMODEL_H
 #define MARKETWATCHMODEL_H
 
 #include <QAbstractTableModel>
-#include <map>
+#include <QColor>
+#include <QVector>
 #include <QTimer>
+#include <vector>
 #include "protocol.h"
+#include "quotestore.h"
 
 extern const QStringList  marketwatchColumnInfo; ///< Global column label info
 
 /**
  * @class MarketWatchModel
- * @brief Table model for market data and UI, supports row broadcasts and color timers.
+ * @brief Table model for market data and UI, supports row broadcasts and cell flashes.
  */
 class MarketWatchModel : public QAbstractTableModel
 {
     Q_OBJECT
 
 public:
+    // Numeric sort key: uid, symbol, or the quote as a double (empty until the first tick)
+    static const int SortRole = Qt::UserRole;
+
     explicit MarketWatchModel(QObject *parent = nullptr);
     ~MarketWatchModel();
 
@@ -38,6 +56,9 @@ public:
     QVariant data(const QModelIndex &index, int role) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
 
+    /**
+     * Appends rows; a symbol already in the watch is not added twice.
+     */
     void addRow(const CryptoCV::MarketWatchRowData &Data);
     void addRows(const QVector<CryptoCV::MarketWatchRowData> &Data);
 
@@ -47,14 +68,168 @@ public:
      */
     void removeRowAt(int row);
 
-    std::map<int, CryptoCV::MarketWatchRowData> rows;
+    /**
+     * Removes many rows with one remove notification per contiguous range
+     * and one ticker unsubscription for all of them.
+     * @param rowList Row indexes to remove, in any order (duplicates ignored)
+     */
+    void removeRowsAt(const QList<int> &rowList);
+
+    /**
+     * Flash look for changed cells.
+     * @param flashMs How long a change stays coloured
+     * @param fade Fade towards the normal text colour instead of a hard cut
+     */
+    void setFlash(int flashMs, bool fade);
+
+    /**
+     * Viewport-limited mode, for watches of thousands of instruments: every
+     * tick still lands in the QuoteStore, but only rows set by setViewportRows()
+     * are formatted, flashed and announced with dataChanged. Set before rows are added.
+     */
+    void setViewportLimited(bool limited) { m_viewportLimited = limited; }
+    bool viewportLimited() const { return m_viewportLimited; }
+
+    /**
+     * Rows on screen plus a margin (viewport-limited mode only). Rows coming
+     * into view are re-formatted if their quotes moved meanwhile; rows leaving
+     * it stop flashing.
+     * @param sourceRows Row indexes, in any order
+     */
+    void setViewportRows(const QVector<int> &sourceRows);
+
+    /**
+     * Columns the proxy sorts and filters by (-1 = none). In viewport-limited
+     * mode an off-screen row whose value changed in one of them is announced
+     * with a SortRole-only dataChanged, at most every 250 ms, so the proxy
+     * keeps it in order without the row being formatted.
+     */
+    void setKeyColumns(int sortColumn, int filterColumn);
+
+    /**
+     * Whether stream ticks are handed to LatencyRecorder (only the model the
+     * table shows should, the recorder resolves rows against it). On by default.
+     */
+    void setLatencyTracking(bool on) { m_latencyTracking = on; }
+
+    /**
+     * Row showing an instrument, -1 if it is not in the watch.
+     * @param instrument Id from InstrumentRegistry
+     */
+    int rowOfInstrument(int instrument) const
+    {
+        return (instrument >= 0 && instrument < m_rowOfInstrument.size()) ? m_rowOfInstrument.at(instrument) : -1;
+    }
+
+    const QuoteStore &quotes() const { return m_quotes; }
+
+    QVector<CryptoCV::MarketWatchRowData> rows;    // Display order; read-only outside the model
+
+signals:
+    /**
+     * Rows were added for these symbols; one emission per batch, so the owner
+     * can send a single bulk ticker subscribe. The model holds no feed connection.
+     */
+    void subscribeRequested(const QStringList &instIds);
+
+    /**
+     * Rows for these symbols were removed; one emission per removeRowsAt() call,
+     * for a single bulk ticker unsubscribe.
+     */
+    void unsubscribeRequested(const QStringList &instIds);
 
 public slots:
     void onBrodcastRcv(CryptoCV::OkxTicker Tick);
+    void onTickBatch(const QVector<CryptoCV::OkxTicker> &batch); // Conflated release from TickConflator
+
+private slots:
+    void onInstrumentSpecs();   // Precision metadata arrived: re-format affected rows
+    void onFrame();   // Frame clock: expires/fades flashes, flushes dirty cells
 
 private:
+    // Gives the row an instrument id and a uid and indexes it at rowIndex; false if the symbol is already shown
+    bool prepareRow(CryptoCV::MarketWatchRowData &row, int rowIndex);
+
+    // Takes the instrument's metadata precision if known; returns the columns to re-format
+    quint8 applyKnownPrecision(CryptoCV::MarketWatchRowData &r) const;
+
+    // Rebuilds the cached text of the given price/qty columns of a row (bit = 1 << column)
+    void formatCells(int row, quint8 columns);
+
+    // Applies ticks of any instruments (unknown ones are skipped) through one QuoteStore batch
+    void applyTicks(const CryptoCV::OkxTicker *ticks, int count);
+
+    // Starts (or restarts) the flash of the changed cells of a row
+    void startFlash(int instrument);
+
+    // ForegroundRole of a price/qty cell: green/red while it flashes, empty afterwards
+    QVariant flashColor(const CryptoCV::MarketWatchRowData &r, int column, bool up) const;
+
+    // Marks cells for the next flush (bit = 1 << column)
+    void markDirty(int instrument, quint8 valueColumns, quint8 colourColumns);
+
+    // Off-screen row whose sort/filter key moved (viewport-limited mode)
+    void markKeyDirty(int instrument);
+
+    // SortRole-only dataChanged for the off-screen rows marked since the last one (throttled)
+    void flushKeys();
+
+    // Emits the dirty cells and closes the Model latency stage of the ticks behind them
+    void flushDirty();
+
+    /**
+     * @struct DirtyRow
+     * @brief Source row plus the columns to announce.
+     */
+    struct DirtyRow {
+        int row;
+        quint8 columns;
+    };
+
+    // One dataChanged per run of adjacent rows, spanning the union of their columns (sorts dirty)
+    void emitRanges(QVector<DirtyRow> &dirty, const QVector<int> &roles);
+
+    /**
+     * @struct AppliedTick
+     * @brief Tick waiting for its dataChanged, for LatencyRecorder.
+     */
+    struct AppliedTick {
+        CryptoCV::OkxTicker tick;
+        qint64 appliedNs;
+    };
+
     static int uid;
-    QMap<int, QTimer*> colorTimers;
+    QVector<int> m_rowOfInstrument;                // Instrument id -> row, -1 = not shown
+    QuoteStore m_quotes;                           // Row -> quote columns
+
+    // applyTicks scratch, reused between batches
+    std::vector<int> m_batchRows;
+    std::vector<CryptoCV::OkxTicker> m_batchTicks;
+    std::vector<quint8> m_batchChanged;
+
+    // ---- Dirty cells ----
+    QVector<quint8> m_dirtyValues;                 // Instrument id -> columns whose text changed
+    QVector<quint8> m_dirtyColours;                // Instrument id -> columns whose colour changed
+    QVector<int> m_dirty;                          // Instruments with any dirty bit
+    QVector<AppliedTick> m_appliedTicks;           // Stream ticks behind the dirty cells
+    bool m_latencyTracking = true;
+
+    // ---- Viewport-limited mode ----
+    bool m_viewportLimited = false;
+    QVector<int> m_viewportInstruments;            // Instruments of the rows set by setViewportRows()
+    quint8 m_keyColumns = 0;                       // Quote columns the proxy sorts/filters by
+    QVector<quint8> m_isKeyDirty;                  // Instrument id -> in m_keyDirty
+    QVector<int> m_keyDirty;                       // Off-screen instruments whose key moved
+    qint64 m_lastKeyFlushNs = 0;
+
+    // ---- Flash ----
+    QTimer m_frameTimer;                           // Runs only while something flashes or is dirty (cells or keys)
+    qint64 m_frameNs = 0;                          // Clock of the current frame, shared by every data() call
+    qint64 m_flashNs = 150LL * 1000 * 1000;
+    bool m_flashFade = false;
+    QColor m_textColor;                            // Fade target
+    QVector<int> m_flashing;                       // Instruments with a live flash
+    QVector<bool> m_isFlashing;                    // Instrument id -> in m_flashing
 };
 
 #endif // MARKETWATCHMODEL_H
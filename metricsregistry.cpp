@@ -0,0 +1,61 @@
+/******************************************************************************
+ * MetricsRegistry.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Implementation of the process-wide feed counters.
+ ******************************************************************************/
+
+#include "metricsregistry.h"
+
+const qint64 MetricsRegistry::REST_BUCKET_MS[MetricsRegistry::REST_BUCKETS] = {
+    25, 50, 100, 250, 500, 1000, 2500, 5000, 10000
+};
+
+static const char *const CHANNEL_NAMES[MetricsRegistry::CHANNEL_COUNT] = {
+    "tickers", "trades", "books", "events", "other"
+};
+
+static const char *const REST_NAMES[MetricsRegistry::REST_COUNT] = {
+    "ticker", "tickers", "books", "trades", "candles", "time", "other"
+};
+
+MetricsRegistry &MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+const char *MetricsRegistry::channelName(int channel)
+{
+    return (channel >= 0 && channel < CHANNEL_COUNT) ? CHANNEL_NAMES[channel] : "";
+}
+
+const char *MetricsRegistry::restName(int rest)
+{
+    return (rest >= 0 && rest < REST_COUNT) ? REST_NAMES[rest] : "";
+}
+
+MetricsRegistry::Rest MetricsRegistry::restOf(const QString &path)
+{
+    const QString last = path.section('/', -1);
+    for (int i = 0; i < RestOther; ++i) {
+        if (last == QLatin1String(REST_NAMES[i])) return Rest(i);
+    }
+    return RestOther;
+}
+
+void MetricsRegistry::onRestReply(Rest endpoint, qint64 latencyMs, bool failed)
+{
+    RestStats &s = m_rest[endpoint];
+    s.calls.add();
+    if (failed) s.errors.add();
+    s.latencySumMs.add(quint64(qMax<qint64>(0, latencyMs)));
+    for (int i = 0; i < REST_BUCKETS; ++i) {
+        if (latencyMs <= REST_BUCKET_MS[i]) {
+            s.buckets[i].add();
+            break;
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/******************************************************************************
+ * MetricsRegistry.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Process-wide feed counters for the /metrics endpoint (MetricsServer).
+ *   - Every counter is one relaxed atomic add: safe to bump from the network
+ *     thread and the GUI thread, no lock anywhere on the hot path
+ *   - Counters only ever grow (Prometheus "counter" semantics); rates are
+ *     computed by the scraper
+ *   - REST latencies go into fixed millisecond buckets (cumulated at export)
+ ******************************************************************************/
+
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <QtGlobal>
+#include <QString>
+#include <array>
+#include <atomic>
+
+/**
+ * @class MetricsRegistry
+ * @brief Lock-free counters, grouped by what they describe.
+ */
+class MetricsRegistry
+{
+public:
+    enum Channel { ChannelTickers = 0, ChannelTrades, ChannelBooks, ChannelEvents, ChannelOther, CHANNEL_COUNT };
+    enum Rest { RestTicker = 0, RestTickers, RestBooks, RestTrades, RestCandles, RestTime, RestOther, REST_COUNT };
+
+    // Upper bounds (ms) of the REST latency buckets; slower replies only count in +Inf
+    static const int REST_BUCKETS = 9;
+    static const qint64 REST_BUCKET_MS[REST_BUCKETS];
+
+    /**
+     * @class Counter
+     * @brief Monotonic 64-bit counter.
+     */
+    class Counter
+    {
+    public:
+        void add(quint64 n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+        quint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<quint64> m_value{0};
+    };
+
+    /**
+     * @struct RestStats
+     * @brief Calls, failures and latency distribution of one REST endpoint.
+     */
+    struct RestStats {
+        Counter calls;
+        Counter errors;
+        Counter latencySumMs;
+        std::array<Counter, REST_BUCKETS> buckets;   // Per bucket, not cumulative
+    };
+
+    static MetricsRegistry &instance();
+
+    static const char *channelName(int channel);
+    static const char *restName(int rest);
+
+    /**
+     * Endpoint of a REST URL path ("/api/v5/market/books" -> RestBooks).
+     */
+    static Rest restOf(const QString &path);
+
+    void onFrame(Channel channel, quint64 bytes)
+    {
+        m_messages[channel].add();
+        m_bytes[channel].add(bytes);
+    }
+
+    void onRestReply(Rest endpoint, qint64 latencyMs, bool failed);
+
+    // ---- Feed (network thread) ----
+    Counter parseErrors;        ///< Frames the scanner rejected
+    Counter reconnects;         ///< Reconnect attempts over all shards
+    Counter outages;            ///< Disconnects / stale drops that started an outage
+    Counter staleDrops;         ///< Connections dropped for silence
+    Counter subscribeAcks;
+    Counter subscribeErrors;
+
+    // ---- GUI ----
+    Counter dataChanged;        ///< MarketWatchModel dataChanged emissions
+
+    const Counter &messages(int channel) const { return m_messages[channel]; }
+    const Counter &bytes(int channel) const { return m_bytes[channel]; }
+    const RestStats &rest(int endpoint) const { return m_rest[endpoint]; }
+
+private:
+    MetricsRegistry() = default;
+
+    std::array<Counter, CHANNEL_COUNT> m_messages;
+    std::array<Counter, CHANNEL_COUNT> m_bytes;
+    std::array<RestStats, REST_COUNT> m_rest;
+};
+
+#endif // METRICSREGISTRY_H
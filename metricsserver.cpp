@@ -0,0 +1,257 @@
+/******************************************************************************
+ * MetricsServer.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Implementation of the localhost Prometheus endpoint.
+ ******************************************************************************/
+
+#include "metricsserver.h"
+#include "metricsregistry.h"
+#include "latencyrecorder.h"
+#include "marketwatchdockwindow.h"
+#include <QDebug>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+// Lag sampling period, and how many samples make one rate/max window (1 s)
+static const int LAG_INTERVAL_MS = 100;
+static const int LAG_WINDOW_TICKS = 10;
+
+// A scrape request is a single GET line plus a few headers
+static const int MAX_REQUEST_BYTES = 8192;
+
+static void appendHeader(QByteArray &out, const char *name, const char *type, const char *help)
+{
+    out += "# HELP "; out += name; out += ' '; out += help; out += '\n';
+    out += "# TYPE "; out += name; out += ' '; out += type; out += '\n';
+}
+
+static void appendSample(QByteArray &out, const char *name, const QByteArray &labels, double value)
+{
+    out += name;
+    if (!labels.isEmpty()) {
+        out += '{'; out += labels; out += '}';
+    }
+    out += ' ';
+    out += QByteArray::number(value, 'g', 15);
+    out += '\n';
+}
+
+static void appendSample(QByteArray &out, const char *name, const QByteArray &labels, quint64 value)
+{
+    out += name;
+    if (!labels.isEmpty()) {
+        out += '{'; out += labels; out += '}';
+    }
+    out += ' ';
+    out += QByteArray::number(value);
+    out += '\n';
+}
+
+static QByteArray label(const char *key, const char *value)
+{
+    return QByteArray(key) + "=\"" + value + '"';
+}
+
+MetricsServer::MetricsServer(marketWatchDockWindow *dock, quint16 port, QObject *parent)
+    : QObject(parent),
+      m_dock(dock),
+      m_server(new QTcpServer(this)),
+      m_lagTimer(this)
+{
+    connect(m_server, &QTcpServer::newConnection, this, &MetricsServer::onNewConnection);
+    if (!m_server->listen(QHostAddress::LocalHost, port))
+        qWarning() << "Metrics endpoint: cannot listen on 127.0.0.1:" << port << m_server->errorString();
+    else
+        qDebug() << "Metrics endpoint on http://127.0.0.1:" << port << "/metrics";
+
+    m_lagTimer.setTimerType(Qt::PreciseTimer);
+    m_lagTimer.setInterval(LAG_INTERVAL_MS);
+    connect(&m_lagTimer, &QTimer::timeout, this, &MetricsServer::onLagTick);
+    m_lastLagTickNs = m_windowStartNs = LatencyRecorder::nowNs();
+    m_lagTimer.start();
+}
+
+bool MetricsServer::isListening() const
+{
+    return m_server->isListening();
+}
+
+void MetricsServer::onLagTick()
+{
+    const qint64 now = LatencyRecorder::nowNs();
+    const qint64 lateUs = qMax<qint64>(0, (now - m_lastLagTickNs) / 1000 - LAG_INTERVAL_MS * 1000);
+    m_lastLagTickNs = now;
+    m_lag.record(lateUs);
+    m_lagWindowMax = qMax(m_lagWindowMax, lateUs);
+
+    if (++m_lagTicks < LAG_WINDOW_TICKS) return;
+
+    const quint64 changed = MetricsRegistry::instance().dataChanged.value();
+    m_dataChangedPerSec = double(changed - m_dataChangedAtWindow) * 1e9 / double(qMax<qint64>(1, now - m_windowStartNs));
+    m_dataChangedAtWindow = changed;
+    m_windowStartNs = now;
+    m_lagLastWindowMax = m_lagWindowMax;
+    m_lagWindowMax = 0;
+    m_lagTicks = 0;
+}
+
+void MetricsServer::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, this, &MetricsServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_requests.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void MetricsServer::onReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket) return;
+
+    QByteArray &request = m_requests[socket];
+    request += socket->readAll();
+    if (request.size() > MAX_REQUEST_BYTES) {
+        respond(socket, "413 Payload Too Large", "text/plain", "request too large\n");
+        return;
+    }
+    if (!request.contains("\r\n\r\n") && !request.contains("\n\n")) return;   // Headers not complete yet
+
+    // "GET /metrics HTTP/1.1"
+    const QList<QByteArray> line = request.left(request.indexOf('\n')).trimmed().split(' ');
+    const QByteArray method = line.value(0);
+    const QByteArray path = line.value(1).split('?').value(0);
+
+    if (method != "GET")
+        respond(socket, "405 Method Not Allowed", "text/plain", "only GET is supported\n");
+    else if (path == "/metrics")
+        respond(socket, "200 OK", "text/plain; version=0.0.4; charset=utf-8", render());
+    else
+        respond(socket, "404 Not Found", "text/plain", "try /metrics\n");
+}
+
+void MetricsServer::respond(QTcpSocket *socket, const QByteArray &status, const QByteArray &contentType,
+                            const QByteArray &body)
+{
+    m_requests.remove(socket);
+    QByteArray response = "HTTP/1.1 " + status + "\r\n"
+                          "Content-Type: " + contentType + "\r\n"
+                          "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          "Connection: close\r\n\r\n";
+    response += body;
+    socket->write(response);
+    socket->disconnectFromHost();   // Flushes, then emits disconnected() -> deleteLater
+}
+
+QByteArray MetricsServer::render() const
+{
+    const MetricsRegistry &m = MetricsRegistry::instance();
+    QByteArray out;
+    out.reserve(16 * 1024);
+
+    // ---- Feed ----
+    appendHeader(out, "cmw_ws_messages_total", "counter", "WebSocket frames parsed, by channel.");
+    for (int c = 0; c < MetricsRegistry::CHANNEL_COUNT; ++c)
+        appendSample(out, "cmw_ws_messages_total", label("channel", MetricsRegistry::channelName(c)), m.messages(c).value());
+    appendHeader(out, "cmw_ws_bytes_total", "counter", "WebSocket payload bytes parsed, by channel.");
+    for (int c = 0; c < MetricsRegistry::CHANNEL_COUNT; ++c)
+        appendSample(out, "cmw_ws_bytes_total", label("channel", MetricsRegistry::channelName(c)), m.bytes(c).value());
+
+    appendHeader(out, "cmw_ws_parse_errors_total", "counter", "Frames rejected by the parser.");
+    appendSample(out, "cmw_ws_parse_errors_total", QByteArray(), m.parseErrors.value());
+    appendHeader(out, "cmw_ws_reconnects_total", "counter", "Reconnect attempts over all feed shards.");
+    appendSample(out, "cmw_ws_reconnects_total", QByteArray(), m.reconnects.value());
+    appendHeader(out, "cmw_ws_outages_total", "counter", "Feed shard outages (disconnect or stale drop).");
+    appendSample(out, "cmw_ws_outages_total", QByteArray(), m.outages.value());
+    appendHeader(out, "cmw_ws_stale_drops_total", "counter", "Connections dropped for silence.");
+    appendSample(out, "cmw_ws_stale_drops_total", QByteArray(), m.staleDrops.value());
+    appendHeader(out, "cmw_ws_subscribe_acks_total", "counter", "Channel subscriptions acknowledged.");
+    appendSample(out, "cmw_ws_subscribe_acks_total", QByteArray(), m.subscribeAcks.value());
+    appendHeader(out, "cmw_ws_subscribe_errors_total", "counter", "Subscribe requests rejected.");
+    appendSample(out, "cmw_ws_subscribe_errors_total", QByteArray(), m.subscribeErrors.value());
+
+    // ---- REST ----
+    appendHeader(out, "cmw_rest_requests_total", "counter", "REST calls completed, by endpoint.");
+    for (int r = 0; r < MetricsRegistry::REST_COUNT; ++r)
+        appendSample(out, "cmw_rest_requests_total", label("endpoint", MetricsRegistry::restName(r)), m.rest(r).calls.value());
+    appendHeader(out, "cmw_rest_errors_total", "counter", "REST calls that failed, by endpoint.");
+    for (int r = 0; r < MetricsRegistry::REST_COUNT; ++r)
+        appendSample(out, "cmw_rest_errors_total", label("endpoint", MetricsRegistry::restName(r)), m.rest(r).errors.value());
+
+    appendHeader(out, "cmw_rest_latency_seconds", "histogram", "REST round-trip time, by endpoint.");
+    for (int r = 0; r < MetricsRegistry::REST_COUNT; ++r) {
+        const MetricsRegistry::RestStats &s = m.rest(r);
+        const QByteArray endpoint = label("endpoint", MetricsRegistry::restName(r));
+        quint64 cumulative = 0;
+        for (int b = 0; b < MetricsRegistry::REST_BUCKETS; ++b) {
+            cumulative += s.buckets[b].value();
+            const QByteArray le = QByteArray::number(MetricsRegistry::REST_BUCKET_MS[b] / 1000.0, 'g', 6);
+            appendSample(out, "cmw_rest_latency_seconds_bucket", endpoint + ",le=\"" + le + '"', cumulative);
+        }
+        const quint64 calls = s.calls.value();
+        appendSample(out, "cmw_rest_latency_seconds_bucket", endpoint + ",le=\"+Inf\"", calls);
+        appendSample(out, "cmw_rest_latency_seconds_sum", endpoint, s.latencySumMs.value() / 1000.0);
+        appendSample(out, "cmw_rest_latency_seconds_count", endpoint, calls);
+    }
+
+    // ---- Market Watch (read at scrape time) ----
+    if (m_dock) {
+        appendHeader(out, "cmw_marketwatch_rows", "gauge", "Rows in the Market Watch model.");
+        appendSample(out, "cmw_marketwatch_rows", QByteArray(), quint64(m_dock->model->rowCount()));
+        appendHeader(out, "cmw_proxy_row_moves_total", "counter", "Rows the sorted view repositioned after a key change.");
+        appendSample(out, "cmw_proxy_row_moves_total", QByteArray(), m_dock->proxy->rowMoves());
+
+        const TickConflator::Stats &cs = m_dock->conflator->stats();
+        appendHeader(out, "cmw_conflator_ticks_in_total", "counter", "Ticks handed to the conflator.");
+        appendSample(out, "cmw_conflator_ticks_in_total", QByteArray(), cs.ticksIn);
+        appendHeader(out, "cmw_conflator_ticks_out_total", "counter", "Ticks released to the model.");
+        appendSample(out, "cmw_conflator_ticks_out_total", QByteArray(), cs.ticksOut);
+
+        // Running timers in the GUI object tree (network-thread timers are not walked)
+        quint64 activeTimers = 0;
+        for (const QTimer *timer : m_dock->window()->findChildren<QTimer *>()) {
+            if (timer->isActive()) ++activeTimers;
+        }
+        appendHeader(out, "cmw_qtimers", "gauge", "Active QTimers under the main window.");
+        appendSample(out, "cmw_qtimers", QByteArray(), activeTimers);
+    }
+    appendHeader(out, "cmw_model_datachanged_total", "counter", "dataChanged signals emitted by the Market Watch model.");
+    appendSample(out, "cmw_model_datachanged_total", QByteArray(), m.dataChanged.value());
+    appendHeader(out, "cmw_model_datachanged_per_second", "gauge", "dataChanged rate over the last second.");
+    appendSample(out, "cmw_model_datachanged_per_second", QByteArray(), m_dataChangedPerSec);
+
+    // ---- Event loop ----
+    appendHeader(out, "cmw_event_loop_lag_seconds", "summary", "How late a 100 ms GUI timer fires.");
+    for (double q : {50.0, 90.0, 99.0, 99.9})
+        appendSample(out, "cmw_event_loop_lag_seconds", "quantile=\"" + QByteArray::number(q / 100.0) + '"', m_lag.valueAt(q) / 1e6);
+    appendSample(out, "cmw_event_loop_lag_seconds_sum", QByteArray(), m_lag.mean() * double(m_lag.count()) / 1e6);
+    appendSample(out, "cmw_event_loop_lag_seconds_count", QByteArray(), m_lag.count());
+    appendHeader(out, "cmw_event_loop_lag_max_seconds", "gauge", "Worst event-loop lag over the last second.");
+    appendSample(out, "cmw_event_loop_lag_max_seconds", QByteArray(), qMax(m_lagWindowMax, m_lagLastWindowMax) / 1e6);
+
+    // ---- Ticker latency stages (LatencyRecorder) ----
+    const LatencyRecorder &lr = LatencyRecorder::instance();
+    appendHeader(out, "cmw_tick_latency_seconds", "summary", "Ticker latency per stage, exchange ts to painted cell.");
+    for (int i = 0; i < LatencyRecorder::STAGE_COUNT; ++i) {
+        const LatencyRecorder::Summary s = lr.stage(LatencyRecorder::Stage(i));
+        const QByteArray stage = label("stage", LatencyRecorder::stageName(i).toLatin1().constData());
+        appendSample(out, "cmw_tick_latency_seconds", stage + ",quantile=\"0.5\"", s.p50 / 1e6);
+        appendSample(out, "cmw_tick_latency_seconds", stage + ",quantile=\"0.9\"", s.p90 / 1e6);
+        appendSample(out, "cmw_tick_latency_seconds", stage + ",quantile=\"0.99\"", s.p99 / 1e6);
+        appendSample(out, "cmw_tick_latency_seconds", stage + ",quantile=\"0.999\"", s.p999 / 1e6);
+        appendSample(out, "cmw_tick_latency_seconds_sum", stage, s.mean * double(s.count) / 1e6);
+        appendSample(out, "cmw_tick_latency_seconds_count", stage, s.count);
+    }
+    appendHeader(out, "cmw_exchange_clock_offset_seconds", "gauge", "Exchange clock minus local clock.");
+    appendSample(out, "cmw_exchange_clock_offset_seconds", QByteArray(), lr.clockOffsetMs() / 1000.0);
+    appendHeader(out, "cmw_exchange_clock_rtt_seconds", "gauge", "Round-trip of the clock offset sample, -0.001 = not synced.");
+    appendSample(out, "cmw_exchange_clock_rtt_seconds", QByteArray(), lr.clockRttMs() / 1000.0);
+
+    return out;
+}
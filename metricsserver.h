@@ -0,0 +1,77 @@
+/******************************************************************************
+ * MetricsServer.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Embedded HTTP endpoint serving GET /metrics in the Prometheus text format,
+ *   bound to localhost only.
+ *   - Feed counters come from MetricsRegistry (lock-free, bumped on the hot path)
+ *   - Gauges (rows, QTimers, conflator, latency stages) are read when scraped,
+ *     so an idle scraper costs nothing
+ *   - Event-loop lag: a 100 ms precise timer measures how late it fires
+ *   GUI thread only.
+ ******************************************************************************/
+
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QTimer>
+#include "latencyhistogram.h"
+
+class QTcpServer;
+class QTcpSocket;
+class marketWatchDockWindow;
+
+/**
+ * @class MetricsServer
+ * @brief One-shot HTTP/1.0 responder for Prometheus scrapes.
+ */
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @param dock Market Watch whose model, conflator and timers are reported
+     * @param port Listening port on 127.0.0.1
+     */
+    MetricsServer(marketWatchDockWindow *dock, quint16 port, QObject *parent = nullptr);
+
+    bool isListening() const;
+
+    /**
+     * Whole exposition body, as returned to a scrape.
+     */
+    QByteArray render() const;
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onLagTick();
+
+private:
+    void respond(QTcpSocket *socket, const QByteArray &status, const QByteArray &contentType, const QByteArray &body);
+
+    marketWatchDockWindow *m_dock;
+    QTcpServer *m_server;
+    QHash<QTcpSocket *, QByteArray> m_requests;   // Partial request headers per client
+
+    // ---- Event-loop lag ----
+    QTimer m_lagTimer;
+    qint64 m_lastLagTickNs = 0;
+    LatencyHistogram<7> m_lag;                    // us late, since start
+    qint64 m_lagWindowMax = 0;                    // Worst in the running window
+    qint64 m_lagLastWindowMax = 0;                // Worst in the previous complete window
+    int m_lagTicks = 0;
+
+    // ---- dataChanged rate, sampled once per lag window ----
+    quint64 m_dataChangedAtWindow = 0;
+    qint64 m_windowStartNs = 0;
+    double m_dataChangedPerSec = 0.0;
+};
+
+#endif // METRICSSERVER_H
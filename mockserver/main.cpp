@@ -0,0 +1,68 @@
+/****************************************************************************
+ * okxmockserver - Local mock of the OKX public API
+ *
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Console entry point for the mock exchange used to load-test CryptoMW
+ *   offline.
+ *   - Parses the market shape (instruments, rate, burst, book depth)
+ *   - Starts the WebSocket and REST listeners (loopback unless --bind)
+ *   - Prints the Feed/* settings that point the client at it
+ ****************************************************************************/
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include "okxmockserver.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("okxmockserver");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Synthetic OKX v5 public WebSocket + REST endpoints");
+    parser.addHelpOption();
+    const QCommandLineOption bind("bind", "Address to listen on (default 127.0.0.1; 0.0.0.0 = all interfaces).", "address", "127.0.0.1");
+    const QCommandLineOption wsPort("ws-port", "WebSocket port (default 8080).", "port", "8080");
+    const QCommandLineOption restPort("rest-port", "REST port (default 8081).", "port", "8081");
+    const QCommandLineOption instruments("instruments", "Synthetic MOCKnnnn-USDT instruments (default 500).", "count", "500");
+    const QCommandLineOption rate("rate", "Pushes per second over all connections (default 10000).", "msgs", "10000");
+    const QCommandLineOption burst("burst", "Send each second's pushes in its first 1/N (default 1 = even).", "factor", "1");
+    const QCommandLineOption bookDepth("book-depth", "Levels per side on the books channel (default 400).", "levels", "400");
+    const QCommandLineOption seed("seed", "Random seed (default 1).", "seed", "1");
+    parser.addOptions({bind, wsPort, restPort, instruments, rate, burst, bookDepth, seed});
+    parser.process(app);
+
+    MockServerConfig config;
+    if (!config.bind.setAddress(parser.value(bind))) {
+        qWarning().noquote() << "Invalid --bind address" << parser.value(bind);
+        return 1;
+    }
+    config.wsPort = static_cast<quint16>(parser.value(wsPort).toUInt());
+    config.restPort = static_cast<quint16>(parser.value(restPort).toUInt());
+    config.instruments = qMax(0, parser.value(instruments).toInt());
+    config.rate = qMax(0, parser.value(rate).toInt());
+    config.burst = qMax(1.0, parser.value(burst).toDouble());
+    config.bookDepth = qBound(1, parser.value(bookDepth).toInt(), 400);
+    config.seed = parser.value(seed).toUInt();
+
+    OkxMockServer server(config);
+    if (!server.listen())
+        return 1;
+
+    qDebug().noquote() << QString("Mock OKX: %1 instruments, %2 msgs/s, burst x%3")
+                              .arg(config.instruments).arg(config.rate).arg(config.burst);
+    // Clients reach a wildcard bind through loopback; IPv6 hosts need brackets in a URL
+    QString host = config.bind.toString();
+    if (config.bind == QHostAddress::Any || config.bind == QHostAddress::AnyIPv4 || config.bind == QHostAddress::AnyIPv6)
+        host = QStringLiteral("127.0.0.1");
+    else if (config.bind.protocol() == QAbstractSocket::IPv6Protocol)
+        host = "[" + host + "]";
+    qDebug().noquote() << QString("Client settings: Feed/wsUrl=ws://%1:%2/ws/v5/public  Feed/restUrl=http://%1:%3")
+                              .arg(host).arg(config.wsPort).arg(config.restPort);
+    return app.exec();
+}
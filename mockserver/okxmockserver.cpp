@@ -0,0 +1,807 @@
+/******************************************************************************
+ * OkxMockServer.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Implementation of the mock OKX exchange.
+ ******************************************************************************/
+
+#include "okxmockserver.h"
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QDebug>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+// Sizes are sent with 4 fraction digits (lot = 0.0001)
+static const int SIZE_DECIMALS = 4;
+// OKX checksums cover the top 25 levels of each side
+static const int CHECKSUM_LEVELS = 25;
+// Book updates only touch levels this close to the inside
+static const int ACTIVE_LEVELS = 10;
+// Upper bound of pushes per generator tick, so a stalled loop cannot spiral
+static const int MAX_PUSHES_PER_TICK = 5000;
+// Requests larger than this without a header terminator are dropped
+static const int MAX_REQUEST_BYTES = 16 * 1024;
+
+static quint32 crc32(const char *data, int length)
+{
+    static const auto table = []() {
+        std::array<quint32, 256> t{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    quint32 crc = 0xFFFFFFFFu;
+    for (int i = 0; i < length; ++i)
+        crc = table[(crc ^ static_cast<quint8>(data[i])) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static qint64 unitOf(int n)
+{
+    qint64 v = 1;
+    while (n-- > 0) v *= 10;
+    return v;
+}
+
+// mantissa/decimals as exchange text with a fixed number of fraction digits ("0.0500")
+static void appendDecimal(QByteArray &out, qint64 mantissa, int decimals)
+{
+    if (mantissa < 0) {
+        out += '-';
+        mantissa = -mantissa;
+    }
+    const qint64 unit = unitOf(decimals);
+    out += QByteArray::number(mantissa / unit);
+    if (decimals > 0) {
+        const QByteArray fraction = QByteArray::number(mantissa % unit);
+        out += '.';
+        out += QByteArray(decimals - fraction.size(), '0');
+        out += fraction;
+    }
+}
+
+static void appendQuoted(QByteArray &out, qint64 mantissa, int decimals)
+{
+    out += '"';
+    appendDecimal(out, mantissa, decimals);
+    out += '"';
+}
+
+// One wire level: ["price","size","0","orders"]
+static void appendLevel(QByteArray &out, bool first, qint64 price, int priceDecimals, qint64 size)
+{
+    if (!first) out += ',';
+    out += '[';
+    appendQuoted(out, price, priceDecimals);
+    out += ',';
+    appendQuoted(out, size, SIZE_DECIMALS);
+    out += ",\"0\",\"";
+    out += QByteArray::number(size == 0 ? 0 : 1 + size % 17);
+    out += "\"]";
+}
+
+template <typename Side>
+static void appendSide(QByteArray &out, const Side &side, int depth, int priceDecimals)
+{
+    out += '[';
+    int n = 0;
+    for (auto it = side.cbegin(); it != side.cend() && n < depth; ++it, ++n)
+        appendLevel(out, n == 0, it->first, priceDecimals, it->second);
+    out += ']';
+}
+
+// Same string and CRC as the client (OrderBookEngine::checksum): bid:size:ask:size...
+template <typename Bids, typename Asks>
+static qint32 bookChecksum(const Bids &bids, const Asks &asks, int priceDecimals)
+{
+    QByteArray text;
+    auto b = bids.cbegin();
+    auto a = asks.cbegin();
+    for (int i = 0; i < CHECKSUM_LEVELS; ++i) {
+        if (b != bids.cend()) {
+            if (!text.isEmpty()) text += ':';
+            appendDecimal(text, b->first, priceDecimals);
+            text += ':';
+            appendDecimal(text, b->second, SIZE_DECIMALS);
+            ++b;
+        }
+        if (a != asks.cend()) {
+            if (!text.isEmpty()) text += ':';
+            appendDecimal(text, a->first, priceDecimals);
+            text += ':';
+            appendDecimal(text, a->second, SIZE_DECIMALS);
+            ++a;
+        }
+    }
+    return static_cast<qint32>(crc32(text.constData(), text.size()));
+}
+
+static qint64 randomSize(QRandomGenerator &rng)
+{
+    return 1 + rng.bounded(200000);   // Up to 20 units
+}
+
+// One change near the inside of a side: a new level, a pulled level or a new size.
+// bound is the best opposite price; the side never crosses it.
+template <typename Side>
+static void mutateSide(Side &side, qint64 bound, bool isBid, int depth, int priceDecimals,
+                       QRandomGenerator &rng, QByteArray &changes)
+{
+    const int roll = rng.bounded(100);
+    const int active = qMin<int>(ACTIVE_LEVELS, int(side.size()));
+
+    if (side.empty() || (int(side.size()) < depth && roll < 40)) {
+        const qint64 best = side.empty() ? (isBid ? bound - 1 : bound + 1) : side.cbegin()->first;
+        qint64 price = isBid ? best + 1 - rng.bounded(ACTIVE_LEVELS * 2) : best - 1 + rng.bounded(ACTIVE_LEVELS * 2);
+        if (isBid ? price >= bound : price <= bound) price = isBid ? bound - 1 : bound + 1;
+        if (price <= 0) return;
+        qint64 &size = side[price];
+        size = randomSize(rng);
+        appendLevel(changes, changes.isEmpty(), price, priceDecimals, size);
+    } else if (roll < 55 && side.size() > 1) {
+        auto it = side.begin();
+        std::advance(it, rng.bounded(active));
+        appendLevel(changes, changes.isEmpty(), it->first, priceDecimals, 0);
+        side.erase(it);
+    } else {
+        auto it = side.begin();
+        std::advance(it, rng.bounded(active));
+        it->second = randomSize(rng);
+        appendLevel(changes, changes.isEmpty(), it->first, priceDecimals, it->second);
+    }
+}
+
+// Same derivation as the client's bulk seed: BTC-USDT SPOT, BTC-USDT-SWAP SWAP, BTC-USD-250328 FUTURES
+static QString instTypeOf(const QString &instId)
+{
+    const QStringList parts = instId.split('-');
+    if (parts.size() == 2) return QStringLiteral("SPOT");
+    if (parts.size() == 3 && parts.last() == QLatin1String("SWAP")) return QStringLiteral("SWAP");
+    if (parts.size() == 3) return QStringLiteral("FUTURES");
+    return QStringLiteral("OPTION");
+}
+
+// "1m" / "4H" / "1Dutc" -> ms, 0 if unknown
+static qint64 barMs(const QString &bar)
+{
+    int i = 0;
+    while (i < bar.size() && bar.at(i).isDigit()) ++i;
+    const qint64 n = bar.left(i).toLongLong();
+    if (n <= 0 || i >= bar.size()) return 0;
+    switch (bar.at(i).unicode()) {
+    case 's': return n * 1000;
+    case 'm': return n * 60 * 1000;
+    case 'H': return n * 3600 * 1000;
+    case 'D': return n * 86400 * 1000;
+    case 'W': return n * 7 * 86400 * 1000;
+    }
+    return 0;
+}
+
+static QByteArray statusLine(int status)
+{
+    switch (status) {
+    case 200: return "200 OK";
+    case 400: return "400 Bad Request";
+    case 404: return "404 Not Found";
+    case 405: return "405 Method Not Allowed";
+    }
+    return QByteArray::number(status);
+}
+
+OkxMockServer::OkxMockServer(const MockServerConfig &config, QObject *parent)
+    : QObject(parent),
+      m_config(config),
+      m_wsServer(QStringLiteral("okxmockserver"), QWebSocketServer::NonSecureMode, this),
+      m_httpServer(this),
+      m_generateTimer(this),
+      m_statsTimer(this),
+      m_rng(config.seed)
+{
+    m_instruments.reserve(config.instruments);
+    for (int i = 1; i <= config.instruments; ++i)
+        addInstrument(QString("MOCK%1-USDT").arg(i, 4, 10, QLatin1Char('0')));
+
+    connect(&m_wsServer, &QWebSocketServer::newConnection, this, &OkxMockServer::onNewWsConnection);
+    connect(&m_httpServer, &QTcpServer::newConnection, this, &OkxMockServer::onNewHttpConnection);
+
+    m_generateTimer.setInterval(1);
+    m_generateTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_generateTimer, &QTimer::timeout, this, &OkxMockServer::onGenerateTimeout);
+    m_statsTimer.setInterval(1000);
+    connect(&m_statsTimer, &QTimer::timeout, this, &OkxMockServer::onStatsTimeout);
+}
+
+OkxMockServer::~OkxMockServer()
+{
+    const QVector<Client> clients = std::exchange(m_clients, QVector<Client>());
+    for (const Client &c : clients) {
+        c.socket->disconnect(this);
+        delete c.socket;
+    }
+}
+
+bool OkxMockServer::listen()
+{
+    if (!m_wsServer.listen(m_config.bind, m_config.wsPort)) {
+        qWarning() << "WebSocket" << m_config.bind.toString() << "port" << m_config.wsPort << ":" << m_wsServer.errorString();
+        return false;
+    }
+    if (!m_httpServer.listen(m_config.bind, m_config.restPort)) {
+        qWarning() << "REST" << m_config.bind.toString() << "port" << m_config.restPort << ":" << m_httpServer.errorString();
+        return false;
+    }
+    m_clock.start();
+    m_generateTimer.start();
+    m_statsTimer.start();
+    return true;
+}
+
+// --- Universe ---
+
+int OkxMockServer::instrumentFor(const QString &instId)
+{
+    auto it = m_indexOf.constFind(instId);
+    if (it != m_indexOf.cend()) return it.value();
+    addInstrument(instId);
+    return m_instruments.size() - 1;
+}
+
+void OkxMockServer::addInstrument(const QString &instId)
+{
+    Instrument inst;
+    inst.instId = instId;
+    inst.wire = instId.toLatin1();
+
+    // Log-uniform start price between 0.05 and 60000; tick size keeps 3-5 significant digits
+    const double price = std::exp(std::log(0.05) + m_rng.generateDouble() * (std::log(60000.0) - std::log(0.05)));
+    inst.priceDecimals = price >= 1000 ? 1 : price >= 10 ? 2 : price >= 0.1 ? 4 : 6;
+    inst.last = qMax<qint64>(1000, qRound64(price * double(unitOf(inst.priceDecimals))));
+    inst.open24h = inst.high24h = inst.low24h = inst.last;
+    inst.vol24h = qint64(m_rng.bounded(1000000)) * 100;
+
+    m_indexOf.insert(instId, m_instruments.size());
+    m_instruments.append(inst);
+}
+
+void OkxMockServer::walk(Instrument &inst, int maxTicks)
+{
+    inst.last = qMax<qint64>(1000, inst.last + m_rng.bounded(-maxTicks, maxTicks + 1));
+    inst.high24h = qMax(inst.high24h, inst.last);
+    inst.low24h = qMin(inst.low24h, inst.last);
+}
+
+// --- WebSocket ---
+
+void OkxMockServer::onNewWsConnection()
+{
+    while (m_wsServer.hasPendingConnections()) {
+        QWebSocket *socket = m_wsServer.nextPendingConnection();
+        connect(socket, &QWebSocket::textMessageReceived, this, &OkxMockServer::onWsTextMessage);
+        // Queued: a failed send inside the push loop must not remove clients under it
+        connect(socket, &QWebSocket::disconnected, this, &OkxMockServer::onWsDisconnected, Qt::QueuedConnection);
+        Client client;
+        client.socket = socket;
+        m_clients.append(client);
+        qDebug() << "WebSocket client" << socket->peerAddress().toString() << "connected";
+    }
+}
+
+void OkxMockServer::onWsDisconnected()
+{
+    QWebSocket *socket = qobject_cast<QWebSocket*>(sender());
+    for (int i = 0; i < m_clients.size(); ++i) {
+        if (m_clients.at(i).socket != socket) continue;
+        m_streamCount -= int(m_clients.at(i).subs.size());
+        qDebug() << "WebSocket client disconnected after" << m_clients.at(i).sent << "pushes";
+        m_clients.removeAt(i);
+        break;
+    }
+    if (socket) socket->deleteLater();
+}
+
+OkxMockServer::Client *OkxMockServer::clientOf(QWebSocket *socket)
+{
+    for (Client &c : m_clients) {
+        if (c.socket == socket) return &c;
+    }
+    return nullptr;
+}
+
+void OkxMockServer::onWsTextMessage(const QString &message)
+{
+    Client *client = clientOf(qobject_cast<QWebSocket*>(sender()));
+    if (!client) return;
+    if (message == QLatin1String("ping")) {
+        client->socket->sendTextMessage(QStringLiteral("pong"));
+        return;
+    }
+    handleOp(*client, message);
+}
+
+void OkxMockServer::handleOp(Client &client, const QString &message)
+{
+    const QJsonObject op = QJsonDocument::fromJson(message.toUtf8()).object();
+    const QString name = op.value("op").toString();
+    const QString id = op.value("id").toString();
+
+    auto reply = [&client, &id](QJsonObject event) {
+        if (!id.isEmpty()) event.insert("id", id);
+        event.insert("connId", "mock");
+        client.socket->sendTextMessage(QString::fromUtf8(QJsonDocument(event).toJson(QJsonDocument::Compact)));
+    };
+
+    if (name != QLatin1String("subscribe") && name != QLatin1String("unsubscribe")) {
+        reply(QJsonObject{{"event", "error"}, {"code", "60012"}, {"msg", "Invalid request: " + message}});
+        return;
+    }
+
+    const QJsonArray args = op.value("args").toArray();
+    for (const QJsonValue &v : args) {
+        const QJsonObject arg = v.toObject();
+        const QString channel = arg.value("channel").toString();
+        const QString instId = arg.value("instId").toString();
+        const QJsonObject ackArg{{"channel", channel}, {"instId", instId}};
+
+        if (name == QLatin1String("unsubscribe")) {
+            unsubscribe(client, channel, instId);
+            reply(QJsonObject{{"event", "unsubscribe"}, {"arg", ackArg}});
+            continue;
+        }
+
+        Subscription *sub = subscribe(client, channel, instId);
+        if (!sub) {
+            reply(QJsonObject{{"event", "error"}, {"code", "60018"},
+                              {"msg", QString("Wrong URL or channel:%1,instId:%2 doesn't exist.").arg(channel, instId)}});
+            continue;
+        }
+        reply(QJsonObject{{"event", "subscribe"}, {"arg", ackArg}});
+        if (sub->incremental)
+            push(client, *sub, true);   // Books start with a snapshot right after the ack
+    }
+}
+
+OkxMockServer::Subscription *OkxMockServer::subscribe(Client &client, const QString &channel, const QString &instId)
+{
+    if (instId.isEmpty()) return nullptr;
+
+    Subscription sub;
+    sub.name = channel.toLatin1();
+    if (channel == QLatin1String("tickers")) {
+        sub.channel = Channel::Tickers;
+    } else if (channel == QLatin1String("trades")) {
+        sub.channel = Channel::Trades;
+    } else if (channel == QLatin1String("books") || channel == QLatin1String("books-l2-tbt")) {
+        sub.channel = Channel::Book;
+        sub.depth = channel == QLatin1String("books") ? qBound(1, m_config.bookDepth, 400) : 400;
+        sub.incremental = true;
+    } else if (channel == QLatin1String("books50-l2-tbt")) {
+        sub.channel = Channel::Book;
+        sub.depth = 50;
+        sub.incremental = true;
+    } else if (channel == QLatin1String("books5") || channel == QLatin1String("bbo-tbt")) {
+        sub.channel = Channel::Book;
+        sub.depth = channel == QLatin1String("books5") ? 5 : 1;
+    } else {
+        return nullptr;
+    }
+    sub.instrument = instrumentFor(instId);
+
+    for (Subscription &s : client.subs) {
+        if (s.name == sub.name && s.instrument == sub.instrument) {
+            if (s.incremental) fillBook(s.book, m_instruments[s.instrument], s.depth);
+            return &s;   // Re-subscribe: acked again, books restart from a snapshot
+        }
+    }
+    if (sub.incremental) {
+        fillBook(sub.book, m_instruments[sub.instrument], sub.depth);
+        sub.book.seqId = 1000 + m_rng.bounded(1000000);
+    }
+    client.subs.push_back(std::move(sub));
+    ++m_streamCount;
+    return &client.subs.back();
+}
+
+void OkxMockServer::unsubscribe(Client &client, const QString &channel, const QString &instId)
+{
+    auto it = m_indexOf.constFind(instId);
+    if (it == m_indexOf.cend()) return;
+    const QByteArray name = channel.toLatin1();
+    for (auto s = client.subs.begin(); s != client.subs.end(); ++s) {
+        if (s->name == name && s->instrument == it.value()) {
+            client.subs.erase(s);
+            --m_streamCount;
+            return;
+        }
+    }
+}
+
+void OkxMockServer::onGenerateTimeout()
+{
+    const qint64 now = m_clock.elapsed();
+    if (now / 1000 != m_second) {
+        m_second = now / 1000;
+        m_sentThisSecond = 0;
+    }
+    if (m_streamCount == 0) return;
+
+    // Each second's budget is released over its first 1000/burst ms
+    const double window = 1000.0 / qMax(1.0, m_config.burst);
+    const double phase = qMin(1.0, double(now % 1000 + 1) / window);
+    const int due = qMin(MAX_PUSHES_PER_TICK, int(m_config.rate * phase) - m_sentThisSecond);
+
+    for (int i = 0; i < due; ++i) {
+        // Uniform over every stream of every connection
+        int pick = m_rng.bounded(m_streamCount);
+        for (Client &c : m_clients) {
+            if (pick < int(c.subs.size())) {
+                push(c, c.subs[pick]);
+                break;
+            }
+            pick -= int(c.subs.size());
+        }
+    }
+    if (due > 0) m_sentThisSecond += due;
+}
+
+void OkxMockServer::push(Client &client, Subscription &sub, bool snapshot)
+{
+    const qint64 ts = QDateTime::currentMSecsSinceEpoch();
+    Instrument &inst = m_instruments[sub.instrument];
+
+    QByteArray &f = m_frame;
+    f.clear();
+    f += "{\"arg\":{\"channel\":\"";
+    f += sub.name;
+    f += "\",\"instId\":\"";
+    f += inst.wire;
+    f += "\"}";
+
+    switch (sub.channel) {
+    case Channel::Tickers:
+        walk(inst, 3);
+        f += ",\"data\":[";
+        appendTicker(f, inst, ts);
+        break;
+    case Channel::Trades:
+        f += ",\"data\":[";
+        appendTrade(f, inst, ts);
+        break;
+    case Channel::Book:
+        if (snapshot) {
+            f += ",\"action\":\"snapshot\",\"data\":[";
+            appendBookData(f, sub.book, inst, sub.depth, ts, true, -1);
+        } else if (sub.incremental) {
+            f += ",\"action\":\"update\",\"data\":[";
+            appendBookUpdate(f, sub.book, inst, sub.depth, ts);
+        } else {
+            // books5 / bbo-tbt: every push is the whole top of book around the last price
+            walk(inst, 1);
+            fillBook(sub.book, inst, sub.depth);
+            ++sub.book.seqId;
+            f += ",\"data\":[";
+            appendBookData(f, sub.book, inst, sub.depth, ts, false, -1);
+        }
+        break;
+    }
+    f += "]}";
+    send(client, f);
+}
+
+void OkxMockServer::send(Client &client, const QByteArray &frame)
+{
+    client.socket->sendTextMessage(QString::fromLatin1(frame));
+    ++client.sent;
+    ++m_pushed;
+}
+
+// --- Message bodies ---
+
+void OkxMockServer::appendTicker(QByteArray &out, const Instrument &inst, qint64 ts) const
+{
+    const int d = inst.priceDecimals;
+    out += "{\"instType\":\"";
+    out += instTypeOf(inst.instId).toLatin1();
+    out += "\",\"instId\":\"";
+    out += inst.wire;
+    out += "\",\"last\":";
+    appendQuoted(out, inst.last, d);
+    out += ",\"lastSz\":";
+    appendQuoted(out, 1 + (inst.last * 7919) % 50000, SIZE_DECIMALS);
+    out += ",\"askPx\":";
+    appendQuoted(out, inst.last + 1, d);
+    out += ",\"askSz\":";
+    appendQuoted(out, 1 + (inst.last * 104729) % 200000, SIZE_DECIMALS);
+    out += ",\"bidPx\":";
+    appendQuoted(out, inst.last - 1, d);
+    out += ",\"bidSz\":";
+    appendQuoted(out, 1 + (inst.last * 1299709) % 200000, SIZE_DECIMALS);
+    out += ",\"open24h\":";
+    appendQuoted(out, inst.open24h, d);
+    out += ",\"high24h\":";
+    appendQuoted(out, inst.high24h, d);
+    out += ",\"low24h\":";
+    appendQuoted(out, inst.low24h, d);
+    out += ",\"volCcy24h\":\"";
+    out += QByteArray::number(double(inst.vol24h) / double(unitOf(SIZE_DECIMALS))
+                              * double(inst.last) / double(unitOf(d)), 'f', 2);
+    out += "\",\"vol24h\":";
+    appendQuoted(out, inst.vol24h, SIZE_DECIMALS);
+    out += ",\"sodUtc0\":";
+    appendQuoted(out, inst.open24h, d);
+    out += ",\"sodUtc8\":";
+    appendQuoted(out, inst.open24h, d);
+    out += ",\"ts\":\"";
+    out += QByteArray::number(ts);
+    out += "\"}";
+}
+
+void OkxMockServer::appendTrade(QByteArray &out, Instrument &inst, qint64 ts)
+{
+    walk(inst, 2);
+    const qint64 size = 1 + m_rng.bounded(50000);
+    inst.vol24h += size;
+
+    out += "{\"instId\":\"";
+    out += inst.wire;
+    out += "\",\"tradeId\":\"";
+    out += QByteArray::number(inst.nextTradeId++);
+    out += "\",\"px\":";
+    appendQuoted(out, inst.last, inst.priceDecimals);
+    out += ",\"sz\":";
+    appendQuoted(out, size, SIZE_DECIMALS);
+    out += m_rng.bounded(2) ? ",\"side\":\"buy\"" : ",\"side\":\"sell\"";
+    out += ",\"ts\":\"";
+    out += QByteArray::number(ts);
+    out += "\"}";
+}
+
+void OkxMockServer::fillBook(Book &book, const Instrument &inst, int depth)
+{
+    book.bids.clear();
+    book.asks.clear();
+    for (int k = 0; k < depth; ++k) {
+        if (inst.last - 1 - k > 0)
+            book.bids.emplace(inst.last - 1 - k, randomSize(m_rng));
+        book.asks.emplace(inst.last + 1 + k, randomSize(m_rng));
+    }
+}
+
+void OkxMockServer::appendBookData(QByteArray &out, const Book &book, const Instrument &inst, int depth,
+                                   qint64 ts, bool withChecksum, qint64 prevSeqId) const
+{
+    out += "{\"asks\":";
+    appendSide(out, book.asks, depth, inst.priceDecimals);
+    out += ",\"bids\":";
+    appendSide(out, book.bids, depth, inst.priceDecimals);
+    out += ",\"ts\":\"";
+    out += QByteArray::number(ts);
+    out += '"';
+    if (withChecksum) {
+        out += ",\"checksum\":";
+        out += QByteArray::number(bookChecksum(book.bids, book.asks, inst.priceDecimals));
+        out += ",\"prevSeqId\":";
+        out += QByteArray::number(prevSeqId);
+    }
+    out += ",\"seqId\":";
+    out += QByteArray::number(book.seqId);
+    out += '}';
+}
+
+void OkxMockServer::appendBookUpdate(QByteArray &out, Book &book, const Instrument &inst, int depth, qint64 ts)
+{
+    // One change on one or both sides; a level never appears twice in an update
+    const int sides = 1 + m_rng.bounded(3);   // 1 = bids, 2 = asks, 3 = both
+    QByteArray bids, asks;
+    if (sides & 1) {
+        const qint64 bound = book.asks.empty() ? std::numeric_limits<qint64>::max() : book.asks.cbegin()->first;
+        mutateSide(book.bids, bound, true, depth, inst.priceDecimals, m_rng, bids);
+    }
+    if (sides & 2) {
+        const qint64 bound = book.bids.empty() ? 0 : book.bids.cbegin()->first;
+        mutateSide(book.asks, bound, false, depth, inst.priceDecimals, m_rng, asks);
+    }
+
+    const qint64 prevSeqId = book.seqId;
+    book.seqId += 1 + m_rng.bounded(3);
+
+    out += "{\"asks\":[";
+    out += asks;
+    out += "],\"bids\":[";
+    out += bids;
+    out += "],\"ts\":\"";
+    out += QByteArray::number(ts);
+    out += "\",\"checksum\":";
+    out += QByteArray::number(bookChecksum(book.bids, book.asks, inst.priceDecimals));
+    out += ",\"prevSeqId\":";
+    out += QByteArray::number(prevSeqId);
+    out += ",\"seqId\":";
+    out += QByteArray::number(book.seqId);
+    out += '}';
+}
+
+// --- REST ---
+
+void OkxMockServer::onNewHttpConnection()
+{
+    while (m_httpServer.hasPendingConnections()) {
+        QTcpSocket *socket = m_httpServer.nextPendingConnection();
+        connect(socket, &QTcpSocket::readyRead, this, &OkxMockServer::onHttpReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_httpBuffers.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void OkxMockServer::onHttpReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) return;
+
+    QByteArray &buffer = m_httpBuffers[socket];
+    buffer += socket->readAll();
+    if (buffer.indexOf("\r\n\r\n") < 0) {
+        if (buffer.size() > MAX_REQUEST_BYTES) socket->abort();
+        return;
+    }
+
+    // One request per connection: "GET /api/v5/market/ticker?instId=BTC-USDT HTTP/1.1"
+    const QList<QByteArray> requestLine = buffer.left(buffer.indexOf("\r\n")).split(' ');
+    m_httpBuffers.remove(socket);
+
+    int status = 405;
+    QByteArray body = "{\"code\":\"50000\",\"msg\":\"Only GET is supported\",\"data\":[]}";
+    if (requestLine.size() >= 2 && requestLine.at(0) == "GET")
+        body = restReply(requestLine.at(1), status);
+    ++m_restReplies;
+
+    QByteArray response = "HTTP/1.1 " + statusLine(status) + "\r\n"
+                          "Content-Type: application/json\r\n"
+                          "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          "Connection: close\r\n\r\n";
+    response += body;
+    socket->write(response);
+    socket->disconnectFromHost();   // Flushes the reply first
+}
+
+QByteArray OkxMockServer::restReply(const QByteArray &target, int &status)
+{
+    const QUrl url(QString::fromLatin1(target));
+    const QUrlQuery query(url);
+    const QString path = url.path();
+    const qint64 ts = QDateTime::currentMSecsSinceEpoch();
+    auto limitOf = [&query](const char *key, int fallback, int max) {
+        bool ok = false;
+        const int v = query.queryItemValue(QLatin1String(key)).toInt(&ok);
+        return ok && v > 0 ? qMin(v, max) : fallback;
+    };
+    auto error = [&status](const char *code, const char *msg) {
+        status = 200;   // OKX reports request errors in the body
+        return QByteArray("{\"code\":\"") + code + "\",\"msg\":\"" + msg + "\",\"data\":[]}";
+    };
+
+    status = 200;
+    QByteArray out = "{\"code\":\"0\",\"msg\":\"\",\"data\":[";
+
+    if (path == QLatin1String("/api/v5/market/tickers") || path == QLatin1String("/api/v5/public/instruments")) {
+        const QString type = query.queryItemValue("instType");
+        if (type.isEmpty()) return error("51000", "Parameter instType error");
+        const bool listing = path.endsWith(QLatin1String("instruments"));
+        bool first = true;
+        for (const Instrument &inst : std::as_const(m_instruments)) {
+            if (instTypeOf(inst.instId) != type) continue;
+            if (!first) out += ',';
+            first = false;
+            if (!listing) {
+                appendTicker(out, inst, ts);
+                continue;
+            }
+            const int dash = inst.wire.indexOf('-');
+            out += "{\"instType\":\"" + type.toLatin1() + "\",\"instId\":\"" + inst.wire
+                   + "\",\"baseCcy\":\"" + inst.wire.left(dash) + "\",\"quoteCcy\":\"" + inst.wire.mid(dash + 1)
+                   + "\",\"tickSz\":";
+            appendQuoted(out, 1, inst.priceDecimals);
+            out += ",\"lotSz\":";
+            appendQuoted(out, 1, SIZE_DECIMALS);
+            out += ",\"state\":\"live\"}";
+        }
+        out += "]}";
+        return out;
+    }
+
+    if (path == QLatin1String("/api/v5/public/time")) {
+        out += "{\"ts\":\"" + QByteArray::number(ts) + "\"}]}";
+        return out;
+    }
+
+    const QString instId = query.queryItemValue("instId");
+    if (!path.startsWith(QLatin1String("/api/v5/market/"))) {
+        status = 404;
+        return "{\"code\":\"404\",\"msg\":\"Not Found\",\"data\":[]}";
+    }
+    if (instId.isEmpty()) return error("51000", "Parameter instId error");
+    Instrument &inst = m_instruments[instrumentFor(instId)];
+
+    if (path == QLatin1String("/api/v5/market/ticker")) {
+        appendTicker(out, inst, ts);
+    } else if (path == QLatin1String("/api/v5/market/books")) {
+        const int depth = limitOf("sz", 1, 400);
+        Book book;
+        fillBook(book, inst, depth);
+        book.seqId = 1000 + m_rng.bounded(1000000);
+        appendBookData(out, book, inst, depth, ts, false, -1);
+    } else if (path == QLatin1String("/api/v5/market/trades")) {
+        // Synthetic history from the current price; ids sit below every future live print
+        const int limit = limitOf("limit", 100, 500);
+        Instrument history = inst;
+        inst.nextTradeId += quint64(limit);
+        QVector<QByteArray> prints(limit);
+        for (int i = 0; i < limit; ++i)
+            appendTrade(prints[i], history, ts - qint64(limit - i) * 250);
+        for (int i = limit - 1; i >= 0; --i) {   // Newest first
+            out += prints.at(i);
+            if (i > 0) out += ',';
+        }
+    } else if (path == QLatin1String("/api/v5/market/candles")) {
+        // Rows: [ts, o, h, l, c, vol, volCcy, volCcyQuote, confirm], newest first, ending at last
+        QString bar = query.queryItemValue("bar");
+        if (bar.isEmpty()) bar = QStringLiteral("1m");
+        const qint64 span = barMs(bar);
+        if (span == 0) return error("51000", "Parameter bar error");
+        const int limit = limitOf("limit", 100, 300);
+        const int d = inst.priceDecimals;
+        const qint64 tick = qMax<qint64>(1, inst.last / 2000);
+        qint64 close = inst.last;
+        for (int i = 0; i < limit; ++i) {
+            const qint64 open = qMax<qint64>(1000, close + m_rng.bounded(-20, 21) * tick);
+            const qint64 high = qMax(open, close) + m_rng.bounded(10) * tick;
+            const qint64 low = qMax<qint64>(1, qMin(open, close) - m_rng.bounded(10) * tick);
+            const qint64 volume = 1 + m_rng.bounded(50000000);
+            const QByteArray turnover = QByteArray::number(double(volume) / double(unitOf(SIZE_DECIMALS))
+                                                           * double(close) / double(unitOf(d)), 'f', 2);
+            if (i > 0) out += ',';
+            out += "[\"" + QByteArray::number((ts / span - i) * span) + "\",";
+            appendQuoted(out, open, d);
+            out += ',';
+            appendQuoted(out, high, d);
+            out += ',';
+            appendQuoted(out, low, d);
+            out += ',';
+            appendQuoted(out, close, d);
+            out += ',';
+            appendQuoted(out, volume, SIZE_DECIMALS);
+            out += ",\"" + turnover + "\",\"" + turnover + "\",";
+            out += i == 0 ? "\"0\"]" : "\"1\"]";
+            close = open;   // The older bar closes where this one opened
+        }
+    } else {
+        status = 404;
+        return "{\"code\":\"404\",\"msg\":\"Not Found\",\"data\":[]}";
+    }
+    out += "]}";
+    return out;
+}
+
+void OkxMockServer::onStatsTimeout()
+{
+    if (m_clients.isEmpty() && m_restReplies == 0) return;
+    qDebug() << "Pushed" << m_pushed << "msgs/s to" << m_clients.size() << "connections,"
+             << m_streamCount << "streams," << m_restReplies << "REST replies";
+    m_pushed = 0;
+    m_restReplies = 0;
+}
@@ -0,0 +1,166 @@
+/******************************************************************************
+ * OkxMockServer.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Local stand-in for the OKX v5 public API, for load-testing the client
+ *   offline.
+ *   - WebSocket (QWebSocketServer): ping/pong, subscribe/unsubscribe with
+ *     acks, and pushes on tickers, trades and the book channels (books,
+ *     books-l2-tbt, books50-l2-tbt with seqId chains and CRC32 checksums;
+ *     books5 and bbo-tbt as snapshots)
+ *   - REST (minimal HTTP/1.1 over QTcpServer): market/ticker, market/tickers,
+ *     market/books, market/trades, market/candles, public/instruments and
+ *     public/time
+ *   - Synthetic universe MOCK0001-USDT...; any other instId is created on
+ *     first use, so real watchlists work too
+ *   - Messages are paced server-wide at a fixed rate, optionally bunched
+ *     into the start of every second (burst factor)
+ ******************************************************************************/
+
+#ifndef OKXMOCKSERVER_H
+#define OKXMOCKSERVER_H
+
+#include <QObject>
+#include <QWebSocketServer>
+#include <QWebSocket>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QHash>
+#include <QVector>
+#include <QByteArray>
+#include <functional>
+#include <map>
+#include <vector>
+
+/**
+ * @struct MockServerConfig
+ * @brief Command-line settings of the mock exchange.
+ */
+struct MockServerConfig {
+    QHostAddress bind = QHostAddress(QHostAddress::LocalHost);   ///< Interface both listeners bind to
+    quint16 wsPort = 8080;
+    quint16 restPort = 8081;
+    int instruments = 500;       ///< Size of the synthetic MOCKnnnn-USDT universe
+    int rate = 10000;            ///< Pushes per second, all connections together
+    double burst = 1.0;          ///< 1 = even; N = each second's pushes go out in its first 1/N
+    int bookDepth = 400;         ///< Levels per side on the books channel
+    quint32 seed = 1;            ///< Random seed (same seed, same market)
+};
+
+/**
+ * @class OkxMockServer
+ * @brief Synthetic OKX public WebSocket + REST endpoints.
+ */
+class OkxMockServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OkxMockServer(const MockServerConfig &config, QObject *parent = nullptr);
+    ~OkxMockServer() override;
+
+    /**
+     * Binds both ports on all interfaces and starts the push clock.
+     */
+    bool listen();
+
+private slots:
+    void onNewWsConnection();
+    void onWsTextMessage(const QString &message);
+    void onWsDisconnected();
+    void onNewHttpConnection();
+    void onHttpReadyRead();
+    void onGenerateTimeout();
+    void onStatsTimeout();
+
+private:
+    // Price mantissa -> size in lots, best level first on both sides
+    using BidSide = std::map<qint64, qint64, std::greater<qint64>>;
+    using AskSide = std::map<qint64, qint64>;
+
+    struct Instrument {
+        QString instId;
+        QByteArray wire;             // instId as written into messages
+        qint64 last = 0;             // Price mantissa at priceDecimals
+        int priceDecimals = 2;
+        qint64 open24h = 0, high24h = 0, low24h = 0;
+        qint64 vol24h = 0;           // Lots
+        quint64 nextTradeId = 1;
+    };
+
+    struct Book {
+        BidSide bids;
+        AskSide asks;
+        qint64 seqId = 0;
+    };
+
+    enum class Channel { Tickers, Trades, Book };
+
+    struct Subscription {
+        Channel channel;
+        QByteArray name;             // Channel name as subscribed
+        int instrument;              // Index into m_instruments
+        int depth = 0;               // Book channels: levels per side
+        bool incremental = false;    // Book channels: snapshot + updates (books*, *-l2-tbt)
+        Book book;                   // Incremental books: this connection's copy
+    };
+
+    struct Client {
+        QWebSocket *socket = nullptr;
+        std::vector<Subscription> subs;
+        quint64 sent = 0;
+    };
+
+    // Universe
+    int instrumentFor(const QString &instId);
+    void addInstrument(const QString &instId);
+    void walk(Instrument &inst, int maxTicks);
+
+    // WebSocket
+    Client *clientOf(QWebSocket *socket);
+    void handleOp(Client &client, const QString &message);
+    Subscription *subscribe(Client &client, const QString &channel, const QString &instId);
+    void unsubscribe(Client &client, const QString &channel, const QString &instId);
+    void push(Client &client, Subscription &sub, bool snapshot = false);
+    void send(Client &client, const QByteArray &frame);
+
+    // Message bodies (shared by the WebSocket pushes and REST replies)
+    void appendTicker(QByteArray &out, const Instrument &inst, qint64 ts) const;
+    void appendTrade(QByteArray &out, Instrument &inst, qint64 ts);
+    void fillBook(Book &book, const Instrument &inst, int depth);
+    void appendBookData(QByteArray &out, const Book &book, const Instrument &inst, int depth,
+                        qint64 ts, bool withChecksum, qint64 prevSeqId) const;
+    void appendBookUpdate(QByteArray &out, Book &book, const Instrument &inst, int depth, qint64 ts);
+
+    // REST
+    QByteArray restReply(const QByteArray &target, int &status);
+
+    MockServerConfig m_config;
+    QWebSocketServer m_wsServer;
+    QTcpServer m_httpServer;
+    QTimer m_generateTimer;
+    QTimer m_statsTimer;
+    QElapsedTimer m_clock;
+    QRandomGenerator m_rng;
+
+    QVector<Instrument> m_instruments;
+    QHash<QString, int> m_indexOf;             // instId -> m_instruments index
+    QVector<Client> m_clients;
+    QHash<QTcpSocket*, QByteArray> m_httpBuffers;   // Request bytes received so far
+    QByteArray m_frame;                        // Reused push buffer
+
+    int m_streamCount = 0;                     // Subscriptions over all clients
+    qint64 m_second = -1;                      // Pacing window (seconds since start)
+    int m_sentThisSecond = 0;
+    quint64 m_pushed = 0;                      // Since the last stats line
+    quint64 m_restReplies = 0;
+};
+
+#endif // OKXMOCKSERVER_H
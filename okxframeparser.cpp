@@ -0,0 +1,525 @@
+/******************************************************************************
+ * OkxFrameParser.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Implementation of the allocation-free OKX frame scanner.
+ * The scanner only understands enough JSON to walk objects/arrays, read
+ * string/number scalars and skip everything else.
+ ******************************************************************************/
+
+#include "okxframeparser.h"
+#include <QByteArray>
+#include <cstdint>
+#include <limits>
+
+namespace {
+
+// Exactly representable powers of ten for the double fast path
+const double kPow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool isSpace(unsigned c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+/**
+ * Minimal forward-only JSON scanner over [p, end).
+ * Every method leaves p on the first character after what it consumed.
+ */
+template <typename Char>
+struct Scanner
+{
+    using View = OkxFrameParser::TextView<Char>;
+
+    const Char *p;
+    const Char *end;
+
+    unsigned peek() const { return p < end ? static_cast<unsigned>(*p) : 0u; }
+
+    void skipWs()
+    {
+        while (p < end && isSpace(static_cast<unsigned>(*p))) ++p;
+    }
+
+    bool consume(char c)
+    {
+        skipWs();
+        if (peek() != static_cast<unsigned>(c)) return false;
+        ++p;
+        return true;
+    }
+
+    // Reads a string literal; the view excludes the quotes (escapes are left as-is)
+    bool readString(View &out)
+    {
+        skipWs();
+        if (peek() != '"') return false;
+        out.begin = ++p;
+        while (p < end) {
+            unsigned c = static_cast<unsigned>(*p);
+            if (c == '\\') {
+                if (p + 1 >= end) return false;   // Frame ends inside an escape
+                p += 2;
+                continue;
+            }
+            if (c == '"') { out.end = p++; return true; }
+            ++p;
+        }
+        return false;
+    }
+
+    // Reads a string (unquoted view) or a bare literal such as a number
+    bool readScalar(View &out)
+    {
+        skipWs();
+        if (peek() == '"') return readString(out);
+        out.begin = p;
+        while (p < end) {
+            unsigned c = static_cast<unsigned>(*p);
+            if (c == ',' || c == '}' || c == ']' || isSpace(c)) break;
+            ++p;
+        }
+        out.end = p;
+        return out.begin != out.end;
+    }
+
+    // Skips one value of any type, tracking nesting without recursion
+    bool skipValue()
+    {
+        skipWs();
+        unsigned c = peek();
+        if (c == '"') { View v; return readString(v); }
+        if (c != '{' && c != '[') { View v; return readScalar(v); }
+
+        int depth = 0;
+        while (p < end) {
+            c = static_cast<unsigned>(*p);
+            if (c == '"') {
+                View v;
+                if (!readString(v)) return false;
+                continue;
+            }
+            if (c == '{' || c == '[') ++depth;
+            else if (c == '}' || c == ']') {
+                if (--depth == 0) { ++p; return true; }
+            }
+            ++p;
+        }
+        return false;
+    }
+
+    // After a member value: consumes ',' and returns true, or '}' and returns false
+    bool nextMember(bool &ok)
+    {
+        skipWs();
+        if (peek() == ',') { ++p; return true; }
+        ok = (peek() == '}');
+        if (ok) ++p;
+        return false;
+    }
+};
+
+} // namespace
+
+//------------------------------------------------------------------------------
+// TextView
+//------------------------------------------------------------------------------
+template <typename Char>
+bool OkxFrameParser::TextView<Char>::equals(const char *ascii) const
+{
+    const Char *it = begin;
+    for (; *ascii; ++ascii, ++it) {
+        if (it == end || static_cast<unsigned>(*it) != static_cast<unsigned char>(*ascii))
+            return false;
+    }
+    return it == end;
+}
+
+template <>
+QString OkxFrameParser::TextView<char>::toString() const
+{
+    return QString::fromUtf8(begin, size());
+}
+
+template <>
+QString OkxFrameParser::TextView<char16_t>::toString() const
+{
+    return QString(reinterpret_cast<const QChar *>(begin), size());
+}
+
+//------------------------------------------------------------------------------
+// Envelope
+//------------------------------------------------------------------------------
+template <typename Char>
+bool OkxFrameParser::parseFrame(const Char *begin, const Char *end, Frame<Char> &frame)
+{
+    frame = Frame<Char>();
+    Scanner<Char> s{begin, end};
+    if (!s.consume('{')) return false;
+    if (s.consume('}')) return false;
+
+    bool ok = false;
+    do {
+        TextView<Char> key;
+        if (!s.readString(key) || !s.consume(':')) return false;
+
+        if (key.equals("event")) {
+            if (!s.readScalar(frame.event)) return false;
+        } else if (key.equals("id")) {
+            if (!s.readScalar(frame.id)) return false;
+        } else if (key.equals("code")) {
+            if (!s.readScalar(frame.code)) return false;
+        } else if (key.equals("msg")) {
+            if (!s.readScalar(frame.msg)) return false;
+        } else if (key.equals("arg")) {
+            if (!s.consume('{')) return false;
+            if (!s.consume('}')) {
+                bool argOk = false;
+                do {
+                    TextView<Char> argKey;
+                    if (!s.readString(argKey) || !s.consume(':')) return false;
+                    if (argKey.equals("channel")) {
+                        if (!s.readScalar(frame.channel)) return false;
+                    } else if (argKey.equals("instId")) {
+                        if (!s.readScalar(frame.instId)) return false;
+                    } else if (!s.skipValue()) {
+                        return false;
+                    }
+                } while (s.nextMember(argOk));
+                if (!argOk) return false;
+            }
+        } else if (key.equals("action")) {
+            if (!s.readScalar(frame.action)) return false;
+        } else if (key.equals("data")) {
+            s.skipWs();
+            frame.data.begin = s.p;
+            if (s.peek() != '[' || !s.skipValue()) return false;
+            frame.data.end = s.p;
+        } else if (!s.skipValue()) {
+            return false;
+        }
+    } while (s.nextMember(ok));
+    if (!ok) return false;
+
+    if (!frame.event.isEmpty())
+        frame.kind = FrameKind::Event;
+    else if (!frame.data.isEmpty())
+        frame.kind = FrameKind::Data;
+    return frame.kind != FrameKind::Invalid;
+}
+
+//------------------------------------------------------------------------------
+// Data array iteration
+//------------------------------------------------------------------------------
+template <typename Char>
+OkxFrameParser::RecordCursor<Char>::RecordCursor(const Frame<Char> &frame)
+    : m_pos(frame.data.begin), m_end(frame.data.end)
+{
+    // Step past the opening '['
+    if (m_pos != m_end) ++m_pos;
+}
+
+template <typename Char>
+bool OkxFrameParser::RecordCursor<Char>::next(TextView<Char> &record)
+{
+    Scanner<Char> s{m_pos, m_end};
+    s.skipWs();
+    if (s.peek() == ',') { ++s.p; s.skipWs(); }
+    if (s.peek() != '{') return false;
+
+    record.begin = s.p;
+    if (!s.skipValue()) return false;
+    record.end = s.p;
+    m_pos = s.p;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Records
+//------------------------------------------------------------------------------
+// Registry id of an instId, through the caller's cache when it has one
+template <typename Char>
+static int internInstrument(const OkxFrameParser::TextView<Char> &instId, InstrumentRegistry::Cache *instruments)
+{
+    return instruments ? instruments->intern(instId.begin, instId.size())
+                       : InstrumentRegistry::instance().intern(instId.begin, instId.size());
+}
+
+template <typename Char>
+bool OkxFrameParser::parseTicker(const TextView<Char> &record, CryptoCV::OkxTicker &ticker,
+                                 InstrumentRegistry::Cache *instruments)
+{
+    Scanner<Char> s{record.begin, record.end};
+    if (!s.consume('{')) return false;
+    if (s.consume('}')) return false;
+
+    ticker.last = ticker.bid = ticker.ask = ticker.askQty = ticker.bidQty = CryptoCV::Decimal();
+    ticker.ts = 0;
+    bool haveInst = false;
+    bool ok = false;
+    do {
+        TextView<Char> key, value;
+        if (!s.readString(key) || !s.consume(':')) return false;
+
+        // Every field we use is a scalar; nested values are skipped untouched
+        s.skipWs();
+        if (s.peek() == '{' || s.peek() == '[') {
+            if (!s.skipValue()) return false;
+            continue;
+        }
+        if (!s.readScalar(value) && s.peek() != ',' && s.peek() != '}') return false;
+
+        if (key.equals("instId")) {
+            ticker.instrument = internInstrument(value, instruments);
+            haveInst = true;
+        }
+        else if (key.equals("last"))  ticker.last   = toDecimal(value);
+        else if (key.equals("bidPx")) ticker.bid    = toDecimal(value);
+        else if (key.equals("askPx")) ticker.ask    = toDecimal(value);
+        else if (key.equals("askSz")) ticker.askQty = toDecimal(value);
+        else if (key.equals("bidSz")) ticker.bidQty = toDecimal(value);
+        else if (key.equals("ts"))    ticker.ts     = toInt64(value);
+    } while (s.nextMember(ok));
+
+    return ok && haveInst;
+}
+
+template <typename Char>
+bool OkxFrameParser::parseTrade(const TextView<Char> &record, CryptoCV::TradePrint &trade,
+                                InstrumentRegistry::Cache *instruments)
+{
+    Scanner<Char> s{record.begin, record.end};
+    if (!s.consume('{')) return false;
+    if (s.consume('}')) return false;
+
+    trade = CryptoCV::TradePrint();
+    bool haveInst = false;
+    bool ok = false;
+    do {
+        TextView<Char> key, value;
+        if (!s.readString(key) || !s.consume(':')) return false;
+
+        s.skipWs();
+        if (s.peek() == '{' || s.peek() == '[') {
+            if (!s.skipValue()) return false;
+            continue;
+        }
+        if (!s.readScalar(value) && s.peek() != ',' && s.peek() != '}') return false;
+
+        if (key.equals("instId")) {
+            trade.instrument = internInstrument(value, instruments);
+            haveInst = true;
+        }
+        else if (key.equals("tradeId")) trade.tradeId = toInt64(value);
+        else if (key.equals("px"))      trade.price   = toDouble(value);
+        else if (key.equals("sz"))      trade.size    = toDouble(value);
+        else if (key.equals("side"))    trade.buy     = value.equals("buy");
+        else if (key.equals("ts"))      trade.ts      = toInt64(value);
+    } while (s.nextMember(ok));
+
+    return ok && haveInst;
+}
+
+template <typename Char>
+bool OkxFrameParser::parseBookRecord(const TextView<Char> &record, BookRecord<Char> &book)
+{
+    book = BookRecord<Char>();
+    Scanner<Char> s{record.begin, record.end};
+    if (!s.consume('{')) return false;
+    if (s.consume('}')) return false;
+
+    bool ok = false;
+    do {
+        TextView<Char> key;
+        if (!s.readString(key) || !s.consume(':')) return false;
+
+        TextView<Char> *target = nullptr;
+        if (key.equals("asks"))           target = &book.asks;
+        else if (key.equals("bids"))      target = &book.bids;
+        else if (key.equals("ts"))        target = &book.ts;
+        else if (key.equals("checksum"))  target = &book.checksum;
+        else if (key.equals("seqId"))     target = &book.seqId;
+        else if (key.equals("prevSeqId")) target = &book.prevSeqId;
+
+        s.skipWs();
+        if (target && s.peek() == '[') {
+            target->begin = s.p;
+            if (!s.skipValue()) return false;
+            target->end = s.p;
+        } else if (target) {
+            if (!s.readScalar(*target)) return false;
+        } else if (!s.skipValue()) {
+            return false;
+        }
+    } while (s.nextMember(ok));
+
+    return ok && (!book.asks.isEmpty() || !book.bids.isEmpty());
+}
+
+template <typename Char>
+OkxFrameParser::LevelCursor<Char>::LevelCursor(const TextView<Char> &side)
+    : m_pos(side.begin), m_end(side.end)
+{
+    // Step past the opening '['
+    if (m_pos != m_end) ++m_pos;
+}
+
+template <typename Char>
+bool OkxFrameParser::LevelCursor<Char>::next(TextView<Char> &price, TextView<Char> &size, TextView<Char> &orders)
+{
+    Scanner<Char> s{m_pos, m_end};
+    s.skipWs();
+    if (s.peek() == ',') ++s.p;
+    if (!s.consume('[')) return false;
+
+    // [px, sz, liquidated orders (deprecated), order count]
+    TextView<Char> liq;
+    orders = TextView<Char>();
+    if (!s.readScalar(price) || !s.consume(',') || !s.readScalar(size)) return false;
+    if (s.consume(',') && s.readScalar(liq) && s.consume(','))
+        s.readScalar(orders);
+    // Tolerate extra trailing fields
+    for (s.skipWs(); s.p < s.end && s.peek() != ']'; s.skipWs()) {
+        if (!s.consume(',') || !s.skipValue()) return false;
+    }
+    if (!s.consume(']')) return false;
+    m_pos = s.p;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Numbers
+//------------------------------------------------------------------------------
+template <typename Char>
+bool OkxFrameParser::parseDecimal(const TextView<Char> &text, qint64 &mantissa, int &decimals)
+{
+    mantissa = 0;
+    decimals = 0;
+    const Char *p = text.begin;
+    const bool negative = p < text.end && *p == '-';
+    if (negative) ++p;
+    int digits = 0;         // Significant digits: leading zeros do not grow the mantissa
+    bool any = false;
+    bool seenDot = false;
+    for (; p < text.end; ++p) {
+        unsigned c = static_cast<unsigned>(*p);
+        if (c >= '0' && c <= '9') {
+            any = true;
+            if ((mantissa != 0 || c != '0') && ++digits > 18) return false;   // Would overflow qint64
+            mantissa = mantissa * 10 + qint64(c - '0');
+            if (seenDot && ++decimals > 18) return false;
+        } else if (c == '.' && !seenDot) {
+            seenDot = true;
+        } else {
+            return false;
+        }
+    }
+    if (negative) mantissa = -mantissa;
+    return any;
+}
+
+template <typename Char>
+CryptoCV::Decimal OkxFrameParser::toDecimal(const TextView<Char> &text)
+{
+    qint64 mantissa = 0;
+    int decimals = 0;
+    if (!parseDecimal(text, mantissa, decimals))
+        return CryptoCV::Decimal();
+    return CryptoCV::Decimal(mantissa, decimals);
+}
+
+template <typename Char>
+double OkxFrameParser::toDouble(const TextView<Char> &text)
+{
+    const Char *p = text.begin;
+    const Char *end = text.end;
+    if (p == end) return 0.0;
+
+    bool negative = false;
+    if (*p == '-' || *p == '+') { negative = (*p == '-'); ++p; }
+
+    std::uint64_t mantissa = 0;
+    int digits = 0;
+    int fraction = 0;
+    bool seenDot = false;
+    bool exact = true;
+    for (; p < end; ++p) {
+        unsigned c = static_cast<unsigned>(*p);
+        if (c >= '0' && c <= '9') {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (c - '0');
+                if (mantissa != 0) ++digits;
+                if (seenDot) ++fraction;
+            } else {
+                exact = false;
+            }
+        } else if (c == '.' && !seenDot) {
+            seenDot = true;
+        } else {
+            exact = false;   // exponent or garbage: let the slow path decide
+            break;
+        }
+    }
+
+    // 2^53: every integer below it is exact as a double, and so is 10^22
+    if (exact && mantissa <= (std::uint64_t(1) << 53) && fraction <= 22) {
+        double v = static_cast<double>(mantissa) / kPow10[fraction];
+        return negative ? -v : v;
+    }
+
+    char buf[64];
+    if (text.size() > int(sizeof(buf)))
+        return text.toString().toDouble();   // Pathological length: allocate rather than truncate
+    int n = 0;
+    for (const Char *q = text.begin; q < end; ++q)
+        buf[n++] = static_cast<char>(*q);
+    return QByteArray::fromRawData(buf, n).toDouble();
+}
+
+template <typename Char>
+qint64 OkxFrameParser::toInt64(const TextView<Char> &text)
+{
+    const Char *p = text.begin;
+    bool negative = false;
+    if (p < text.end && *p == '-') { negative = true; ++p; }
+    qint64 v = 0;
+    for (; p < text.end; ++p) {
+        unsigned c = static_cast<unsigned>(*p);
+        if (c < '0' || c > '9') break;
+        if (v > (std::numeric_limits<qint64>::max() - qint64(c - '0')) / 10)   // Saturate instead of overflowing
+            return negative ? -std::numeric_limits<qint64>::max() : std::numeric_limits<qint64>::max();
+        v = v * 10 + qint64(c - '0');
+    }
+    return negative ? -v : v;
+}
+
+//------------------------------------------------------------------------------
+// Explicit instantiations: UTF-8 (REST / QByteArray) and UTF-16 (QString)
+//------------------------------------------------------------------------------
+template struct OkxFrameParser::TextView<char>;
+template struct OkxFrameParser::TextView<char16_t>;
+template struct OkxFrameParser::RecordCursor<char>;
+template struct OkxFrameParser::RecordCursor<char16_t>;
+template bool OkxFrameParser::parseFrame<char>(const char *, const char *, Frame<char> &);
+template bool OkxFrameParser::parseFrame<char16_t>(const char16_t *, const char16_t *, Frame<char16_t> &);
+template bool OkxFrameParser::parseTicker<char>(const TextView<char> &, CryptoCV::OkxTicker &, InstrumentRegistry::Cache *);
+template bool OkxFrameParser::parseTicker<char16_t>(const TextView<char16_t> &, CryptoCV::OkxTicker &, InstrumentRegistry::Cache *);
+template CryptoCV::Decimal OkxFrameParser::toDecimal<char>(const TextView<char> &);
+template CryptoCV::Decimal OkxFrameParser::toDecimal<char16_t>(const TextView<char16_t> &);
+template double OkxFrameParser::toDouble<char>(const TextView<char> &);
+template double OkxFrameParser::toDouble<char16_t>(const TextView<char16_t> &);
+template qint64 OkxFrameParser::toInt64<char>(const TextView<char> &);
+template qint64 OkxFrameParser::toInt64<char16_t>(const TextView<char16_t> &);
+template struct OkxFrameParser::LevelCursor<char>;
+template struct OkxFrameParser::LevelCursor<char16_t>;
+template bool OkxFrameParser::parseBookRecord<char>(const TextView<char> &, BookRecord<char> &);
+template bool OkxFrameParser::parseBookRecord<char16_t>(const TextView<char16_t> &, BookRecord<char16_t> &);
+template bool OkxFrameParser::parseDecimal<char>(const TextView<char> &, qint64 &, int &);
+template bool OkxFrameParser::parseDecimal<char16_t>(const TextView<char16_t> &, qint64 &, int &);
+template bool OkxFrameParser::parseTrade<char>(const TextView<char> &, CryptoCV::TradePrint &, InstrumentRegistry::Cache *);
+template bool OkxFrameParser::parseTrade<char16_t>(const TextView<char16_t> &, CryptoCV::TradePrint &, InstrumentRegistry::Cache *);
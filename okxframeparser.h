@@ -0,0 +1,192 @@
+/******************************************************************************
+ * OkxFrameParser.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Allocation-free scanner for OKX v5 WebSocket frames and REST replies.
+ *   - Works directly on the raw text (UTF-16 from QWebSocket, UTF-8 from REST)
+ *   - Extracts only the envelope fields ("event", "arg", "data") and the
+ *     record fields the application needs; no QJsonDocument/DOM is built
+ *   - Numbers are converted straight from the wire digits, no temporary QString
+ ******************************************************************************/
+
+#ifndef OKXFRAMEPARSER_H
+#define OKXFRAMEPARSER_H
+#pragma once
+
+#include <QString>
+#include "protocol.h"
+#include "instrumentregistry.h"
+
+/**
+ * @class OkxFrameParser
+ * @brief Streaming parser for OKX public channel frames.
+ *
+ * All views returned by the parser point into the caller's buffer and are only
+ * valid while that buffer is alive. Templates are instantiated for
+ * char (UTF-8 bytes) and char16_t (QString storage).
+ */
+class OkxFrameParser
+{
+public:
+    /**
+     * @enum FrameKind
+     * @brief Envelope type of a parsed frame.
+     */
+    enum class FrameKind {
+        Invalid = 0,   ///< Not a JSON object / malformed
+        Event,         ///< {"event": "subscribe" | "error" | ...}
+        Data           ///< {"arg": {...}, "data": [...]} or REST {"code", "data"}
+    };
+
+    /**
+     * @struct TextView
+     * @brief Non-owning [begin, end) view into the frame text.
+     */
+    template <typename Char>
+    struct TextView {
+        const Char *begin = nullptr;
+        const Char *end = nullptr;
+
+        bool isEmpty() const { return begin == end; }
+        int size() const { return static_cast<int>(end - begin); }
+        bool equals(const char *ascii) const;   ///< Exact compare against an ASCII literal
+        QString toString() const;               ///< Allocates; use for display/logging only
+    };
+
+    /**
+     * @struct Frame
+     * @brief Envelope fields of one OKX message.
+     */
+    template <typename Char>
+    struct Frame {
+        FrameKind kind = FrameKind::Invalid;
+        TextView<Char> event;     ///< "event" value (Event frames)
+        TextView<Char> id;        ///< Client request "id" echoed back on op responses
+        TextView<Char> code;      ///< "code" value (errors / REST replies)
+        TextView<Char> msg;       ///< "msg" value (errors / REST replies)
+        TextView<Char> channel;   ///< "arg.channel"
+        TextView<Char> instId;    ///< "arg.instId"
+        TextView<Char> action;    ///< "snapshot" / "update" (order book channels)
+        TextView<Char> data;      ///< Raw "data" array including brackets
+    };
+
+    /**
+     * @struct BookRecord
+     * @brief Fields of one order book record (books, books5, bbo-tbt, REST books).
+     */
+    template <typename Char>
+    struct BookRecord {
+        TextView<Char> asks;      ///< Raw [[px, sz, liq, orders], ...] array
+        TextView<Char> bids;
+        TextView<Char> ts;
+        TextView<Char> checksum;  ///< Empty on channels without checksum
+        TextView<Char> seqId;
+        TextView<Char> prevSeqId;
+    };
+
+    /**
+     * @struct LevelCursor
+     * @brief Iterates the [px, sz, liq, orders] entries of a book side.
+     */
+    template <typename Char>
+    struct LevelCursor {
+        explicit LevelCursor(const TextView<Char> &side);
+        /**
+         * @return false when the side is exhausted or malformed
+         */
+        bool next(TextView<Char> &price, TextView<Char> &size, TextView<Char> &orders);
+
+    private:
+        const Char *m_pos;
+        const Char *m_end;
+    };
+
+    /**
+     * @struct RecordCursor
+     * @brief Iterates the objects of a frame's "data" array without copying.
+     */
+    template <typename Char>
+    struct RecordCursor {
+        explicit RecordCursor(const Frame<Char> &frame);
+        /**
+         * Advances to the next object in the array.
+         * @param record Receives the raw object text including braces
+         * @return false when the array is exhausted or malformed
+         */
+        bool next(TextView<Char> &record);
+
+    private:
+        const Char *m_pos;
+        const Char *m_end;
+    };
+
+    /**
+     * Parses the top-level envelope of a frame.
+     * @return false if the text is not a well-formed JSON object
+     */
+    template <typename Char>
+    static bool parseFrame(const Char *begin, const Char *end, Frame<Char> &frame);
+
+    /**
+     * Extracts the OkxTicker fields from one "tickers" record; the instId is
+     * interned into an InstrumentRegistry id.
+     * Unknown keys are skipped; missing numeric fields are left at 0.
+     * @param instruments Caller's cache in front of the registry (nullptr: the
+     *                    registry itself, which takes its lock per record)
+     */
+    template <typename Char>
+    static bool parseTicker(const TextView<Char> &record, CryptoCV::OkxTicker &ticker,
+                            InstrumentRegistry::Cache *instruments = nullptr);
+
+    /**
+     * Extracts one "trades" record (instId, tradeId, px, sz, side, ts).
+     * @param instruments As for parseTicker
+     */
+    template <typename Char>
+    static bool parseTrade(const TextView<Char> &record, CryptoCV::TradePrint &trade,
+                           InstrumentRegistry::Cache *instruments = nullptr);
+
+    /**
+     * Locates the sides and sequencing fields of one order book record.
+     */
+    template <typename Char>
+    static bool parseBookRecord(const TextView<Char> &record, BookRecord<Char> &book);
+
+    /**
+     * Splits a decimal string into an integer mantissa and its number of
+     * fraction digits, keeping trailing zeros ("0.50" -> 50, 2), so the
+     * original text can be reproduced exactly (order book checksums).
+     * A leading '-' is kept in the mantissa.
+     * @return false for empty or exponent input, more than 18 significant
+     *         digits or more than 18 fraction digits
+     */
+    template <typename Char>
+    static bool parseDecimal(const TextView<Char> &text, qint64 &mantissa, int &decimals);
+
+    /**
+     * Exact fixed-point value of a decimal field, straight from the wire digits
+     * (no double on the way). Empty or malformed text yields a null Decimal.
+     */
+    template <typename Char>
+    static CryptoCV::Decimal toDecimal(const TextView<Char> &text);
+
+    /**
+     * Converts a decimal number (as sent by OKX, e.g. "43210.5") to double.
+     * Uses an exact integer fast path and falls back to QByteArray::toDouble
+     * for long mantissas or exponents. Empty text yields 0, like QString::toDouble.
+     */
+    template <typename Char>
+    static double toDouble(const TextView<Char> &text);
+
+    /**
+     * Converts an integer field (e.g. "ts") to qint64; stops at the first non-digit
+     * and saturates at the qint64 range.
+     */
+    template <typename Char>
+    static qint64 toInt64(const TextView<Char> &text);
+};
+
+#endif // OKXFRAMEPARSER_H
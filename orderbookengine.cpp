@@ -0,0 +1,293 @@
+/******************************************************************************
+ * OrderBookEngine.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Implementation of the streaming L2 order book engine.
+ ******************************************************************************/
+
+#include "orderbookengine.h"
+#include "instrumentregistry.h"
+#include <algorithm>
+#include <array>
+
+// OKX checksums cover the top 25 levels of each side
+static const int CHECKSUM_LEVELS = 25;
+
+// Finest price scale in a run of wire levels
+static int maxPriceDecimals(const std::vector<OrderBookEngine::Level> &levels)
+{
+    int decimals = 0;
+    for (const OrderBookEngine::Level &l : levels)
+        decimals = qMax<int>(decimals, l.priceDecimals);
+    return decimals;
+}
+
+static PriceLadder::Level toLadderLevel(const PriceLadder &side, const OrderBookEngine::Level &l)
+{
+    PriceLadder::Level level;
+    level.ticks = side.toTicks(l.price, l.priceDecimals);
+    level.size = l.size;
+    level.orders = l.orders;
+    level.priceDecimals = l.priceDecimals;
+    level.sizeDecimals = l.sizeDecimals;
+    return level;
+}
+
+// Writes mantissa/decimals back as the exchange text ("0.005", "1.50", "415")
+static char *writeDecimal(char *out, qint64 mantissa, int decimals)
+{
+    if (mantissa < 0) {
+        *out++ = '-';
+        mantissa = -mantissa;
+    }
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = char('0' + mantissa % 10);
+        mantissa /= 10;
+    } while (mantissa > 0);
+    while (n <= decimals)          // Leading zeros of "0.00x"
+        digits[n++] = '0';
+
+    for (int i = n - 1; i >= 0; --i) {
+        *out++ = digits[i];
+        if (i == decimals && decimals > 0)
+            *out++ = '.';
+    }
+    return out;
+}
+
+static quint32 crc32(const char *data, int length)
+{
+    static const auto table = []() {
+        std::array<quint32, 256> t{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    quint32 crc = 0xFFFFFFFFu;
+    for (int i = 0; i < length; ++i)
+        crc = table[(crc ^ static_cast<quint8>(data[i])) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+template <typename Char>
+static bool sameText(const QString &text, const Char *chars, int length)
+{
+    if (text.size() != length) return false;
+    const QChar *q = text.constData();
+    for (int i = 0; i < length; ++i) {
+        if (q[i].unicode() != static_cast<char16_t>(chars[i])) return false;
+    }
+    return true;
+}
+
+int OrderBookEngine::depthForChannel(const QString &channel)
+{
+    if (channel == QLatin1String("bbo-tbt")) return 1;
+    if (channel == QLatin1String("books5")) return 5;
+    if (channel == QLatin1String("books50-l2-tbt")) return 50;
+    return 400;   // books, books-l2-tbt
+}
+
+template <typename Char>
+bool OrderBookEngine::isBookChannel(const Char *channel, int length)
+{
+    static const char books[] = "books";
+    static const char bbo[] = "bbo-tbt";
+    if (length >= 5) {
+        bool match = true;
+        for (int i = 0; i < 5 && match; ++i)
+            match = channel[i] == Char(books[i]);
+        if (match) return true;
+    }
+    if (length != 7) return false;
+    for (int i = 0; i < 7; ++i) {
+        if (channel[i] != Char(bbo[i])) return false;
+    }
+    return true;
+}
+
+OrderBookEngine::Book *OrderBookEngine::open(const QString &instId, const QString &channel)
+{
+    const int instrument = InstrumentRegistry::instance().intern(instId);
+    const char16_t *chan = reinterpret_cast<const char16_t *>(channel.utf16());
+    Book *book = find(instrument, chan, channel.size());
+    if (!book) {
+        int slot = 0;
+        while (slot < int(m_books.size()) && m_books[slot]) ++slot;
+        if (slot == int(m_books.size())) m_books.emplace_back();
+        m_books[slot].reset(new Book);
+        book = m_books[slot].get();
+        book->instrument = instrument;
+        book->instId = instId;
+        book->channel = channel;
+        book->depth = depthForChannel(channel);
+        // At least twice the depth is kept, so levels that deletes bring back into view are still there
+        book->bids.reset(PriceLadder::Side::Bid, book->depth * 2);
+        book->asks.reset(PriceLadder::Side::Ask, book->depth * 2);
+        if (instrument >= int(m_slotsOf.size())) m_slotsOf.resize(size_t(instrument) + 1);
+        m_slotsOf[size_t(instrument)].push_back(slot);
+        ++m_bookCount;
+    }
+    book->bids.clear();
+    book->asks.clear();
+    book->seqId = -1;
+    book->synced = false;
+    book->dirty = false;
+    return book;
+}
+
+void OrderBookEngine::close(const QString &instId, const QString &channel)
+{
+    const int instrument = InstrumentRegistry::instance().find(instId);
+    if (instrument < 0 || instrument >= int(m_slotsOf.size())) return;
+    std::vector<int> &slots = m_slotsOf[size_t(instrument)];
+    for (auto it = slots.begin(); it != slots.end(); ++it) {
+        if (m_books[*it]->channel == channel) {
+            m_books[*it].reset();
+            slots.erase(it);
+            --m_bookCount;
+            return;
+        }
+    }
+}
+
+template <typename Char>
+OrderBookEngine::Book *OrderBookEngine::find(int instrument, const Char *channel, int channelLength)
+{
+    if (instrument < 0 || instrument >= int(m_slotsOf.size())) return nullptr;
+    // One slot per subscribed channel of the instrument, usually just one
+    for (int slot : m_slotsOf[size_t(instrument)]) {
+        Book *book = m_books[slot].get();
+        if (sameText(book->channel, channel, channelLength))
+            return book;
+    }
+    return nullptr;
+}
+
+void OrderBookEngine::loadSide(PriceLadder &side, const std::vector<Level> &levels)
+{
+    side.clear();
+    side.setPriceScale(maxPriceDecimals(levels));
+    side.assignBestFirst(levels.begin(), levels.end(),
+                         [&side](const Level &l) { return toLadderLevel(side, l); });
+}
+
+void OrderBookEngine::applySide(PriceLadder &side, const std::vector<Level> &changes)
+{
+    side.setPriceScale(maxPriceDecimals(changes));
+    for (const Level &change : changes) {
+        if (change.size == 0)
+            side.remove(side.toTicks(change.price, change.priceDecimals));
+        else
+            side.upsert(toLadderLevel(side, change));
+    }
+}
+
+OrderBookEngine::Result OrderBookEngine::fail(Book &book, bool checksumFailure)
+{
+    if (checksumFailure) ++m_stats.checksumFailures;
+    else ++m_stats.sequenceGaps;
+    ++m_stats.resyncs;
+    book.bids.clear();
+    book.asks.clear();
+    book.seqId = -1;
+    book.synced = false;
+    return Result::Resync;
+}
+
+OrderBookEngine::Result OrderBookEngine::applySnapshot(Book &book, const std::vector<Level> &bids, const std::vector<Level> &asks,
+                                                       qint64 seqId, qint64 ts, bool hasChecksum, qint32 checksum)
+{
+    loadSide(book.bids, bids);
+    loadSide(book.asks, asks);
+    book.seqId = seqId;
+    book.ts = ts;
+    ++m_stats.snapshots;
+
+    if (hasChecksum && OrderBookEngine::checksum(book) != checksum)
+        return fail(book, true);
+
+    book.synced = true;
+    book.dirty = true;
+    ++book.updates;
+    return Result::Applied;
+}
+
+OrderBookEngine::Result OrderBookEngine::applyUpdate(Book &book, const std::vector<Level> &bids, const std::vector<Level> &asks,
+                                                     qint64 prevSeqId, qint64 seqId, qint64 ts, bool hasChecksum, qint32 checksum)
+{
+    if (!book.synced) return Result::Ignored;
+    if (prevSeqId != book.seqId)
+        return fail(book, false);
+
+    applySide(book.bids, bids);
+    applySide(book.asks, asks);
+    book.seqId = seqId;
+    book.ts = ts;
+    ++m_stats.updates;
+
+    if (hasChecksum && OrderBookEngine::checksum(book) != checksum)
+        return fail(book, true);
+
+    book.dirty = true;
+    ++book.updates;
+    return Result::Applied;
+}
+
+qint32 OrderBookEngine::checksum(const Book &book)
+{
+    // 25 levels x 2 sides x (price + size), each at most ~40 chars with separators
+    char buffer[CHECKSUM_LEVELS * 2 * 2 * 42];
+    char *p = buffer;
+    const int bidCount = qMin(CHECKSUM_LEVELS, book.bids.size());
+    const int askCount = qMin(CHECKSUM_LEVELS, book.asks.size());
+
+    auto append = [&p, &buffer](const PriceLadder &side, int depth) {
+        const PriceLadder::Level &l = side.at(depth);
+        if (p != buffer) *p++ = ':';
+        p = writeDecimal(p, side.priceMantissa(l), l.priceDecimals);
+        *p++ = ':';
+        p = writeDecimal(p, l.size, l.sizeDecimals);
+    };
+    for (int i = 0; i < CHECKSUM_LEVELS; ++i) {
+        if (i < bidCount) append(book.bids, i);
+        if (i < askCount) append(book.asks, i);
+    }
+    return static_cast<qint32>(crc32(buffer, int(p - buffer)));
+}
+
+CryptoCV::OrderBookDepth OrderBookEngine::topLevels(const Book &book, int levels)
+{
+    CryptoCV::OrderBookDepth depth;
+    depth.instrument = book.instrument;
+    depth.channel = book.channel;
+    depth.seqId = book.seqId;
+    depth.ts = book.ts;
+
+    auto copySide = [levels](const PriceLadder &side, QVector<CryptoCV::OrderBookLevel> &out) {
+        out.reserve(qMin(levels, side.size()));
+        side.forEachBestFirst(levels, [&side, &out](const PriceLadder::Level &l) {
+            // Exact hand-off: ticks are already a mantissa at the book's price scale
+            out.append(CryptoCV::OrderBookLevel(CryptoCV::Decimal(l.ticks, side.priceScale()),
+                                                CryptoCV::Decimal(l.size, l.sizeDecimals),
+                                                l.orders));
+        });
+    };
+    copySide(book.bids, depth.bids);
+    copySide(book.asks, depth.asks);
+    return depth;
+}
+
+template bool OrderBookEngine::isBookChannel<char>(const char *, int);
+template bool OrderBookEngine::isBookChannel<char16_t>(const char16_t *, int);
+template OrderBookEngine::Book *OrderBookEngine::find<char>(int, const char *, int);
+template OrderBookEngine::Book *OrderBookEngine::find<char16_t>(int, const char16_t *, int);
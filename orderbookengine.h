@@ -0,0 +1,169 @@
+/******************************************************************************
+ * OrderBookEngine.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Streaming L2 order books fed by the OKX books / books5 / bbo-tbt channels.
+ *   - Applies snapshot + incremental updates per instrument
+ *   - Validates the OKX CRC32 checksum and the seqId/prevSeqId chain
+ *   - Reports when a book must be resynced (mismatch or sequence gap)
+ *   Each side is a PriceLadder (integer ticks, preallocated), so applying an
+ *   update never touches the heap.
+ ******************************************************************************/
+
+#ifndef ORDERBOOKENGINE_H
+#define ORDERBOOKENGINE_H
+
+#include <QString>
+#include <vector>
+#include <memory>
+#include "protocol.h"
+#include "priceladder.h"
+
+/**
+ * @class OrderBookEngine
+ * @brief Owns every live order book of the connection (single-threaded use).
+ */
+class OrderBookEngine
+{
+public:
+    /**
+     * @struct Level
+     * @brief One price level as parsed from the wire (exact decimal text).
+     */
+    struct Level {
+        qint64 price = 0;       ///< Price mantissa
+        qint64 size = 0;        ///< Size mantissa (0 = delete level in updates)
+        qint32 orders = 0;      ///< Number of orders at the level
+        qint8 priceDecimals = 0;
+        qint8 sizeDecimals = 0;
+    };
+
+    /**
+     * @struct Book
+     * @brief Both sides of one instrument on one channel.
+     */
+    struct Book {
+        int instrument = -1;         ///< InstrumentRegistry id
+        QString instId;              ///< Symbol, for (re)subscribe requests and logs
+        QString channel;             ///< "books", "books5", "bbo-tbt", ...
+        int depth = 0;               ///< Levels kept per side
+        PriceLadder bids{PriceLadder::Side::Bid};
+        PriceLadder asks{PriceLadder::Side::Ask};
+        qint64 seqId = -1;
+        qint64 ts = 0;
+        bool synced = false;         ///< False until a snapshot is applied
+        bool dirty = false;          ///< Changed since last published
+        quint64 updates = 0;
+    };
+
+    /**
+     * @enum Result
+     * @brief Outcome of applying one record.
+     */
+    enum class Result {
+        Applied = 0,
+        Ignored,         ///< Update before the first snapshot
+        Resync           ///< Checksum mismatch or sequence gap: resubscribe
+    };
+
+    /**
+     * @struct Stats
+     * @brief Engine-wide counters.
+     */
+    struct Stats {
+        quint64 snapshots = 0;
+        quint64 updates = 0;
+        quint64 checksumFailures = 0;
+        quint64 sequenceGaps = 0;
+        quint64 resyncs = 0;
+    };
+
+    /**
+     * Levels kept per side for a channel (400 for books, 5 for books5, 1 for bbo-tbt).
+     */
+    static int depthForChannel(const QString &channel);
+
+    /**
+     * True if the channel is an order book channel handled by this engine.
+     */
+    template <typename Char>
+    static bool isBookChannel(const Char *channel, int length);
+
+    /**
+     * Creates (or resets) the book for instId/channel and preallocates its sides.
+     */
+    Book *open(const QString &instId, const QString &channel);
+
+    /**
+     * Drops the book for instId/channel.
+     */
+    void close(const QString &instId, const QString &channel);
+
+    /**
+     * Allocation-free lookup by instrument id and the raw channel text.
+     */
+    template <typename Char>
+    Book *find(int instrument, const Char *channel, int channelLength);
+
+    /**
+     * Replaces both sides. Used for action=snapshot and for channels that always
+     * push full books (books5, bbo-tbt).
+     * @param checksum Exchange checksum, validated when hasChecksum
+     */
+    Result applySnapshot(Book &book, const std::vector<Level> &bids, const std::vector<Level> &asks,
+                         qint64 seqId, qint64 ts, bool hasChecksum, qint32 checksum);
+
+    /**
+     * Applies an incremental update (size 0 deletes a level).
+     * @param prevSeqId Must match the book's seqId, otherwise a gap is reported
+     */
+    Result applyUpdate(Book &book, const std::vector<Level> &bids, const std::vector<Level> &asks,
+                       qint64 prevSeqId, qint64 seqId, qint64 ts, bool hasChecksum, qint32 checksum);
+
+    /**
+     * OKX checksum: CRC32 of "bid1px:bid1sz:ask1px:ask1sz:..." over the top 25
+     * levels per side, as a signed 32-bit integer.
+     */
+    static qint32 checksum(const Book &book);
+
+    /**
+     * Copies the top levels of a book for display.
+     */
+    static CryptoCV::OrderBookDepth topLevels(const Book &book, int levels);
+
+    /**
+     * Books changed since the last call (marks them clean).
+     */
+    template <typename Fn>
+    void forEachDirty(Fn fn)
+    {
+        for (auto &book : m_books) {
+            if (book && book->dirty) {
+                book->dirty = false;
+                fn(*book);
+            }
+        }
+    }
+
+    const Stats &stats() const { return m_stats; }
+    int bookCount() const { return m_bookCount; }
+
+private:
+    // Loads a best-first snapshot side into its ladder
+    static void loadSide(PriceLadder &side, const std::vector<Level> &levels);
+
+    // Applies one side of an update (size 0 deletes the level)
+    static void applySide(PriceLadder &side, const std::vector<Level> &changes);
+
+    Result fail(Book &book, bool checksumFailure);
+
+    std::vector<std::unique_ptr<Book>> m_books;   // Slots reused after close()
+    std::vector<std::vector<int>> m_slotsOf;      // Instrument id -> its book slots
+    int m_bookCount = 0;
+    Stats m_stats;
+};
+
+#endif // ORDERBOOKENGINE_H
@@ -1,5 +1,6 @@
 #include "orderbookwindow.h"
 #include "ui_orderbookwindow.h"
+#include "instrumentregistry.h"
 #include <QTableWidget>
 #include <QVBoxLayout>
 #include <QLabel>
@@ -19,9 +20,8 @@ OrderBookLevel5 OrderBookLevel5::fromJson(const QJsonObject& obj)
     for (const auto& askVal : asks) {
         QJsonArray arr = askVal.toArray();
         book.asks.append(CryptoCV::OrderBookLevel(
-            arr.at(0).toString().toDouble(),
-            arr.at(1).toString().toDouble(),
-            arr.at(2).toString(),
+            CryptoCV::Decimal::fromString(arr.at(0).toString()),
+            CryptoCV::Decimal::fromString(arr.at(1).toString()),
             arr.at(3).toString().toInt()
             ));
     }
@@ -31,9 +31,8 @@ OrderBookLevel5 OrderBookLevel5::fromJson(const QJsonObject& obj)
     for (const auto& bidVal : bids) {
         QJsonArray arr = bidVal.toArray();
         book.bids.append(CryptoCV::OrderBookLevel(
-            arr.at(0).toString().toDouble(),
-            arr.at(1).toString().toDouble(),
-            arr.at(2).toString(),
+            CryptoCV::Decimal::fromString(arr.at(0).toString()),
+            CryptoCV::Decimal::fromString(arr.at(1).toString()),
             arr.at(3).toString().toInt()
             ));
     }
@@ -44,7 +43,9 @@ OrderBookLevel5 OrderBookLevel5::fromJson(const QJsonObject& obj)
 
 OrderBookWindow::OrderBookWindow(const OrderBookLevel5 &book, QWidget *parent,QString Symbol ) :
     QDialog(parent),
-    ui(new Ui::OrderBookWindow)
+    ui(new Ui::OrderBookWindow),
+    m_symbol(Symbol),
+    m_instrument(InstrumentRegistry::instance().intern(Symbol))
 {
     ui->setupUi(this);        // Codec-generated UI setup
     ui->label_2->setText(Symbol);
@@ -60,47 +61,56 @@ OrderBookWindow::~OrderBookWindow()
 
 void OrderBookWindow::setupOrderBook(const OrderBookLevel5 &book)
 {
-    QStandardItemModel *model = new QStandardItemModel(this);
-
-
-    // Sort asks by ascending price
-    QVector<CryptoCV::OrderBookLevel> asks = book.asks;
-    std::sort(asks.begin(), asks.end(), [](const CryptoCV::OrderBookLevel &a, const CryptoCV::OrderBookLevel &b){
-        return a.price < b.price; // ascending
-    });
-
-    // Sort bids by descending price
-    QVector<CryptoCV::OrderBookLevel> bids = book.bids;
-    std::sort(bids.begin(), bids.end(), [](const CryptoCV::OrderBookLevel &a, const CryptoCV::OrderBookLevel &b){
-        return a.price > b.price; // descending
-    });
+    // Both sides arrive best-first (OKX REST: asks ascending, bids descending),
+    // so they are shown as-is without copying or sorting
 
     // --- ASKS TABLE ---
-    QStandardItemModel *asksModel = new QStandardItemModel(this);
-    asksModel->setColumnCount(2);
-    asksModel->setHorizontalHeaderLabels({"Ask Price", "Ask Qty"});
-
-    for (const auto &lvl : asks) {
-        QList<QStandardItem*> items;
-        items << new QStandardItem(QString::number(lvl.price, 'f', 2))
-              << new QStandardItem(QString::number(lvl.quantity, 'f', 8));
-        asksModel->appendRow(items);
-    }
-    ui->tableView->setModel(asksModel);
+    m_asksModel = new QStandardItemModel(this);
+    m_asksModel->setColumnCount(2);
+    m_asksModel->setHorizontalHeaderLabels({"Ask Price", "Ask Qty"});
+    fillSide(m_asksModel, book.asks);
+    ui->tableView->setModel(m_asksModel);
     ui->tableView->resizeColumnsToContents();
 
 
     // --- BIDS TABLE ---
-    QStandardItemModel *bidsModel = new QStandardItemModel(this);
-    bidsModel->setColumnCount(2);
-    bidsModel->setHorizontalHeaderLabels({"Bid Price", "Bid Qty"});
-
-    for (const auto &lvl : bids) {
-        QList<QStandardItem*> items;
-        items << new QStandardItem(QString::number(lvl.price, 'f', 2))
-              << new QStandardItem(QString::number(lvl.quantity, 'f', 8));
-        bidsModel->appendRow(items);
-    }
-    ui->tableView_2->setModel(bidsModel);
+    m_bidsModel = new QStandardItemModel(this);
+    m_bidsModel->setColumnCount(2);
+    m_bidsModel->setHorizontalHeaderLabels({"Bid Price", "Bid Qty"});
+    fillSide(m_bidsModel, book.bids);
+    ui->tableView_2->setModel(m_bidsModel);
     ui->tableView_2->resizeColumnsToContents();
 }
+
+void OrderBookWindow::onDepthUpdated(const CryptoCV::OrderBookDepth &depth)
+{
+    if (depth.instrument != m_instrument) return;
+    // The engine keeps both sides sorted best-first; no copy/sort needed here
+    fillSide(m_asksModel, depth.asks);
+    fillSide(m_bidsModel, depth.bids);
+}
+
+void OrderBookWindow::fillSide(QStandardItemModel *model, const QVector<CryptoCV::OrderBookLevel> &levels)
+{
+    // One precision per column (the instrument's native one), so digits line up
+    int priceDecimals = 0, qtyDecimals = 0;
+    for (const CryptoCV::OrderBookLevel &lvl : levels) {
+        priceDecimals = qMax<int>(priceDecimals, lvl.price.scale);
+        qtyDecimals = qMax<int>(qtyDecimals, lvl.quantity.scale);
+    }
+
+    model->setRowCount(levels.size());
+    for (int row = 0; row < levels.size(); ++row) {
+        const CryptoCV::OrderBookLevel &lvl = levels.at(row);
+        const QString price = lvl.price.toString(priceDecimals);
+        const QString qty = lvl.quantity.toString(qtyDecimals);
+        // Rows are reused across refreshes; only new rows get items
+        if (QStandardItem *item = model->item(row, 0)) {
+            item->setText(price);
+            model->item(row, 1)->setText(qty);
+        } else {
+            model->setItem(row, 0, new QStandardItem(price));
+            model->setItem(row, 1, new QStandardItem(qty));
+        }
+    }
+}
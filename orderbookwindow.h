@@ -7,6 +7,8 @@
  * Description:
  *   Dialog class for displaying the order book (top N levels) of a crypto instrument.
  *   Includes conversion from JSON, model setup, and UI logic.
+ *   The REST snapshot is shown first; live depth from the streaming order
+ *   book (WebSocketConnection::orderBookUpdated) replaces it as it arrives.
  ******************************************************************************/
 
 #ifndef ORDERBOOKWINDOW_H
@@ -18,6 +20,8 @@
 #include <QJsonArray>
 #include "protocol.h"
 
+class QStandardItemModel;
+
 /**
  * @struct OrderBookLevel5
  * @brief Container for top 5 bid/ask levels in the order book; can parse from QJsonObject.
@@ -61,8 +65,24 @@ public:
      */
     ~OrderBookWindow();
 
+public slots:
+    /**
+     * Refreshes both tables from a streaming book update (other symbols are ignored).
+     * @param depth Top levels published by WebSocketConnection
+     */
+    void onDepthUpdated(const CryptoCV::OrderBookDepth &depth);
+
 private:
     Ui::OrderBookWindow *ui; ///< UI pointer for design/import
+    QString m_symbol;                          ///< Instrument shown in the dialog
+    int m_instrument;                          ///< InstrumentRegistry id of m_symbol
+    QStandardItemModel *m_asksModel = nullptr; ///< Ask table model (owned by dialog)
+    QStandardItemModel *m_bidsModel = nullptr; ///< Bid table model (owned by dialog)
+
+    /**
+     * Rewrites a side's table; levels must already be best-first.
+     */
+    static void fillSide(QStandardItemModel *model, const QVector<CryptoCV::OrderBookLevel> &levels);
     /**
      * Sets up order book table/grid in the dialog.
      * @param book OrderBookLevel5 with all bid/ask levels
@@ -0,0 +1,215 @@
+/******************************************************************************
+ * PriceLadder.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   One side of an order book as a contiguous array of levels keyed by
+ *   integer price ticks. Levels are stored worst -> best, so the best level
+ *   is the last element (O(1)) and inserts and deletes near the top of the
+ *   book shift only a few entries. Lookups are a binary search on one
+ *   integer. Storage for twice the capacity is reserved up front; once it
+ *   fills, the worst half is dropped in one pass, so trimming the far end
+ *   costs amortized O(1) per insert and storage never grows past it.
+ ******************************************************************************/
+
+#ifndef PRICELADDER_H
+#define PRICELADDER_H
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * @class PriceLadder
+ * @brief Sorted, allocation-free bid or ask ladder.
+ */
+class PriceLadder
+{
+public:
+    enum class Side { Bid, Ask };
+
+    /**
+     * @struct Level
+     * @brief One price level. The text scale of price/size is kept so the exact
+     *        exchange strings can be rebuilt (order book checksums).
+     */
+    struct Level {
+        int64_t ticks = 0;          ///< Price in units of 10^-priceScale()
+        int64_t size = 0;           ///< Size mantissa
+        int32_t orders = 0;         ///< Number of orders at the level
+        int8_t priceDecimals = 0;   ///< Fraction digits of the price as sent
+        int8_t sizeDecimals = 0;    ///< Fraction digits of size
+    };
+
+    /**
+     * 10^n for 0 <= n <= 18.
+     */
+    static int64_t pow10(int n)
+    {
+        static const int64_t table[] = {
+            1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL,
+            1000000000LL, 10000000000LL, 100000000000LL, 1000000000000LL, 10000000000000LL,
+            100000000000000LL, 1000000000000000LL, 10000000000000000LL, 100000000000000000LL,
+            1000000000000000000LL
+        };
+        return table[n];
+    }
+
+    /**
+     * @param side     Bid (best = highest) or Ask (best = lowest)
+     * @param capacity Levels always kept; up to twice as many are held between trims
+     */
+    explicit PriceLadder(Side side = Side::Bid, int capacity = 0)
+    {
+        reset(side, capacity);
+    }
+
+    /**
+     * Empties the ladder and reserves storage for 2 * capacity levels.
+     */
+    void reset(Side side, int capacity)
+    {
+        m_sign = side == Side::Bid ? 1 : -1;
+        m_capacity = std::max(1, capacity);
+        m_levels.clear();
+        m_levels.reserve(2 * static_cast<std::size_t>(m_capacity));
+        m_priceScale = 0;
+    }
+
+    /**
+     * Empties the ladder; the tick scale starts over.
+     */
+    void clear()
+    {
+        m_levels.clear();
+        m_priceScale = 0;
+    }
+
+    bool isEmpty() const { return m_levels.empty(); }
+    int size() const { return static_cast<int>(m_levels.size()); }
+    int capacity() const { return m_capacity; }
+
+    /**
+     * Fraction digits that ticks are expressed in.
+     */
+    int priceScale() const { return m_priceScale; }
+
+    /**
+     * Switches to a finer tick scale, rescaling stored levels (only ever grows).
+     */
+    void setPriceScale(int decimals)
+    {
+        if (decimals <= m_priceScale) return;
+        const int64_t factor = pow10(decimals - m_priceScale);
+        for (Level &l : m_levels)
+            l.ticks *= factor;
+        m_priceScale = decimals;
+    }
+
+    /**
+     * Converts a price mantissa with the given fraction digits to ticks.
+     * Call setPriceScale(decimals) first if decimals > priceScale().
+     */
+    int64_t toTicks(int64_t mantissa, int decimals) const
+    {
+        return mantissa * pow10(m_priceScale - decimals);
+    }
+
+    /**
+     * Price mantissa with the level's own fraction digits (exchange text).
+     */
+    int64_t priceMantissa(const Level &level) const
+    {
+        return level.ticks / pow10(m_priceScale - level.priceDecimals);
+    }
+
+    double price(const Level &level) const
+    {
+        return double(level.ticks) / double(pow10(m_priceScale));
+    }
+
+    /**
+     * Inserts or replaces the level at level.ticks. O(log n) search plus a
+     * shift of the levels better than it. When the insert fills the reserved
+     * storage, the worst levels are dropped down to capacity() in one pass.
+     */
+    void upsert(const Level &level)
+    {
+        const int64_t key = level.ticks * m_sign;
+        auto it = lowerBound(key);
+        if (it != m_levels.end() && it->ticks * m_sign == key) {
+            *it = level;
+            return;
+        }
+        m_levels.insert(it, level);
+        if (static_cast<int>(m_levels.size()) >= 2 * m_capacity)
+            m_levels.erase(m_levels.begin(), m_levels.end() - m_capacity);
+    }
+
+    /**
+     * Removes the level at ticks.
+     * @return false if there was no such level
+     */
+    bool remove(int64_t ticks)
+    {
+        const int64_t key = ticks * m_sign;
+        auto it = lowerBound(key);
+        if (it == m_levels.end() || it->ticks * m_sign != key) return false;
+        m_levels.erase(it);
+        return true;
+    }
+
+    /**
+     * Replaces the contents with a best-first run of levels (exchange snapshot
+     * order), keeping at most capacity() of them.
+     * @param convert Maps one input element to a Level (ticks in priceScale())
+     */
+    template <typename It, typename Fn>
+    void assignBestFirst(It first, It last, Fn convert)
+    {
+        const int n = std::min(static_cast<int>(last - first), m_capacity);
+        m_levels.resize(static_cast<std::size_t>(n));
+        for (int i = 0; i < n; ++i, ++first)
+            m_levels[static_cast<std::size_t>(n - 1 - i)] = convert(*first);
+    }
+
+    /**
+     * Best level, or nullptr when empty. O(1).
+     */
+    const Level *best() const { return m_levels.empty() ? nullptr : &m_levels.back(); }
+
+    /**
+     * Level at depth (0 = best). No bounds check.
+     */
+    const Level &at(int depth) const { return m_levels[m_levels.size() - 1 - static_cast<std::size_t>(depth)]; }
+
+    /**
+     * Visits up to limit levels best-first without copying.
+     */
+    template <typename Fn>
+    void forEachBestFirst(int limit, Fn fn) const
+    {
+        const int n = std::min(limit, size());
+        for (int i = 0; i < n; ++i)
+            fn(at(i));
+    }
+
+private:
+    // Levels are ordered by ticks * sign ascending: worst first, best last
+    std::vector<Level>::iterator lowerBound(int64_t key)
+    {
+        const int64_t sign = m_sign;
+        return std::lower_bound(m_levels.begin(), m_levels.end(), key,
+                                [sign](const Level &l, int64_t k) { return l.ticks * sign < k; });
+    }
+
+    std::vector<Level> m_levels;
+    int m_capacity = 1;
+    int m_priceScale = 0;
+    int64_t m_sign = 1;   // +1 bids (ascending ticks), -1 asks (descending ticks)
+};
+
+#endif // PRICELADDER_H
@@ -14,6 +14,8 @@
 #pragma once
 
 #include <QString>
+#include <QVector>
+#include "decimal.h"
 
 namespace CryptoCV {
 
@@ -33,6 +35,9 @@ enum MarketWatchColumn
     MarketWatch_TOTAL_COLUMNS    ///< Total columns count (for table setup)
 };
 
+// Price/quantity columns (LAST_PRICE .. BID_QUANTITY): the ones that flash on change
+static const int MarketWatch_FLASH_COLUMNS = MarketWatch_TOTAL_COLUMNS - MarketWatch_LAST_PRICE;
+
 /**
  * @enum ApiRequestType
  * @brief Enum for dispatching different snapshot requests to OKX REST API.
@@ -40,26 +45,36 @@ enum MarketWatchColumn
 enum class ApiRequestType {
     TickerSnapshot = 0,      ///< Basic instrument stats
     OrderBookSnapshot,       ///< Top N levels of order book
-    RecentTrades            ///< Recent trades/tape
+    RecentTrades,            ///< Recent trades/tape
+    Candles                  ///< OHLCV history for one bar size (candle backfill)
+};
+
+/**
+ * @enum SubscriptionState
+ * @brief Lifecycle of one WebSocket channel subscription ("tickers:BTC-USDT").
+ */
+enum class SubscriptionState {
+    Pending = 0,     ///< Sent, waiting for {"event":"subscribe"}
+    Subscribed,      ///< Acknowledged by the exchange
+    Failed           ///< Rejected with {"event":"error"}
 };
 
 /**
  * @struct MarketWatchRowData
- * @brief Data structure for holding all values of a row in the market table.
+ * @brief Identity and display state of a row in the market table; the quotes
+ *        themselves are kept column-wise in MarketWatchModel's QuoteStore.
  */
 struct MarketWatchRowData {
     int uid;               ///< Row unique ID
-    QString symbol;        ///< Instrument symbol
-    double lastPrice;      ///< Last traded price
-    double prevPrice = 0.0;
-    double bidPrice;       ///< Highest bid price
-    double prevBid = 0.0;
-    double askPrice;       ///< Lowest ask price
-    double prevAsk = 0.0;
-    double askQty;         ///< Top ask quantity
-    double bidQty;         ///< Top bid quantity
-    double prevAskQty = 0.0;
-    double prevBidQty = 0.0;
+    QString symbol;        ///< Instrument symbol (display only)
+    int instrument = -1;   ///< InstrumentRegistry id of symbol
+    int priceDecimals = 0; ///< Native price precision (metadata, else widest scale seen)
+    int sizeDecimals = 0;  ///< Native quantity precision (metadata, else widest scale seen)
+    bool knownPrecision = false; ///< Decimals come from instrument metadata (tickSz/lotSz), not widened by ticks
+    QString text[MarketWatch_FLASH_COLUMNS];          ///< Formatted price/qty cells, rebuilt only when value or precision changes
+    qint64 changedNs[MarketWatch_FLASH_COLUMNS] = {}; ///< Flash start per price/qty cell (LatencyRecorder::nowNs), 0 = none
+    bool inViewport = true; ///< Formatted, flashed and announced on ticks (viewport-limited models: on screen or in the margin)
+    bool textStale = false; ///< text[] lags the quotes (changed while out of the viewport)
 };
 
 /**
@@ -67,25 +82,94 @@ struct MarketWatchRowData {
  * @brief Structure for parsed ticker stats from OKX live tickers or snapshot.
  */
 struct OkxTicker {
-    QString instId;   ///< Instrument symbol, e.g. "BTC-USDT"
-    double last;      ///< Last traded price
-    double bid;       ///< Current best bid price
-    double ask;       ///< Current best ask price
-    double askQty;    ///< Quantity at best ask
-    double bidQty;    ///< Quantity at best bid
+    int instrument = -1;  ///< InstrumentRegistry id of the instId
+    Decimal last;         ///< Last traded price
+    Decimal bid;          ///< Current best bid price
+    Decimal ask;          ///< Current best ask price
+    Decimal askQty;       ///< Quantity at best ask
+    Decimal bidQty;       ///< Quantity at best bid
+    qint64 ts = 0;        ///< Exchange timestamp (ms since epoch)
+    // Latency stamps (LatencyRecorder::nowNs); 0 for REST snapshots
+    qint64 recvNs = 0;    ///< Frame received
+    qint64 parsedNs = 0;  ///< Ticker parsed
+    qint32 networkUs = -1;///< Exchange ts -> received, clock-offset corrected; -1 = unknown
+};
+
+/**
+ * @struct TradePrint
+ * @brief One public trade from the OKX "trades" channel (POD, no allocation).
+ */
+struct TradePrint {
+    int instrument = -1;     ///< InstrumentRegistry id of the instId
+    qint64 tradeId = 0;
+    qint64 ts = 0;           ///< Exchange timestamp (ms since epoch)
+    double price = 0.0;
+    double size = 0.0;
+    bool buy = false;        ///< Taker side
+};
+
+/**
+ * @struct Candle
+ * @brief One OHLCV bar built from trades (or backfilled from REST).
+ */
+struct Candle {
+    qint64 openTime = 0;     ///< Bucket start (ms since epoch)
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;     ///< Sum of trade sizes
+    double turnover = 0.0;   ///< Sum of price * size (quote volume)
+    quint32 trades = 0;      ///< Prints aggregated live (REST bars carry no count)
+    bool confirmed = false;  ///< Bucket closed
+
+    double vwap() const { return volume > 0.0 ? turnover / volume : close; }
 };
 
 /**
  * @struct OrderBookLevel
- * @brief One order book row/level as returned by the OKX REST API.
+ * @brief One order book row/level for display (REST snapshot or OrderBookDepth).
+ *        Live books are kept in PriceLadder; this is only the GUI hand-off.
  */
 struct OrderBookLevel {
-    double price;
-    double quantity;
-    QString meta;    ///< Extra info: could be ignored or used for notes/context
+    Decimal price;
+    Decimal quantity;
     int orders;      ///< Number of orders at that level
-    OrderBookLevel(double p = 0, double q = 0, QString m = QString(), int o = 0)
-        : price(p), quantity(q), meta(std::move(m)), orders(o) {}
+    OrderBookLevel(Decimal p = Decimal(), Decimal q = Decimal(), int o = 0)
+        : price(p), quantity(q), orders(o) {}
+};
+
+/**
+ * @struct OrderBookDepth
+ * @brief Top levels of a streaming order book, published by WebSocketConnection.
+ */
+struct OrderBookDepth {
+    int instrument = -1;              ///< InstrumentRegistry id
+    QString channel;                  ///< "books", "books5" or "bbo-tbt"
+    QVector<OrderBookLevel> asks;     ///< Lowest price first
+    QVector<OrderBookLevel> bids;     ///< Highest price first
+    qint64 seqId = -1;
+    qint64 ts = 0;                    ///< Exchange timestamp (ms since epoch)
+};
+
+/**
+ * @struct FeedShardStats
+ * @brief Per-connection statistics of the WebSocket subscription pool.
+ */
+struct FeedShardStats {
+    int shard = 0;              ///< Shard index in the pool
+    bool connected = false;
+    int subscriptions = 0;      ///< Instruments routed to this shard
+    quint64 messages = 0;       ///< Frames received since start
+    quint64 bytes = 0;          ///< Payload bytes received since start
+    double msgsPerSec = 0.0;    ///< Rate over the last sample interval
+    double bytesPerSec = 0.0;   ///< Rate over the last sample interval
+    qint64 lagMs = 0;           ///< Smoothed local receive time - exchange ts
+    int reconnects = 0;         ///< Reconnect attempts since start
+    int outages = 0;            ///< Disconnects / stale drops since start
+    int staleDrops = 0;         ///< Connections dropped for silence
+    qint64 lastRecoveryMs = 0;  ///< Outage start -> first data frame, last outage
+    qint64 maxRecoveryMs = 0;   ///< Worst time-to-recover since start
 };
 
 } // namespace CryptoCV
@@ -0,0 +1,141 @@
+/******************************************************************************
+ * QuoteStore.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Implementation of the columnar quote store and its batch compare kernel.
+ ******************************************************************************/
+
+#include "quotestore.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QUOTESTORE_SSE2
+#include <emmintrin.h>
+#endif
+
+// Field of a ticker, in QuoteStore::Field order
+static const CryptoCV::Decimal &fieldOf(const CryptoCV::OkxTicker &t, int f)
+{
+    switch (f) {
+    case QuoteStore::Last:   return t.last;
+    case QuoteStore::Bid:    return t.bid;
+    case QuoteStore::Ask:    return t.ask;
+    case QuoteStore::AskQty: return t.askQty;
+    default:                 return t.bidQty;
+    }
+}
+
+void QuoteStore::append(int count)
+{
+    const size_t n = m_up.size() + size_t(qMax(0, count));
+    for (int f = 0; f < FIELD_COUNT; ++f) {
+        m_mantissa[f].resize(n, 0);
+        m_scale[f].resize(n, -1);
+        m_prevMantissa[f].resize(n, 0);
+        m_prevScale[f].resize(n, -1);
+    }
+    m_up.resize(n, 0);
+}
+
+void QuoteStore::remove(int row, int count)
+{
+    if (row < 0 || count <= 0 || row + count > size()) return;
+    for (int f = 0; f < FIELD_COUNT; ++f) {
+        m_mantissa[f].erase(m_mantissa[f].begin() + row, m_mantissa[f].begin() + row + count);
+        m_scale[f].erase(m_scale[f].begin() + row, m_scale[f].begin() + row + count);
+        m_prevMantissa[f].erase(m_prevMantissa[f].begin() + row, m_prevMantissa[f].begin() + row + count);
+        m_prevScale[f].erase(m_prevScale[f].begin() + row, m_prevScale[f].begin() + row + count);
+    }
+    m_up.erase(m_up.begin() + row, m_up.begin() + row + count);
+}
+
+void QuoteStore::compareLanes(const qint64 *newM, const qint64 *oldM, const qint64 *newS, const qint64 *oldS,
+                              int count, quint8 *changed, quint8 *up, quint8 fieldBit)
+{
+    int i = 0;
+#ifdef QUOTESTORE_SSE2
+    // Two lanes per step. SSE2 has no 64-bit compare, so equality is "both 32-bit
+    // halves of new - old are zero" and direction is the sign bit of new - old
+    // (mantissas stay below 10^18, the difference cannot overflow).
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 2 <= count; i += 2) {
+        const __m128i nm = _mm_loadu_si128(reinterpret_cast<const __m128i *>(newM + i));
+        const __m128i om = _mm_loadu_si128(reinterpret_cast<const __m128i *>(oldM + i));
+        const __m128i ns = _mm_loadu_si128(reinterpret_cast<const __m128i *>(newS + i));
+        const __m128i os = _mm_loadu_si128(reinterpret_cast<const __m128i *>(oldS + i));
+
+        const __m128i diff = _mm_sub_epi64(nm, om);
+        const int zeroHalves = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(diff, zero)));
+        const int sameScaleHalves = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(ns, os)));
+        const int negative = _mm_movemask_pd(_mm_castsi128_pd(diff));
+
+        for (int lane = 0; lane < 2; ++lane) {
+            const int halves = 3 << (2 * lane);
+            const int k = i + lane;
+            if ((sameScaleHalves & halves) != halves) {
+                // Mixed scales (or null vs value): exact compare after widening
+                const int c = CryptoCV::Decimal(newM[k], int(newS[k])).compare(CryptoCV::Decimal(oldM[k], int(oldS[k])));
+                if (c != 0) changed[k] |= fieldBit;
+                if (c > 0) up[k] |= fieldBit;
+            } else if ((zeroHalves & halves) != halves) {
+                changed[k] |= fieldBit;
+                if (!(negative & (1 << lane))) up[k] |= fieldBit;
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        int c;
+        if (newS[i] == oldS[i])
+            c = newM[i] < oldM[i] ? -1 : (newM[i] > oldM[i] ? 1 : 0);
+        else
+            c = CryptoCV::Decimal(newM[i], int(newS[i])).compare(CryptoCV::Decimal(oldM[i], int(oldS[i])));
+        if (c != 0) changed[i] |= fieldBit;
+        if (c > 0) up[i] |= fieldBit;
+    }
+}
+
+void QuoteStore::applyBatch(const int *rows, const CryptoCV::OkxTicker *ticks, int count, quint8 *changed)
+{
+    if (count <= 0) return;
+    const size_t n = size_t(count);
+    m_newM.resize(n);
+    m_oldM.resize(n);
+    m_newS.resize(n);
+    m_oldS.resize(n);
+    m_laneUp.assign(n, 0);
+    std::fill(changed, changed + count, quint8(0));
+
+    for (int f = 0; f < FIELD_COUNT; ++f) {
+        // Gather: incoming values and the current values of their rows into lanes
+        const qint64 *curM = m_mantissa[f].data();
+        const qint8 *curS = m_scale[f].data();
+        for (int i = 0; i < count; ++i) {
+            const CryptoCV::Decimal &d = fieldOf(ticks[i], f);
+            m_newM[size_t(i)] = d.mantissa;
+            m_newS[size_t(i)] = d.scale;
+            m_oldM[size_t(i)] = curM[rows[i]];
+            m_oldS[size_t(i)] = curS[rows[i]];
+        }
+
+        const quint8 bit = quint8(1u << f);
+        compareLanes(m_newM.data(), m_oldM.data(), m_newS.data(), m_oldS.data(), count, changed, m_laneUp.data(), bit);
+
+        // Scatter: only the fields that moved, keeping the old value as previous
+        for (int i = 0; i < count; ++i) {
+            if (!(changed[i] & bit)) continue;
+            const size_t row = size_t(rows[i]);
+            m_prevMantissa[f][row] = m_mantissa[f][row];
+            m_prevScale[f][row] = m_scale[f][row];
+            m_mantissa[f][row] = m_newM[size_t(i)];
+            m_scale[f][row] = qint8(m_newS[size_t(i)]);
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        quint8 &up = m_up[size_t(rows[i])];
+        up = quint8((up & ~changed[i]) | m_laneUp[size_t(i)]);
+    }
+}
@@ -0,0 +1,87 @@
+/******************************************************************************
+ * QuoteStore.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Columnar (struct-of-arrays) storage of the Market Watch quotes.
+ *   - One contiguous mantissa array and one scale array per field (last, bid,
+ *     ask, askQty, bidQty), plus the same for the value before each field's
+ *     latest change, indexed by model row
+ *   - applyBatch() gathers a whole tick batch into lane arrays and computes
+ *     change masks and flash direction with SSE2 (two int64 lanes per step);
+ *     lanes whose scales differ fall back to the exact Decimal compare
+ *   - Builds without SSE2 run the same kernel as a scalar loop
+ *   GUI thread only (owned by MarketWatchModel).
+ ******************************************************************************/
+
+#ifndef QUOTESTORE_H
+#define QUOTESTORE_H
+
+#include <QtGlobal>
+#include <vector>
+#include "protocol.h"
+
+/**
+ * @class QuoteStore
+ * @brief Quote columns of the Market Watch rows.
+ */
+class QuoteStore
+{
+public:
+    // Same order as the LAST_PRICE .. BID_QUANTITY columns
+    enum Field { Last = 0, Bid, Ask, AskQty, BidQty, FIELD_COUNT };
+
+    int size() const { return int(m_up.size()); }
+
+    /**
+     * Appends count rows with null quotes.
+     */
+    void append(int count = 1);
+
+    /**
+     * Removes count consecutive rows starting at row.
+     */
+    void remove(int row, int count = 1);
+
+    CryptoCV::Decimal value(Field f, int row) const
+    {
+        return CryptoCV::Decimal(m_mantissa[f][size_t(row)], m_scale[f][size_t(row)]);
+    }
+
+    CryptoCV::Decimal previous(Field f, int row) const
+    {
+        return CryptoCV::Decimal(m_prevMantissa[f][size_t(row)], m_prevScale[f][size_t(row)]);
+    }
+
+    /**
+     * Direction of the field's latest change: true if it moved up.
+     */
+    bool rising(Field f, int row) const { return (m_up[size_t(row)] >> f) & 1u; }
+
+    /**
+     * Writes ticks[i] into rows[i] for i < count and sets changed[i] to the
+     * fields that moved (bit = 1 << Field). Unchanged fields are not written;
+     * changed ones keep their old value as previous().
+     * Rows must be distinct within a batch (TickConflator releases one tick per instrument).
+     */
+    void applyBatch(const int *rows, const CryptoCV::OkxTicker *ticks, int count, quint8 *changed);
+
+private:
+    // Lane i of the staged new/old values: changed[i] / up[i] |= fieldBit when it moved / moved up
+    static void compareLanes(const qint64 *newM, const qint64 *oldM, const qint64 *newS, const qint64 *oldS,
+                             int count, quint8 *changed, quint8 *up, quint8 fieldBit);
+
+    std::vector<qint64> m_mantissa[FIELD_COUNT];
+    std::vector<qint8> m_scale[FIELD_COUNT];
+    std::vector<qint64> m_prevMantissa[FIELD_COUNT];
+    std::vector<qint8> m_prevScale[FIELD_COUNT];
+    std::vector<quint8> m_up;                       // Row -> rising bit per field
+
+    // Batch lanes, reused between batches
+    std::vector<qint64> m_newM, m_oldM, m_newS, m_oldS;
+    std::vector<quint8> m_laneUp;
+};
+
+#endif // QUOTESTORE_H
@@ -0,0 +1,106 @@
+/******************************************************************************
+ * SpscRingBuffer.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Bounded single-producer/single-consumer ring buffer used to hand parsed
+ *   market data from the network thread to the GUI thread without locks or
+ *   per-item signals. Slots are preallocated; a full buffer drops the new item
+ *   and counts it instead of blocking the producer.
+ ******************************************************************************/
+
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/**
+ * @class SpscRingBuffer
+ * @brief Lock-free bounded queue: exactly one thread calls push(), one calls pop().
+ */
+template <typename T>
+class SpscRingBuffer
+{
+public:
+    /**
+     * @param capacity Requested slot count, rounded up to a power of two
+     */
+    explicit SpscRingBuffer(std::size_t capacity)
+    {
+        std::size_t size = 2;
+        while (size < capacity) size <<= 1;
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    SpscRingBuffer(const SpscRingBuffer &) = delete;
+    SpscRingBuffer &operator=(const SpscRingBuffer &) = delete;
+
+    /**
+     * Producer side. Copies the item into the next free slot.
+     * @return false (and counts a drop) if the consumer has fallen a full buffer behind
+     */
+    bool push(const T &item)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        const std::size_t tail = m_tail.load(std::memory_order_acquire);
+        if (head - tail > m_mask) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_slots[head & m_mask] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        m_pushed.fetch_add(1, std::memory_order_relaxed);
+
+        const std::size_t depth = head + 1 - tail;
+        if (depth > m_highWater.load(std::memory_order_relaxed))
+            m_highWater.store(depth, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * Consumer side. Moves the oldest item out.
+     * @return false if the buffer is empty
+     */
+    bool pop(T &item)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire))
+            return false;
+        item = std::move(m_slots[tail & m_mask]);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // --- Counters (safe to read from any thread; values are approximate) ---
+
+    std::size_t capacity() const { return m_mask + 1; }
+    std::size_t depth() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+    std::uint64_t pushed() const { return m_pushed.load(std::memory_order_relaxed); }
+    std::uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+    std::size_t highWater() const { return m_highWater.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<T> m_slots;
+    std::size_t m_mask = 0;
+
+    // Producer and consumer indices on separate cache lines to avoid false sharing
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+
+    alignas(64) std::atomic<std::uint64_t> m_pushed{0};
+    std::atomic<std::uint64_t> m_dropped{0};
+    std::atomic<std::size_t> m_highWater{0};
+};
+
+#endif // SPSCRINGBUFFER_H
@@ -0,0 +1,196 @@
+/******************************************************************************
+ * tst_incrementalsortproxy.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 16-10-2026
+ *
+ * Description:
+ *   IncrementalSortProxy against a brute-force re-sort of its source.
+ *   - Random key changes, filter flips, row inserts and removes; after every
+ *     step the proxy order must equal sorting the accepted source rows by
+ *     (key, source row), and mapToSource/mapFromSource must agree
+ *   - QAbstractItemModelTester checks every signal the proxy emits
+ *   - Persistent indexes (selection, current) follow their rows through
+ *     moves, inserts and removes
+ ******************************************************************************/
+
+#include <QtTest>
+#include <QAbstractItemModelTester>
+#include <QStandardItemModel>
+#include <QRandomGenerator>
+#include <algorithm>
+#include "incrementalsortproxy.h"
+
+class TestIncrementalSortProxy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void randomOperations_data();
+    void randomOperations();
+    void persistentIndexesFollowRows();
+    void sourceOrderWithoutSortColumn();
+
+private:
+    // Column 0: numeric sort key; column 1: text the filter reads
+    static QList<QStandardItem *> makeRow(QRandomGenerator &rng);
+    // filtered: the proxy keeps rows whose column 1 contains FILTER
+    static void verify(const QStandardItemModel &source, const IncrementalSortProxy &proxy, bool filtered);
+};
+
+static const QString FILTER = QStringLiteral("a");
+
+QList<QStandardItem *> TestIncrementalSortProxy::makeRow(QRandomGenerator &rng)
+{
+    QStandardItem *key = new QStandardItem;
+    key->setData(double(rng.bounded(50)), Qt::DisplayRole);   // Few distinct keys: plenty of ties
+    QStandardItem *text = new QStandardItem(rng.bounded(5) == 0 ? QStringLiteral("b") : QStringLiteral("a"));
+    return {key, text};
+}
+
+void TestIncrementalSortProxy::verify(const QStandardItemModel &source, const IncrementalSortProxy &proxy, bool filtered)
+{
+    // Brute force: accepted rows ordered by (key, source row)
+    QVector<int> expected;
+    for (int row = 0; row < source.rowCount(); ++row) {
+        if (!filtered || source.index(row, 1).data().toString().contains(FILTER))
+            expected << row;
+    }
+    const bool ascending = proxy.sortOrder() == Qt::AscendingOrder;
+    std::stable_sort(expected.begin(), expected.end(), [&](int a, int b) {
+        if (proxy.sortColumn() < 0)
+            return false;
+        const double ka = source.index(a, 0).data().toDouble();
+        const double kb = source.index(b, 0).data().toDouble();
+        return ascending ? ka < kb : kb < ka;
+    });
+
+    QCOMPARE(proxy.rowCount(), expected.size());
+    for (int row = 0; row < expected.size(); ++row) {
+        const QModelIndex sourceIndex = proxy.mapToSource(proxy.index(row, 0));
+        QCOMPARE(sourceIndex.row(), expected.at(row));
+        QCOMPARE(proxy.mapFromSource(sourceIndex).row(), row);
+    }
+}
+
+void TestIncrementalSortProxy::randomOperations_data()
+{
+    QTest::addColumn<int>("order");
+    QTest::addColumn<quint32>("seed");
+    QTest::newRow("ascending") << int(Qt::AscendingOrder) << 1u;
+    QTest::newRow("descending") << int(Qt::DescendingOrder) << 2u;
+}
+
+void TestIncrementalSortProxy::randomOperations()
+{
+    QFETCH(int, order);
+    QFETCH(quint32, seed);
+    QRandomGenerator rng(seed);
+
+    QStandardItemModel source(0, 2);
+    for (int i = 0; i < 200; ++i)
+        source.appendRow(makeRow(rng));
+
+    IncrementalSortProxy proxy;
+    QAbstractItemModelTester tester(&proxy, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    proxy.setSourceModel(&source);
+    proxy.setFilterKeyColumn(1);
+    proxy.setFilterFixedString(FILTER);
+    proxy.sort(0, Qt::SortOrder(order));
+    verify(source, proxy, true);
+
+    for (int step = 0; step < 2000; ++step) {
+        const int op = int(rng.bounded(20));
+        const int rows = source.rowCount();
+        if (op == 0) {
+            // Insert a block anywhere
+            const int at = int(rng.bounded(rows + 1));
+            const int count = 1 + int(rng.bounded(5));
+            for (int i = 0; i < count; ++i)
+                source.insertRow(at + i, makeRow(rng));
+        } else if (op == 1 && rows > 0) {
+            // Remove a block anywhere
+            const int at = int(rng.bounded(rows));
+            source.removeRows(at, qMin(rows - at, 1 + int(rng.bounded(6))));
+        } else if (op == 2 && rows > 0) {
+            // Filter flip
+            QStandardItem *text = source.item(int(rng.bounded(rows)), 1);
+            text->setText(text->text() == QLatin1String("a") ? QStringLiteral("b") : QStringLiteral("a"));
+        } else if (rows > 0) {
+            // Key change
+            source.item(int(rng.bounded(rows)), 0)->setData(double(rng.bounded(50)), Qt::DisplayRole);
+        }
+        verify(source, proxy, true);
+    }
+    QVERIFY(proxy.rowMoves() > 0);
+}
+
+void TestIncrementalSortProxy::persistentIndexesFollowRows()
+{
+    QRandomGenerator rng(3);
+    QStandardItemModel source(0, 2);
+    for (int i = 0; i < 50; ++i)
+        source.appendRow(makeRow(rng));
+    IncrementalSortProxy proxy;
+    proxy.setSourceModel(&source);
+    proxy.sort(0);
+
+    // Tag every row, then hold a persistent index on each
+    QVector<QPersistentModelIndex> held;
+    QVector<int> tags;
+    for (int row = 0; row < source.rowCount(); ++row)
+        source.item(row, 1)->setData(row, Qt::UserRole);
+    for (int row = 0; row < proxy.rowCount(); ++row) {
+        held << QPersistentModelIndex(proxy.index(row, 1));
+        tags << held.last().data(Qt::UserRole).toInt();
+    }
+
+    for (int step = 0; step < 500; ++step) {
+        const int rows = source.rowCount();
+        if (step % 10 == 0) {
+            source.insertRow(int(rng.bounded(rows + 1)), makeRow(rng));
+        } else if (step % 10 == 5) {
+            // Never remove a held row: they all carry a tag
+            const int row = int(rng.bounded(rows));
+            if (source.item(row, 1)->data(Qt::UserRole).isValid()) continue;
+            source.removeRow(row);
+        } else {
+            source.item(int(rng.bounded(rows)), 0)->setData(double(rng.bounded(50)), Qt::DisplayRole);
+        }
+    }
+    for (int i = 0; i < held.size(); ++i) {
+        QVERIFY(held.at(i).isValid());
+        QCOMPARE(held.at(i).data(Qt::UserRole).toInt(), tags.at(i));
+    }
+    verify(source, proxy, false);
+}
+
+void TestIncrementalSortProxy::sourceOrderWithoutSortColumn()
+{
+    QRandomGenerator rng(4);
+    QStandardItemModel source(0, 2);
+    for (int i = 0; i < 20; ++i)
+        source.appendRow(makeRow(rng));
+    IncrementalSortProxy proxy;
+    proxy.setSourceModel(&source);
+
+    // Unsorted, unfiltered: a block appended to the source is one insert at the end
+    QSignalSpy inserted(&proxy, &QAbstractItemModel::rowsInserted);
+    QSignalSpy reset(&proxy, &QAbstractItemModel::modelReset);
+    source.insertRows(source.rowCount(), 3);
+    QCOMPARE(inserted.size(), 1);
+    QCOMPARE(inserted.at(0).at(1).toInt(), 20);
+    QCOMPARE(inserted.at(0).at(2).toInt(), 22);
+
+    // A block removed from the middle is one remove
+    QSignalSpy removed(&proxy, &QAbstractItemModel::rowsRemoved);
+    source.removeRows(5, 4);
+    QCOMPARE(removed.size(), 1);
+    QCOMPARE(removed.at(0).at(1).toInt(), 5);
+    QCOMPARE(removed.at(0).at(2).toInt(), 8);
+    QCOMPARE(reset.size(), 0);
+    verify(source, proxy, false);
+}
+
+QTEST_GUILESS_MAIN(TestIncrementalSortProxy)
+#include "tst_incrementalsortproxy.moc"
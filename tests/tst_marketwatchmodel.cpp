@@ -0,0 +1,238 @@
+/******************************************************************************
+ * tst_marketwatchmodel.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 16-10-2026
+ *
+ * Description:
+ *   MarketWatchModel batch inserts and removes at thousands of rows.
+ *   - addRows: one insert notification and one subscribe per batch;
+ *     symbols already in the watch (or twice in the batch) are skipped
+ *   - removeRowsAt: single rows, contiguous blocks and non-contiguous
+ *     multi-range selections in any order give one remove notification
+ *     per range and one unsubscribe naming exactly the removed symbols
+ *   - The instrument -> row index matches the rows after every change, and
+ *     ticks still land on the row of their instrument
+ ******************************************************************************/
+
+#include <QtTest>
+#include <QSignalSpy>
+#include <algorithm>
+#include "marketwatchmodel.h"
+#include "instrumentregistry.h"
+
+static const int ROWS = 5000;
+
+class TestMarketWatchModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void addRows();
+    void addRowsSkipsDuplicates();
+    void removeRowsAt_data();
+    void removeRowsAt();
+    void removeNothing();
+    void ticksFollowRemovedRows();
+
+private:
+    static QString symbolOf(int i);
+    static QVector<CryptoCV::MarketWatchRowData> rowData(int first, int count);
+
+    // Every row's instrument maps back to it, and removed instruments map to -1
+    static void checkIndex(const MarketWatchModel &model, const QStringList &removed = QStringList());
+};
+
+QString TestMarketWatchModel::symbolOf(int i)
+{
+    return QString("TST%1-USDT").arg(i, 5, 10, QLatin1Char('0'));
+}
+
+QVector<CryptoCV::MarketWatchRowData> TestMarketWatchModel::rowData(int first, int count)
+{
+    QVector<CryptoCV::MarketWatchRowData> data;
+    data.reserve(count);
+    for (int i = first; i < first + count; ++i) {
+        CryptoCV::MarketWatchRowData row;
+        row.symbol = symbolOf(i);
+        data.append(row);
+    }
+    return data;
+}
+
+void TestMarketWatchModel::checkIndex(const MarketWatchModel &model, const QStringList &removed)
+{
+    for (int row = 0; row < model.rows.size(); ++row)
+        QCOMPARE(model.rowOfInstrument(model.rows.at(row).instrument), row);
+    for (const QString &symbol : removed)
+        QCOMPARE(model.rowOfInstrument(InstrumentRegistry::instance().find(symbol)), -1);
+}
+
+void TestMarketWatchModel::addRows()
+{
+    MarketWatchModel model;
+    QSignalSpy inserted(&model, &MarketWatchModel::rowsInserted);
+    QSignalSpy subscribed(&model, &MarketWatchModel::subscribeRequested);
+
+    model.addRows(rowData(0, ROWS));
+
+    QCOMPARE(model.rowCount(), ROWS);
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(inserted.at(0).at(1).toInt(), 0);
+    QCOMPARE(inserted.at(0).at(2).toInt(), ROWS - 1);
+    QCOMPARE(subscribed.count(), 1);
+    const QStringList symbols = subscribed.at(0).at(0).toStringList();
+    QCOMPARE(symbols.size(), ROWS);
+    QCOMPARE(symbols.first(), symbolOf(0));
+    QCOMPARE(symbols.last(), symbolOf(ROWS - 1));
+    checkIndex(model);
+}
+
+void TestMarketWatchModel::addRowsSkipsDuplicates()
+{
+    MarketWatchModel model;
+    model.addRows(rowData(0, 100));
+
+    QSignalSpy inserted(&model, &MarketWatchModel::rowsInserted);
+    QSignalSpy subscribed(&model, &MarketWatchModel::subscribeRequested);
+
+    // 50..149: the first half is already in, and the batch names 120 twice
+    QVector<CryptoCV::MarketWatchRowData> batch = rowData(50, 100);
+    batch.append(rowData(120, 1));
+    model.addRows(batch);
+
+    QCOMPARE(model.rowCount(), 150);
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(inserted.at(0).at(1).toInt(), 100);
+    QCOMPARE(inserted.at(0).at(2).toInt(), 149);
+    QCOMPARE(subscribed.count(), 1);
+    QCOMPARE(subscribed.at(0).at(0).toStringList().size(), 50);
+    checkIndex(model);
+
+    // Nothing new: no notification, no subscribe
+    model.addRows(rowData(0, 10));
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(subscribed.count(), 1);
+}
+
+void TestMarketWatchModel::removeRowsAt_data()
+{
+    QTest::addColumn<QList<int>>("selection");
+    QTest::addColumn<int>("ranges");
+
+    QTest::newRow("first row") << (QList<int>() << 0) << 1;
+    QTest::newRow("last row") << (QList<int>() << ROWS - 1) << 1;
+    QList<int> block;
+    for (int row = 1000; row < 3000; ++row) block << row;
+    QTest::newRow("contiguous block") << block << 1;
+    QList<int> everyOther;
+    for (int row = 0; row < ROWS; row += 2) everyOther << row;
+    QTest::newRow("every other row") << everyOther << ROWS / 2;
+
+    // Ctrl+click blocks picked bottom-up, the top row, a lone row and the
+    // bottom row, with duplicates and rows outside the model
+    QList<int> multi;
+    for (int row = 4500; row < 4600; ++row) multi << row;
+    for (int row = 2000; row < 2500; ++row) multi << row;
+    for (int row = 10; row < 20; ++row) multi << row;
+    multi << 0 << 777 << ROWS - 1 << 2100 << 777 << -1 << ROWS;
+    QTest::newRow("multi-range, unordered") << multi << 6;
+
+    QList<int> all;
+    for (int row = ROWS - 1; row >= 0; --row) all << row;
+    QTest::newRow("all rows") << all << 1;
+}
+
+void TestMarketWatchModel::removeRowsAt()
+{
+    QFETCH(QList<int>, selection);
+    QFETCH(int, ranges);
+
+    MarketWatchModel model;
+    model.addRows(rowData(0, ROWS));
+
+    QList<int> removedRows;
+    for (int row : selection) {
+        if (row >= 0 && row < ROWS) removedRows << row;
+    }
+    std::sort(removedRows.begin(), removedRows.end());
+    removedRows.erase(std::unique(removedRows.begin(), removedRows.end()), removedRows.end());
+    QStringList removed, kept;
+    for (int row = 0; row < ROWS; ++row)
+        (std::binary_search(removedRows.begin(), removedRows.end(), row) ? removed : kept) << symbolOf(row);
+
+    QSignalSpy aboutToRemove(&model, &MarketWatchModel::rowsAboutToBeRemoved);
+    QSignalSpy rowsRemoved(&model, &MarketWatchModel::rowsRemoved);
+    QSignalSpy unsubscribed(&model, &MarketWatchModel::unsubscribeRequested);
+
+    model.removeRowsAt(selection);
+
+    QCOMPARE(rowsRemoved.count(), ranges);
+    QCOMPARE(aboutToRemove.count(), ranges);
+    int removedCount = 0;
+    int previousFirst = ROWS;
+    for (const QList<QVariant> &args : std::as_const(rowsRemoved)) {
+        const int first = args.at(1).toInt(), last = args.at(2).toInt();
+        QVERIFY(last < previousFirst);   // Bottom-up, so pending ranges keep their indexes
+        previousFirst = first;
+        removedCount += last - first + 1;
+    }
+    QCOMPARE(removedCount, int(removed.size()));
+
+    QCOMPARE(unsubscribed.count(), 1);
+    QStringList unsubscribedSymbols = unsubscribed.at(0).at(0).toStringList();
+    unsubscribedSymbols.sort();
+    QCOMPARE(unsubscribedSymbols, removed);
+
+    QCOMPARE(model.rowCount(), int(kept.size()));
+    for (int row = 0; row < kept.size(); ++row)
+        QCOMPARE(model.rows.at(row).symbol, kept.at(row));
+    checkIndex(model, removed);
+}
+
+void TestMarketWatchModel::removeNothing()
+{
+    MarketWatchModel model;
+    model.addRows(rowData(0, 10));
+
+    QSignalSpy rowsRemoved(&model, &MarketWatchModel::rowsRemoved);
+    QSignalSpy unsubscribed(&model, &MarketWatchModel::unsubscribeRequested);
+    model.removeRowsAt(QList<int>());
+    model.removeRowsAt(QList<int>() << -1 << 10 << 100);
+
+    QCOMPARE(rowsRemoved.count(), 0);
+    QCOMPARE(unsubscribed.count(), 0);
+    QCOMPARE(model.rowCount(), 10);
+}
+
+void TestMarketWatchModel::ticksFollowRemovedRows()
+{
+    MarketWatchModel model;
+    model.addRows(rowData(0, ROWS));
+    QList<int> selection;
+    for (int row = 0; row < ROWS; row += 3) selection << row;
+    model.removeRowsAt(selection);
+
+    // A row that moved up, and a removed instrument whose tick must go nowhere
+    const QString movedSymbol = symbolOf(ROWS - 1);
+    const QString removedSymbol = symbolOf(ROWS - 2);
+    CryptoCV::OkxTicker moved;
+    moved.instrument = InstrumentRegistry::instance().find(movedSymbol);
+    moved.last = CryptoCV::Decimal(4325010, 2);
+    CryptoCV::OkxTicker gone = moved;
+    gone.instrument = InstrumentRegistry::instance().find(removedSymbol);
+
+    QSignalSpy changed(&model, &MarketWatchModel::dataChanged);
+    model.onTickBatch(QVector<CryptoCV::OkxTicker>() << moved << gone);
+
+    const int row = model.rowOfInstrument(moved.instrument);
+    QCOMPARE(model.rows.at(row).symbol, movedSymbol);
+    QCOMPARE(model.data(model.index(row, CryptoCV::MarketWatch_LAST_PRICE), Qt::DisplayRole).toString(),
+             QStringLiteral("43250.10"));
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(changed.at(0).at(0).value<QModelIndex>().row(), row);
+    QCOMPARE(changed.at(0).at(1).value<QModelIndex>().row(), row);
+}
+
+QTEST_GUILESS_MAIN(TestMarketWatchModel)
+#include "tst_marketwatchmodel.moc"
@@ -0,0 +1,315 @@
+/******************************************************************************
+ * tst_okxframeparser.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 16-10-2026
+ *
+ * Description:
+ *   OkxFrameParser on well-formed, escaped and truncated frames.
+ *   - Envelopes, ticker and order book records, UTF-8 and UTF-16; tickers
+ *     against QJsonDocument; instIds interned through the registry or a
+ *     shard's InstrumentRegistry::Cache resolve to the same id
+ *   - Every prefix of a frame is rejected; each prefix is an exactly sized
+ *     copy, so a read past its end is a read past the allocation
+ *   - Numbers: signs, more than 18 digits, long fractions, exponents; wire
+ *     decimals keep their text's digits, and Decimal::fromString agrees
+ ******************************************************************************/
+
+#include <QtTest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <limits>
+#include <vector>
+#include "okxframeparser.h"
+
+class TestOkxFrameParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tickerFrame();
+    void eventFrame();
+    void escapedStrings();
+    void truncatedFrames_data();
+    void truncatedFrames();
+    void bookRecord();
+    void parseDecimal_data();
+    void parseDecimal();
+    void toDouble_data();
+    void toDouble();
+    void toInt64();
+
+private:
+    // Exactly sized copies of a frame's text
+    static std::vector<char> utf8(const QString &text);
+    static std::vector<char16_t> utf16(const QString &text);
+};
+
+static const QString TICKER_FRAME = QStringLiteral(
+    "{\"arg\":{\"channel\":\"tickers\",\"instId\":\"BTC-USDT\"},\"data\":[{\"instType\":\"SPOT\",\"instId\":\"BTC-USDT\","
+    "\"last\":\"43250.1\",\"lastSz\":\"0.0123\",\"askPx\":\"43250.2\",\"askSz\":\"1.5\",\"bidPx\":\"43250\",\"bidSz\":\"0.25\","
+    "\"nested\":{\"a\":[1,2,{\"b\":\"}]\"}]},\"ts\":\"1700000000000\"}]}");
+
+static const QString BOOKS_FRAME = QStringLiteral(
+    "{\"arg\":{\"channel\":\"books\",\"instId\":\"BTC-USDT\"},\"action\":\"update\",\"data\":[{"
+    "\"asks\":[[\"43250.5\",\"0.50\",\"0\",\"3\"],[\"43251\",\"0\",\"0\",\"0\"]],"
+    "\"bids\":[[\"43250.1\",\"1.25\",\"0\",\"1\",\"extra\"]],"
+    "\"ts\":\"1700000000000\",\"checksum\":-855196043,\"seqId\":124,\"prevSeqId\":123}]}");
+
+std::vector<char> TestOkxFrameParser::utf8(const QString &text)
+{
+    const QByteArray bytes = text.toUtf8();
+    return std::vector<char>(bytes.constData(), bytes.constData() + bytes.size());
+}
+
+std::vector<char16_t> TestOkxFrameParser::utf16(const QString &text)
+{
+    const char16_t *begin = reinterpret_cast<const char16_t *>(text.constData());
+    return std::vector<char16_t>(begin, begin + text.size());
+}
+
+void TestOkxFrameParser::tickerFrame()
+{
+    // Reference values from a full JSON parse
+    const QJsonObject rec = QJsonDocument::fromJson(TICKER_FRAME.toUtf8()).object().value("data").toArray().first().toObject();
+
+    const std::vector<char16_t> text = utf16(TICKER_FRAME);
+    OkxFrameParser::Frame<char16_t> frame;
+    QVERIFY(OkxFrameParser::parseFrame(text.data(), text.data() + text.size(), frame));
+    QCOMPARE(frame.kind, OkxFrameParser::FrameKind::Data);
+    QVERIFY(frame.channel.equals("tickers"));
+    QVERIFY(frame.instId.equals("BTC-USDT"));
+
+    OkxFrameParser::RecordCursor<char16_t> cursor(frame);
+    OkxFrameParser::TextView<char16_t> record;
+    QVERIFY(cursor.next(record));
+    CryptoCV::OkxTicker t;
+    QVERIFY(OkxFrameParser::parseTicker(record, t));
+    QCOMPARE(InstrumentRegistry::instance().symbol(t.instrument), rec.value("instId").toString());
+    QVERIFY(t.last == CryptoCV::Decimal::fromString(rec.value("last").toString()));
+    QVERIFY(t.ask == CryptoCV::Decimal::fromString(rec.value("askPx").toString()));
+    QVERIFY(t.askQty == CryptoCV::Decimal::fromString(rec.value("askSz").toString()));
+    QVERIFY(t.bid == CryptoCV::Decimal::fromString(rec.value("bidPx").toString()));
+    QVERIFY(t.bidQty == CryptoCV::Decimal::fromString(rec.value("bidSz").toString()));
+    QCOMPARE(t.last.mantissa, Q_INT64_C(432501));   // Wire digits, no rounding
+    QCOMPARE(int(t.last.scale), 1);
+    QCOMPARE(t.ts, rec.value("ts").toString().toLongLong());
+    QVERIFY(!cursor.next(record));
+
+    // The same frame as UTF-8 (REST replies), through a shard's cache: same id
+    const std::vector<char> bytes = utf8(TICKER_FRAME);
+    OkxFrameParser::Frame<char> frame8;
+    QVERIFY(OkxFrameParser::parseFrame(bytes.data(), bytes.data() + bytes.size(), frame8));
+    OkxFrameParser::RecordCursor<char> cursor8(frame8);
+    OkxFrameParser::TextView<char> record8;
+    QVERIFY(cursor8.next(record8));
+    CryptoCV::OkxTicker t8;
+    InstrumentRegistry::Cache cache;
+    QVERIFY(OkxFrameParser::parseTicker(record8, t8, &cache));
+    QCOMPARE(t8.instrument, t.instrument);
+    QVERIFY(t8.last == t.last);
+    QVERIFY(OkxFrameParser::parseTicker(record8, t8, &cache));
+    QCOMPARE(t8.instrument, t.instrument);
+    QCOMPARE(cache.size(), 1);
+    QCOMPARE(cache.intern(QStringLiteral("BTC-USDT")), t.instrument);
+
+    // A record without instId is rejected
+    const std::vector<char> noInst = utf8(QStringLiteral("{\"data\":[{\"last\":\"1\"}]}"));
+    QVERIFY(OkxFrameParser::parseFrame(noInst.data(), noInst.data() + noInst.size(), frame8));
+    OkxFrameParser::RecordCursor<char> noInstCursor(frame8);
+    QVERIFY(noInstCursor.next(record8));
+    QVERIFY(!OkxFrameParser::parseTicker(record8, t8));
+}
+
+void TestOkxFrameParser::eventFrame()
+{
+    const std::vector<char16_t> text = utf16(QStringLiteral(
+        "{\"id\":\"17\",\"event\":\"subscribe\",\"arg\":{\"channel\":\"tickers\",\"instId\":\"ETH-USDT\"},\"connId\":\"a4d3ae55\"}"));
+    OkxFrameParser::Frame<char16_t> frame;
+    QVERIFY(OkxFrameParser::parseFrame(text.data(), text.data() + text.size(), frame));
+    QCOMPARE(frame.kind, OkxFrameParser::FrameKind::Event);
+    QVERIFY(frame.event.equals("subscribe"));
+    QVERIFY(frame.channel.equals("tickers"));
+    QVERIFY(frame.instId.equals("ETH-USDT"));
+    QVERIFY(frame.id.equals("17"));   // Request id echoed back on op responses
+
+    // Neither event nor data: not a frame the application handles
+    const std::vector<char16_t> empty = utf16(QStringLiteral("{\"arg\":{}}"));
+    QVERIFY(!OkxFrameParser::parseFrame(empty.data(), empty.data() + empty.size(), frame));
+}
+
+void TestOkxFrameParser::escapedStrings()
+{
+    // Escapes are kept as-is in the view; an escaped quote does not end the string
+    const std::vector<char> text = utf8(QStringLiteral(
+        "{\"event\":\"error\",\"code\":\"60012\",\"msg\":\"Invalid request: {\\\"op\\\": \\\"subscribe\\\\\\\"}\"}"));
+    OkxFrameParser::Frame<char> frame;
+    QVERIFY(OkxFrameParser::parseFrame(text.data(), text.data() + text.size(), frame));
+    QCOMPARE(frame.kind, OkxFrameParser::FrameKind::Event);
+    QVERIFY(frame.event.equals("error"));
+    QVERIFY(frame.code.equals("60012"));
+    QCOMPARE(frame.msg.toString(), QStringLiteral("Invalid request: {\\\"op\\\": \\\"subscribe\\\\\\\"}"));
+
+    // A frame that ends on a backslash inside a string
+    for (const QString &broken : {QStringLiteral("{\"msg\":\"abc\\"), QStringLiteral("{\"msg\\"), QStringLiteral("{\"\\")}) {
+        const std::vector<char> b8 = utf8(broken);
+        QVERIFY(!OkxFrameParser::parseFrame(b8.data(), b8.data() + b8.size(), frame));
+        const std::vector<char16_t> b16 = utf16(broken);
+        OkxFrameParser::Frame<char16_t> frame16;
+        QVERIFY(!OkxFrameParser::parseFrame(b16.data(), b16.data() + b16.size(), frame16));
+    }
+}
+
+void TestOkxFrameParser::truncatedFrames_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::newRow("tickers") << TICKER_FRAME;
+    QTest::newRow("escaped error") << QStringLiteral("{\"event\":\"error\",\"msg\":\"a\\\\\\\"b\\\\\",\"code\":\"1\"}");
+    QTest::newRow("books") << BOOKS_FRAME;
+    QTest::newRow("whitespace") << QStringLiteral(" { \"data\" : [ { \"instId\" : \"X\" , \"last\" : -1.5 } ] } ");
+}
+
+void TestOkxFrameParser::truncatedFrames()
+{
+    QFETCH(QString, text);
+    const QString trimmed = text.trimmed();
+    for (int length = 0; length < trimmed.size(); ++length) {
+        const QString prefix = trimmed.left(length);
+        const std::vector<char16_t> t16 = utf16(prefix);
+        OkxFrameParser::Frame<char16_t> frame16;
+        QVERIFY2(!OkxFrameParser::parseFrame(t16.data(), t16.data() + t16.size(), frame16), qPrintable(prefix));
+        const std::vector<char> t8 = utf8(prefix);
+        OkxFrameParser::Frame<char> frame8;
+        QVERIFY2(!OkxFrameParser::parseFrame(t8.data(), t8.data() + t8.size(), frame8), qPrintable(prefix));
+    }
+    // The whole frame parses
+    const std::vector<char16_t> whole = utf16(text);
+    OkxFrameParser::Frame<char16_t> frame;
+    QVERIFY(OkxFrameParser::parseFrame(whole.data(), whole.data() + whole.size(), frame));
+}
+
+void TestOkxFrameParser::bookRecord()
+{
+    const std::vector<char16_t> text = utf16(BOOKS_FRAME);
+    OkxFrameParser::Frame<char16_t> frame;
+    QVERIFY(OkxFrameParser::parseFrame(text.data(), text.data() + text.size(), frame));
+    QVERIFY(frame.channel.equals("books"));
+    QVERIFY(frame.action.equals("update"));
+
+    OkxFrameParser::RecordCursor<char16_t> cursor(frame);
+    OkxFrameParser::TextView<char16_t> record;
+    QVERIFY(cursor.next(record));
+    OkxFrameParser::BookRecord<char16_t> book;
+    QVERIFY(OkxFrameParser::parseBookRecord(record, book));
+    QVERIFY(book.checksum.equals("-855196043"));
+    QVERIFY(book.seqId.equals("124"));
+    QVERIFY(book.prevSeqId.equals("123"));
+
+    OkxFrameParser::TextView<char16_t> price, size, orders;
+    OkxFrameParser::LevelCursor<char16_t> asks(book.asks);
+    QVERIFY(asks.next(price, size, orders));
+    QVERIFY(price.equals("43250.5") && size.equals("0.50") && orders.equals("3"));
+    QVERIFY(asks.next(price, size, orders));
+    QVERIFY(price.equals("43251") && size.equals("0"));
+    QVERIFY(!asks.next(price, size, orders));
+    OkxFrameParser::LevelCursor<char16_t> bids(book.bids);   // Extra trailing fields are tolerated
+    QVERIFY(bids.next(price, size, orders));
+    QVERIFY(price.equals("43250.1") && size.equals("1.25") && orders.equals("1"));
+    QVERIFY(!bids.next(price, size, orders));
+
+    // A side cut inside a level
+    const std::vector<char16_t> cut = utf16(QStringLiteral("[[\"1.5\",\"2\""));
+    OkxFrameParser::LevelCursor<char16_t> cutSide(OkxFrameParser::TextView<char16_t>{cut.data(), cut.data() + cut.size()});
+    QVERIFY(!cutSide.next(price, size, orders));
+}
+
+void TestOkxFrameParser::parseDecimal_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<bool>("ok");
+    QTest::addColumn<qint64>("mantissa");
+    QTest::addColumn<int>("decimals");
+    QTest::newRow("trailing zero") << QStringLiteral("0.50") << true << Q_INT64_C(50) << 2;
+    QTest::newRow("integer") << QStringLiteral("43250") << true << Q_INT64_C(43250) << 0;
+    QTest::newRow("negative") << QStringLiteral("-1.25") << true << Q_INT64_C(-125) << 2;
+    QTest::newRow("18 fraction digits") << QStringLiteral("0.000000000000000001") << true << Q_INT64_C(1) << 18;
+    QTest::newRow("19 fraction digits") << QStringLiteral("0.0000000000000000001") << false << Q_INT64_C(0) << 0;
+    QTest::newRow("18 digits") << QStringLiteral("123456789012345678") << true << Q_INT64_C(123456789012345678) << 0;
+    QTest::newRow("negative 18 digits") << QStringLiteral("-12345678.9012345678") << true << Q_INT64_C(-123456789012345678) << 10;
+    QTest::newRow("19 digits") << QStringLiteral("1234567890123456789") << false << Q_INT64_C(0) << 0;
+    QTest::newRow("leading zeros") << QStringLiteral("0000000000000000000012.5") << true << Q_INT64_C(125) << 1;
+    QTest::newRow("empty") << QString() << false << Q_INT64_C(0) << 0;
+    QTest::newRow("sign only") << QStringLiteral("-") << false << Q_INT64_C(0) << 0;
+    QTest::newRow("exponent") << QStringLiteral("1e5") << false << Q_INT64_C(0) << 0;
+    QTest::newRow("two dots") << QStringLiteral("1.2.3") << false << Q_INT64_C(0) << 0;
+}
+
+void TestOkxFrameParser::parseDecimal()
+{
+    QFETCH(QString, text);
+    QFETCH(bool, ok);
+    QFETCH(qint64, mantissa);
+    QFETCH(int, decimals);
+    const std::vector<char16_t> t16 = utf16(text);
+    qint64 m = 0;
+    int d = 0;
+    const OkxFrameParser::TextView<char16_t> view{t16.data(), t16.data() + t16.size()};
+    QCOMPARE(OkxFrameParser::parseDecimal(view, m, d), ok);
+
+    // The stream (toDecimal) and REST (Decimal::fromString) paths agree
+    const CryptoCV::Decimal stream = OkxFrameParser::toDecimal(view);
+    const CryptoCV::Decimal rest = CryptoCV::Decimal::fromString(text);
+    QCOMPARE(stream.isNull(), !ok);
+    QCOMPARE(rest.isNull(), !ok);
+    if (!ok) return;
+    QCOMPARE(m, mantissa);
+    QCOMPARE(d, decimals);
+    QCOMPARE(stream.mantissa, mantissa);
+    QCOMPARE(int(stream.scale), decimals);
+    QCOMPARE(rest.mantissa, mantissa);
+    QCOMPARE(int(rest.scale), decimals);
+}
+
+void TestOkxFrameParser::toDouble_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::newRow("integer") << QStringLiteral("43250");
+    QTest::newRow("fraction") << QStringLiteral("43250.10");
+    QTest::newRow("negative") << QStringLiteral("-0.0015");
+    QTest::newRow("plus") << QStringLiteral("+12.5");
+    QTest::newRow("leading zeros") << QStringLiteral("0.000000012345");
+    QTest::newRow("18 digits") << QStringLiteral("123456789012345678");
+    QTest::newRow("19 digits") << QStringLiteral("1234567890123456789");
+    QTest::newRow("25 digits") << QStringLiteral("1234567890123456789012345");
+    QTest::newRow("negative 22 digits") << QStringLiteral("-12345678901.23456789012");
+    QTest::newRow("long fraction") << QStringLiteral("0.00000000000000000000000123");
+    QTest::newRow("exponent") << QStringLiteral("1.5e-7");
+    QTest::newRow("over 64 chars") << QStringLiteral("0.") + QString(70, QLatin1Char('1'));
+}
+
+void TestOkxFrameParser::toDouble()
+{
+    QFETCH(QString, text);
+    const std::vector<char16_t> t16 = utf16(text);
+    QCOMPARE(OkxFrameParser::toDouble(OkxFrameParser::TextView<char16_t>{t16.data(), t16.data() + t16.size()}), text.toDouble());
+    const std::vector<char> t8 = utf8(text);
+    QCOMPARE(OkxFrameParser::toDouble(OkxFrameParser::TextView<char>{t8.data(), t8.data() + t8.size()}), text.toDouble());
+}
+
+void TestOkxFrameParser::toInt64()
+{
+    const auto parse = [](const char *text) {
+        return OkxFrameParser::toInt64(OkxFrameParser::TextView<char>{text, text + qstrlen(text)});
+    };
+    QCOMPARE(parse("1700000000000"), Q_INT64_C(1700000000000));
+    QCOMPARE(parse("-42"), Q_INT64_C(-42));
+    QCOMPARE(parse("9223372036854775807"), std::numeric_limits<qint64>::max());
+    QCOMPARE(parse("99999999999999999999"), std::numeric_limits<qint64>::max());
+    QCOMPARE(parse("-99999999999999999999"), -std::numeric_limits<qint64>::max());
+    QCOMPARE(parse("12ab"), Q_INT64_C(12));   // Stops at the first non-digit
+    QCOMPARE(parse(""), Q_INT64_C(0));
+}
+
+QTEST_GUILESS_MAIN(TestOkxFrameParser)
+#include "tst_okxframeparser.moc"
@@ -0,0 +1,98 @@
+/******************************************************************************
+ * TickConflator.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Implementation of the per-instrument tick conflation stage.
+ ******************************************************************************/
+
+#include "tickconflator.h"
+#include "version.h"
+#include <QDebug>
+
+TickConflator::TickConflator(int intervalMs, QObject *parent)
+    : QObject(parent), m_intervalMs(intervalMs),
+      m_releaseTimer(this)
+{
+    connect(&m_releaseTimer, &QTimer::timeout, this, &TickConflator::release);
+    setInterval(intervalMs);
+}
+
+void TickConflator::setInterval(int intervalMs)
+{
+    m_intervalMs = qMax(0, intervalMs);
+    if (m_intervalMs > 0) {
+        m_releaseTimer.start(m_intervalMs);
+    } else {
+        m_releaseTimer.stop();
+        release();   // Flush whatever was held back before switching to pass-through
+    }
+}
+
+void TickConflator::attachTickQueue(SpscRingBuffer<CryptoCV::OkxTicker> *queue)
+{
+    m_tickQueue = queue;
+    // The queue can only be drained on a timer, so pass-through falls back to one frame
+    if (m_tickQueue && m_intervalMs == 0)
+        setInterval(16);
+}
+
+void TickConflator::onTicker(CryptoCV::OkxTicker tick)
+{
+    absorb(tick);
+    if (m_intervalMs == 0)
+        release();
+}
+
+void TickConflator::absorb(const CryptoCV::OkxTicker &tick)
+{
+    ++m_stats.ticksIn;
+
+    const int id = tick.instrument;
+    if (id < 0) return;
+    if (id >= m_latest.size()) {
+        m_latest.resize(id + 1);
+        m_isDirty.resize(id + 1);
+    }
+    m_latest[id] = tick;   // Overwrite: only the newest state matters for display
+
+    if (!m_isDirty[id]) {
+        m_isDirty[id] = true;
+        m_dirty.append(id);
+    }
+}
+
+void TickConflator::release()
+{
+    if (m_tickQueue) {
+        // Bound the drain so a burst cannot starve painting
+        CryptoCV::OkxTicker tick;
+        std::size_t budget = m_tickQueue->capacity();
+        while (budget-- > 0 && m_tickQueue->pop(tick))
+            absorb(tick);
+    }
+
+    if (m_dirty.isEmpty())
+        return;
+
+    m_batch.clear();
+    m_batch.reserve(m_dirty.size());
+    for (int id : std::as_const(m_dirty)) {
+        m_batch.append(m_latest[id]);
+        m_isDirty[id] = false;
+    }
+    m_dirty.clear();
+
+    m_stats.ticksOut += static_cast<quint64>(m_batch.size());
+    ++m_stats.batches;
+    m_stats.maxBatch = qMax(m_stats.maxBatch, static_cast<int>(m_batch.size()));
+
+#ifdef __DEBUGMODE__
+    if (m_stats.batches % 600 == 0)
+        qDebug() << "Conflation: in" << m_stats.ticksIn << "out" << m_stats.ticksOut
+                 << "ratio" << m_stats.ratio() << "max batch" << m_stats.maxBatch;
+#endif
+
+    emit batchReady(m_batch);
+}
@@ -0,0 +1,93 @@
+/******************************************************************************
+ * TickConflator.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Per-instrument conflation stage between the feed and MarketWatchModel.
+ *   - Keeps only the latest OkxTicker per instrument id between two releases
+ *   - Releases dirty instruments as one batch per cadence (e.g. 16/33/100 ms)
+ *   - In threaded ingest mode also drains the network thread's tick queue
+ *   - Tracks in/out counts so the conflation ratio can be reported
+ ******************************************************************************/
+
+#ifndef TICKCONFLATOR_H
+#define TICKCONFLATOR_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include "protocol.h"
+#include "spscringbuffer.h"
+
+/**
+ * @class TickConflator
+ * @brief Collapses bursts of ticks per instrument and releases them on a fixed cadence.
+ *
+ * Flash direction stays correct without keeping intermediate values: the model
+ * compares the released tick with the row's current values, which are exactly
+ * the values displayed before the burst (the earliest "prev").
+ */
+class TickConflator : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @struct Stats
+     * @brief Running counters; ratio() = ticks in per tick released.
+     */
+    struct Stats {
+        quint64 ticksIn = 0;       ///< Ticks received from the feed
+        quint64 ticksOut = 0;      ///< Ticks released to the model
+        quint64 batches = 0;       ///< Non-empty releases
+        int maxBatch = 0;          ///< Largest single release
+        double ratio() const { return ticksOut ? double(ticksIn) / double(ticksOut) : 1.0; }
+    };
+
+    /**
+     * @param intervalMs Release cadence; 0 forwards every tick immediately (no conflation)
+     */
+    explicit TickConflator(int intervalMs = 16, QObject *parent = nullptr);
+
+    void setInterval(int intervalMs);
+    int interval() const { return m_intervalMs; }
+
+    /**
+     * Threaded ingest: pull ticks from the network thread's queue on every release.
+     */
+    void attachTickQueue(SpscRingBuffer<CryptoCV::OkxTicker> *queue);
+
+    const Stats &stats() const { return m_stats; }
+
+public slots:
+    void onTicker(CryptoCV::OkxTicker tick);
+
+    /**
+     * Emits everything pending now (normally driven by the cadence timer).
+     */
+    void release();
+
+signals:
+    /**
+     * One entry per instrument that changed since the previous release.
+     */
+    void batchReady(const QVector<CryptoCV::OkxTicker> &batch);
+
+private:
+    void absorb(const CryptoCV::OkxTicker &tick);
+
+    int m_intervalMs;
+    QTimer m_releaseTimer;
+    SpscRingBuffer<CryptoCV::OkxTicker> *m_tickQueue = nullptr;
+
+    QVector<CryptoCV::OkxTicker> m_latest;        // Latest tick, indexed by instrument id
+    QVector<int> m_dirty;                         // Ids touched since last release
+    QVector<bool> m_isDirty;
+    QVector<CryptoCV::OkxTicker> m_batch;         // Reused release buffer
+
+    Stats m_stats;
+};
+
+#endif // TICKCONFLATOR_H
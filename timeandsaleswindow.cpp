@@ -0,0 +1,195 @@
+/******************************************************************************
+ * TimeAndSalesWindow.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Implementation of the Time & Sales model and window.
+ ******************************************************************************/
+
+#include "timeandsaleswindow.h"
+#include "instrumentregistry.h"
+#include "websocketconnection.h"
+#include "globals.h"
+#include <QDateTime>
+#include <QHeaderView>
+#include <QVBoxLayout>
+#include <QColor>
+
+// Prints requested from REST to fill the tape behind the live stream
+static const int HISTORY_PRINTS = 100;
+
+// Decimals used until the instrument's tickSz/lotSz are known; trailing zeros are trimmed
+static const int FALLBACK_DECIMALS = 10;
+
+// Fixed-point text with the instrument's native decimals (decimals < 0: unknown)
+static QString formatValue(double value, int decimals)
+{
+    if (decimals >= 0)
+        return QString::number(value, 'f', decimals);
+    QString text = QString::number(value, 'f', FALLBACK_DECIMALS);
+    while (text.endsWith('0'))
+        text.chop(1);
+    if (text.endsWith('.'))
+        text.chop(1);
+    return text;
+}
+
+// Price / size decimals of an instrument from InstrumentRegistry, -1 while unknown
+static void decimalsOf(int instrument, int *priceDecimals, int *sizeDecimals)
+{
+    *priceDecimals = *sizeDecimals = -1;
+    InstrumentRegistry::instance().precision(instrument, priceDecimals, sizeDecimals);
+}
+
+TimeAndSalesModel::TimeAndSalesModel(TradeTapeStore *store, const QString &instId, QObject *parent)
+    : QAbstractTableModel(parent),
+      m_store(store),
+      m_instId(instId),
+      m_instrument(InstrumentRegistry::instance().intern(instId)),
+      m_tape(store->openTape(instId))
+{
+    m_rows = m_tape->size();
+    m_syncedTotal = m_tape->total();
+    connect(m_store, &TradeTapeStore::printsAppended, this, &TimeAndSalesModel::onPrintsAppended);
+    connect(m_store, &TradeTapeStore::tapeReset, this, &TimeAndSalesModel::onTapeReset);
+}
+
+TimeAndSalesModel::~TimeAndSalesModel()
+{
+    m_store->closeTape(m_instId);
+}
+
+int TimeAndSalesModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows;
+}
+
+int TimeAndSalesModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant TimeAndSalesModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) return QVariant();
+
+    // Prints pushed since the last announcement sit in front of the announced rows
+    const int row = index.row() + static_cast<int>(m_tape->total() - m_syncedTotal);
+    if (row >= m_tape->size()) return QVariant();
+    const CryptoCV::TradePrint &p = m_tape->at(row);
+
+    if (role == Qt::DisplayRole) {
+        int priceDecimals, sizeDecimals;
+        decimalsOf(m_instrument, &priceDecimals, &sizeDecimals);
+        switch (index.column()) {
+        case Time:  return QDateTime::fromMSecsSinceEpoch(p.ts).toString("hh:mm:ss.zzz");
+        case Price: return formatValue(p.price, priceDecimals);
+        case Size:  return formatValue(p.size, sizeDecimals);
+        case Side:  return p.buy ? QStringLiteral("Buy") : QStringLiteral("Sell");
+        }
+    } else if (role == Qt::ForegroundRole) {
+        return p.buy ? QColor(Qt::green) : QColor(Qt::red);
+    } else if (role == Qt::TextAlignmentRole && index.column() != Time) {
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    return QVariant();
+}
+
+QVariant TimeAndSalesModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) return QVariant();
+    switch (section) {
+    case Time:  return "Time";
+    case Price: return "Price";
+    case Size:  return "Size";
+    case Side:  return "Side";
+    }
+    return QVariant();
+}
+
+void TimeAndSalesModel::onPrintsAppended(int instrument, int count)
+{
+    if (instrument != m_instrument || count <= 0) return;
+
+    const int added = static_cast<int>(m_tape->total() - m_syncedTotal);
+    if (added >= m_tape->size()) {
+        // The whole visible tape was replaced within one frame
+        onTapeReset(instrument);
+        return;
+    }
+
+    // Oldest rows that fell out of the ring leave from the bottom...
+    const int evicted = m_rows + added - m_tape->size();
+    if (evicted > 0) {
+        beginRemoveRows(QModelIndex(), m_rows - evicted, m_rows - 1);
+        m_rows -= evicted;
+        endRemoveRows();
+    }
+    // ...and the new prints enter at the top as a single insert
+    beginInsertRows(QModelIndex(), 0, added - 1);
+    m_rows += added;
+    m_syncedTotal = m_tape->total();
+    endInsertRows();
+}
+
+void TimeAndSalesModel::onTapeReset(int instrument)
+{
+    if (instrument != m_instrument) return;
+    beginResetModel();
+    m_rows = m_tape->size();
+    m_syncedTotal = m_tape->total();
+    endResetModel();
+}
+
+TimeAndSalesWindow::TimeAndSalesWindow(TradeTapeStore *store, const QString &instId, QWidget *parent)
+    : QDialog(parent),
+      m_instId(instId),
+      m_instrument(InstrumentRegistry::instance().intern(instId))
+{
+    setAttribute(Qt::WA_DeleteOnClose);
+    setWindowTitle("Time & Sales - " + instId);
+    resize(420, 520);
+
+    m_barLabel = new QLabel("1m: -", this);
+    m_model = new TimeAndSalesModel(store, instId, this);
+    m_view = new QTableView(this);
+    m_view->setModel(m_model);
+    m_view->setSelectionMode(QAbstractItemView::NoSelection);
+    m_view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_view->verticalHeader()->hide();
+    // Fixed row height: the view never measures rows, so scrolling a full tape stays cheap
+    m_view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_view->verticalHeader()->setDefaultSectionSize(20);
+    m_view->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+    layout->addWidget(m_barLabel);
+    layout->addWidget(m_view);
+
+    connect(WEB_SOCKET_CONNECTION, &WebSocketConnection::candleUpdated, this, &TimeAndSalesWindow::onCandleUpdated);
+    WEB_SOCKET_CONNECTION->subscribeTrades(m_instId);
+    WEB_SOCKET_CONNECTION->subscribeCandles(m_instId);
+    WEB_SOCKET_CONNECTION->makeApiRequest(CryptoCV::ApiRequestType::RecentTrades, m_instId, HISTORY_PRINTS);
+}
+
+TimeAndSalesWindow::~TimeAndSalesWindow()
+{
+    WEB_SOCKET_CONNECTION->unsubscribeCandles(m_instId);
+    WEB_SOCKET_CONNECTION->unsubscribeTrades(m_instId);
+}
+
+void TimeAndSalesWindow::onCandleUpdated(int instrument, const QString &bar, const CryptoCV::Candle &candle)
+{
+    if (instrument != m_instrument || bar != QLatin1String("1m")) return;
+    int priceDecimals, sizeDecimals;
+    decimalsOf(m_instrument, &priceDecimals, &sizeDecimals);
+    m_barLabel->setText(QString("1m  O %1  H %2  L %3  C %4  Vol %5  VWAP %6  Trades %7")
+                            .arg(formatValue(candle.open, priceDecimals), formatValue(candle.high, priceDecimals),
+                                 formatValue(candle.low, priceDecimals), formatValue(candle.close, priceDecimals),
+                                 formatValue(candle.volume, sizeDecimals),
+                                 // VWAP is an average: one digit finer than a tick
+                                 formatValue(candle.vwap(), priceDecimals < 0 ? -1 : priceDecimals + 1))
+                            .arg(candle.trades));
+}
@@ -0,0 +1,84 @@
+/******************************************************************************
+ * TimeAndSalesWindow.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Time & Sales (trade tape) for one instrument.
+ *   - TimeAndSalesModel reads rows straight from the instrument's TradeTape;
+ *     nothing is copied per print, the view only asks for visible rows
+ *   - Prints arriving in one frame become one row insert at the top
+ *   - TimeAndSalesWindow subscribes the trades channel while it is open and
+ *     shows the instrument's open 1m candle above the tape
+ ******************************************************************************/
+
+#ifndef TIMEANDSALESWINDOW_H
+#define TIMEANDSALESWINDOW_H
+
+#include <QDialog>
+#include <QAbstractTableModel>
+#include <QTableView>
+#include <QLabel>
+#include "tradetape.h"
+
+/**
+ * @class TimeAndSalesModel
+ * @brief Read-only table over a TradeTape, newest print in row 0.
+ */
+class TimeAndSalesModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { Time = 0, Price, Size, Side, ColumnCount };
+
+    /**
+     * @param store  Tape owner; the tape for instId is opened here and closed in the destructor
+     * @param instId Instrument shown
+     */
+    TimeAndSalesModel(TradeTapeStore *store, const QString &instId, QObject *parent = nullptr);
+    ~TimeAndSalesModel() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+private slots:
+    void onPrintsAppended(int instrument, int count);
+    void onTapeReset(int instrument);
+
+private:
+    TradeTapeStore *m_store;
+    QString m_instId;
+    int m_instrument;             // InstrumentRegistry id
+    const TradeTape *m_tape;
+    int m_rows = 0;               // Rows announced to the view
+    quint64 m_syncedTotal = 0;    // tape->total() when m_rows was announced
+};
+
+/**
+ * @class TimeAndSalesWindow
+ * @brief Non-modal tape window; deletes itself on close.
+ */
+class TimeAndSalesWindow : public QDialog
+{
+    Q_OBJECT
+
+public:
+    TimeAndSalesWindow(TradeTapeStore *store, const QString &instId, QWidget *parent = nullptr);
+    ~TimeAndSalesWindow() override;
+
+private slots:
+    void onCandleUpdated(int instrument, const QString &bar, const CryptoCV::Candle &candle);
+
+private:
+    QString m_instId;
+    int m_instrument;
+    QLabel *m_barLabel;
+    QTableView *m_view;
+    TimeAndSalesModel *m_model;
+};
+
+#endif // TIMEANDSALESWINDOW_H
@@ -0,0 +1,148 @@
+/******************************************************************************
+ * TradeTape.cpp
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Implementation of the Time & Sales tapes and their queue drain.
+ ******************************************************************************/
+
+#include "tradetape.h"
+#include "instrumentregistry.h"
+#include <QJsonArray>
+#include <algorithm>
+#include <limits>
+
+int TradeTape::prependHistory(const QVector<CryptoCV::TradePrint> &history)
+{
+    const int room = capacity() - m_size;
+    if (room <= 0 || history.isEmpty()) return 0;
+
+    // Oldest live print bounds what history may add
+    const qint64 oldestId = m_size > 0 ? at(m_size - 1).tradeId : std::numeric_limits<qint64>::max();
+    QVector<CryptoCV::TradePrint> older;
+    for (const CryptoCV::TradePrint &p : history) {
+        if (p.tradeId < oldestId && older.size() < room)
+            older.append(p);
+    }
+    if (older.isEmpty()) return 0;
+
+    // Rebuild oldest -> newest: history (reversed to chronological), then live prints
+    std::vector<CryptoCV::TradePrint> ordered;
+    ordered.reserve(static_cast<std::size_t>(older.size() + m_size));
+    for (int i = older.size() - 1; i >= 0; --i)
+        ordered.push_back(older.at(i));
+    for (int row = m_size - 1; row >= 0; --row)
+        ordered.push_back(at(row));
+
+    std::copy(ordered.begin(), ordered.end(), m_slots.begin());
+    m_size = static_cast<int>(ordered.size());
+    m_head = m_size % capacity();
+    return older.size();
+}
+
+TradeTapeStore::TradeTapeStore(int tapeCapacity, QObject *parent)
+    : QObject(parent),
+      m_tapeCapacity(qMax(1, tapeCapacity)),
+      m_drainTimer(this)
+{
+    m_drainTimer.setInterval(16);   // One drain per frame
+    connect(&m_drainTimer, &QTimer::timeout, this, &TradeTapeStore::drain);
+}
+
+TradeTapeStore::~TradeTapeStore()
+{
+    for (const Entry &e : std::as_const(m_tapes))
+        delete e.tape;
+}
+
+void TradeTapeStore::attachTradeQueue(SpscRingBuffer<CryptoCV::TradePrint> *queue)
+{
+    m_tradeQueue = queue;
+    if (m_tradeQueue) m_drainTimer.start();
+    else m_drainTimer.stop();
+}
+
+const TradeTape *TradeTapeStore::openTape(const QString &instId)
+{
+    const int id = InstrumentRegistry::instance().intern(instId);
+    if (id >= m_tapes.size()) m_tapes.resize(id + 1);
+    Entry &e = m_tapes[id];
+    if (!e.tape) e.tape = new TradeTape(m_tapeCapacity);
+    ++e.refs;
+    return e.tape;
+}
+
+void TradeTapeStore::closeTape(const QString &instId)
+{
+    const int id = InstrumentRegistry::instance().find(instId);
+    if (id < 0 || id >= m_tapes.size() || !m_tapes[id].tape) return;
+    Entry &e = m_tapes[id];
+    if (--e.refs > 0) return;
+    delete e.tape;
+    e = Entry();
+}
+
+TradeTapeStore::Entry *TradeTapeStore::entry(int instrument)
+{
+    if (instrument < 0 || instrument >= m_tapes.size()) return nullptr;
+    Entry &e = m_tapes[instrument];
+    return e.tape ? &e : nullptr;
+}
+
+void TradeTapeStore::drain()
+{
+    if (!m_tradeQueue) return;
+
+    // Bound the drain so a burst cannot starve painting; the rest waits a frame
+    CryptoCV::TradePrint print;
+    std::size_t budget = m_tradeQueue->capacity();
+    while (budget-- > 0 && m_tradeQueue->pop(print)) {
+        ++m_printsIn;
+        Entry *e = entry(print.instrument);
+        if (!e) {
+            ++m_printsDropped;   // Window closed while prints were in flight
+            continue;
+        }
+        e->tape->push(print);
+        if (e->appended++ == 0)
+            m_touched.append(print.instrument);
+    }
+
+    // One notification per instrument per frame, however many prints arrived
+    for (int instrument : std::as_const(m_touched)) {
+        Entry *e = entry(instrument);
+        if (!e) continue;
+        const int count = e->appended;
+        e->appended = 0;
+        emit printsAppended(instrument, count);
+    }
+    m_touched.clear();
+}
+
+void TradeTapeStore::onRecentTrades(QJsonObject obj)
+{
+    const QJsonArray data = obj.value("data").toArray();
+    if (data.isEmpty()) return;
+
+    QVector<CryptoCV::TradePrint> history;
+    history.reserve(data.size());
+    int instrument = -1;
+    for (const QJsonValue &v : data) {
+        const QJsonObject t = v.toObject();
+        CryptoCV::TradePrint p;
+        p.instrument = InstrumentRegistry::instance().intern(t.value("instId").toString());
+        p.tradeId = t.value("tradeId").toString().toLongLong();
+        p.ts = t.value("ts").toString().toLongLong();
+        p.price = t.value("px").toString().toDouble();
+        p.size = t.value("sz").toString().toDouble();
+        p.buy = t.value("side").toString() == QLatin1String("buy");
+        instrument = p.instrument;
+        history.append(p);
+    }
+
+    Entry *e = entry(instrument);
+    if (!e) return;
+    if (e->tape->prependHistory(history) > 0)
+        emit tapeReset(instrument);
+}
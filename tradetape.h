@@ -0,0 +1,151 @@
+/******************************************************************************
+ * TradeTape.h
+ * Author: Rohit Kumar
+ * Contact: rohit312003@gmail.com
+ * Date: 15-10-2026
+ *
+ * Description:
+ *   Time & Sales storage on the GUI thread.
+ *   - TradeTape: fixed-capacity ring of prints for one instrument; the newest
+ *     print overwrites the oldest, so the tape never allocates after creation
+ *   - TradeTapeStore: drains the network thread's trade queue once per frame
+ *     into the open tapes and tells the views how many prints were appended
+ ******************************************************************************/
+
+#ifndef TRADETAPE_H
+#define TRADETAPE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include <QJsonObject>
+#include <vector>
+#include "protocol.h"
+#include "spscringbuffer.h"
+
+/**
+ * @class TradeTape
+ * @brief Ring of the last N trades of one instrument, indexed newest-first.
+ */
+class TradeTape
+{
+public:
+    explicit TradeTape(int capacity)
+        : m_slots(static_cast<std::size_t>(qMax(1, capacity))) {}
+
+    /**
+     * Appends a print, overwriting the oldest when full.
+     */
+    void push(const CryptoCV::TradePrint &print)
+    {
+        m_slots[static_cast<std::size_t>(m_head)] = print;
+        m_head = (m_head + 1) % capacity();
+        if (m_size < capacity()) ++m_size;
+        ++m_total;
+    }
+
+    /**
+     * Print at row (0 = newest). No bounds check.
+     */
+    const CryptoCV::TradePrint &at(int row) const
+    {
+        int index = m_head - 1 - row;
+        if (index < 0) index += capacity();
+        return m_slots[static_cast<std::size_t>(index)];
+    }
+
+    int size() const { return m_size; }
+    int capacity() const { return static_cast<int>(m_slots.size()); }
+    quint64 total() const { return m_total; }   ///< Prints pushed since creation
+
+    /**
+     * Adds REST history behind the live prints (only trades older than the
+     * oldest print kept, so nothing is shown twice).
+     * @param history Newest-first, as returned by /api/v5/market/trades
+     * @return Number of prints added
+     */
+    int prependHistory(const QVector<CryptoCV::TradePrint> &history);
+
+private:
+    std::vector<CryptoCV::TradePrint> m_slots;
+    int m_head = 0;          // Next slot to write
+    int m_size = 0;
+    quint64 m_total = 0;
+};
+
+/**
+ * @class TradeTapeStore
+ * @brief Owns the open tapes and feeds them from the trade queue (GUI thread).
+ */
+class TradeTapeStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param tapeCapacity Prints kept per instrument (Feed/tapeCapacity)
+     */
+    explicit TradeTapeStore(int tapeCapacity, QObject *parent = nullptr);
+    ~TradeTapeStore() override;
+
+    /**
+     * Sets the network -> GUI trade queue and starts draining it every frame.
+     */
+    void attachTradeQueue(SpscRingBuffer<CryptoCV::TradePrint> *queue);
+
+    /**
+     * Returns the tape for instId, creating it on first use (reference counted).
+     */
+    const TradeTape *openTape(const QString &instId);
+
+    /**
+     * Releases one reference; the tape is dropped with the last one.
+     */
+    void closeTape(const QString &instId);
+
+    quint64 printsIn() const { return m_printsIn; }
+    quint64 printsDropped() const { return m_printsDropped; }   ///< No tape open for the instrument
+
+public slots:
+    /**
+     * Moves every queued print into its tape (bounded per call).
+     */
+    void drain();
+
+    /**
+     * REST /api/v5/market/trades reply: fills the tape behind the live prints.
+     */
+    void onRecentTrades(QJsonObject obj);
+
+signals:
+    /**
+     * @param instrument InstrumentRegistry id of the tape
+     * @param count      Prints appended since the previous signal
+     */
+    void printsAppended(int instrument, int count);
+
+    /**
+     * Older history was inserted; views reload the tape.
+     */
+    void tapeReset(int instrument);
+
+private:
+    struct Entry {
+        TradeTape *tape = nullptr;
+        int refs = 0;
+        int appended = 0;   // Since the last printsAppended
+    };
+
+    // Open tape of an instrument, nullptr if none
+    Entry *entry(int instrument);
+
+    int m_tapeCapacity;
+    SpscRingBuffer<CryptoCV::TradePrint> *m_tradeQueue = nullptr;
+    QTimer m_drainTimer;
+    QVector<Entry> m_tapes;    // Indexed by instrument id
+    QVector<int> m_touched;    // Instruments with prints this drain (reused)
+    quint64 m_printsIn = 0;
+    quint64 m_printsDropped = 0;
+};
+
+#endif // TRADETAPE_H
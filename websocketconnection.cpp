@@ -4,47 +4,227 @@
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QJsonParseError>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QUrlQuery>
+#include <limits>
+#include "okxframeparser.h"
+#include "instrumentregistry.h"
+#include "feedjournal.h"
+#include "latencyrecorder.h"
+#include "metricsregistry.h"
+#include "feedshard.h"
+#include "version.h"
 #include"mainwindow.h"
 #include"globals.h"
 #include"configmanager.h"
 
+// OKX rejects op frames above 64 KB; stay well below and cap args per frame
+static const int MAX_OP_FRAME_BYTES = 32 * 1024;
+static const int MAX_OP_ARGS = 100;
+
+// Levels per side carried by orderBookUpdated
+static const int BOOK_PUBLISH_LEVELS = 20;
+// Largest side of any book channel (books = 400 levels)
+static const int MAX_BOOK_LEVELS = 400;
+// REST bars requested per timeframe when candles are enabled (OKX maximum per call)
+static const int CANDLE_BACKFILL_BARS = 300;
+// As-fast-as-possible replay yields to the event loop after this much work
+static const qint64 REPLAY_SLICE_NS = 8 * 1000 * 1000;
+// Exchange clock offset: one /public/time round-trip per interval, best RTT of the last N kept
+static const int CLOCK_SYNC_INTERVAL_MS = 30 * 1000;
+static const int CLOCK_SYNC_SAMPLES = 8;
+
+// OKX instType for the bulk tickers endpoint, derived from the instId shape:
+// BTC-USDT (SPOT), BTC-USDT-SWAP (SWAP), BTC-USD-250328 (FUTURES).
+// Options (BTC-USD-250328-50000-C) return empty: the bulk call needs an underlying.
+static QString instTypeOf(const QString &instId)
+{
+    const QStringList parts = instId.split('-');
+    if (parts.size() == 2) return QStringLiteral("SPOT");
+    if (parts.size() == 3 && parts.last() == QLatin1String("SWAP")) return QStringLiteral("SWAP");
+    if (parts.size() == 3) return QStringLiteral("FUTURES");
+    return QString();
+}
+
 WebSocketConnection::WebSocketConnection(const QUrl &url, QObject *parent)
-    : QObject(parent), m_url(url)
+    : QObject(parent),
+      // Members are parented so moveToThread() carries them to the ingest thread
+      m_networkManager(this),
+      m_url(url),
+      m_restBase(ConfigManager::instance().getRestUrl()),
+      m_statsTimer(this),
+      m_seedTimer(this),
+      m_bookPublishTimer(this),
+      m_candles(ConfigManager::instance().getCandleHistory()),
+      m_candlePublishTimer(this),
+      m_replayTimer(this),
+      m_clockSyncTimer(this)
 {
     qRegisterMetaType<CryptoCV::OkxTicker>();
+    qRegisterMetaType<QVector<CryptoCV::FeedShardStats>>();
+    qRegisterMetaType<CryptoCV::OrderBookDepth>();
+    qRegisterMetaType<CryptoCV::Candle>();
+
+    // ---- WebSocket pool: N independent sessions, one merged tick stream ----
+    const int shardCount = qMax(1, ConfigManager::instance().getFeedShardCount());
+    m_balanceByLoad = ConfigManager::instance().getFeedShardPolicy() == QLatin1String("load");
+    m_maxPerShard = qMax(0, ConfigManager::instance().getMaxInstrumentsPerShard());
+    for (int i = 0; i < shardCount; ++i)
+        addShard();
+
+    m_statsTimer.setInterval(1000);
+    connect(&m_statsTimer, &QTimer::timeout, this, &WebSocketConnection::onStatsTimeout);
+
+    m_seedTimer.setSingleShot(true);
+    m_seedTimer.setInterval(50);
+    connect(&m_seedTimer, &QTimer::timeout, this, &WebSocketConnection::onSeedTimeout);
+
+    // Book scratch buffers sized for a full snapshot so parsing never reallocates
+    m_bookBids.reserve(MAX_BOOK_LEVELS);
+    m_bookAsks.reserve(MAX_BOOK_LEVELS);
+    m_bookPublishTimer.setInterval(100);
+    connect(&m_bookPublishTimer, &QTimer::timeout, this, &WebSocketConnection::onBookPublishTimeout);
+    m_candlePublishTimer.setInterval(250);
+    connect(&m_candlePublishTimer, &QTimer::timeout, this, &WebSocketConnection::onCandlePublishTimeout);
 
-    connect(&m_socket, &QWebSocket::connected, this, &WebSocketConnection::onConnected);
-    connect(&m_socket, &QWebSocket::disconnected, this, &WebSocketConnection::onDisconnected);
-    connect(&m_socket, &QWebSocket::textMessageReceived, this, &WebSocketConnection::onTextMessageReceived);
-    connect(&m_socket, QOverload<QAbstractSocket::SocketError>::of(&QWebSocket::error), this, &WebSocketConnection::onSocketError);
+    // Capture / replay (Feed/recordFile, Feed/replayFile)
+    const QString recordFile = ConfigManager::instance().getRecordFile();
+    if (!recordFile.isEmpty() && m_journal.open(recordFile))
+        qDebug() << "Recording feed to" << recordFile;
+    m_replayTimer.setSingleShot(true);
+    m_replayTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_replayTimer, &QTimer::timeout, this, &WebSocketConnection::onReplayTimeout);
+    m_clockSyncTimer.setInterval(CLOCK_SYNC_INTERVAL_MS);
+    connect(&m_clockSyncTimer, &QTimer::timeout, this, &WebSocketConnection::onClockSyncTimeout);
 
-    connect(this,SIGNAL(tickerReceived(CryptoCV::OkxTicker)), MAIN_WWINDOW_PTR->marketWatchDockWindowPtr->model,SLOT(onBrodcastRcv(CryptoCV::OkxTicker)));
+    connect(this,SIGNAL(tickerReceived(CryptoCV::OkxTicker)), MAIN_WWINDOW_PTR->marketWatchDockWindowPtr->conflator,SLOT(onTicker(CryptoCV::OkxTicker)));
     connect(this,SIGNAL(orderBookReceived(QJsonObject)), MAIN_WWINDOW_PTR->marketWatchDockWindowPtr,SLOT(onTableDoubleClickedResponse(QJsonObject)));
+    connect(this,SIGNAL(recentTradesReceived(QJsonObject)), MAIN_WWINDOW_PTR->marketWatchDockWindowPtr->tradeTapes,SLOT(onRecentTrades(QJsonObject)));
+    // Rows added to or removed from the watch come back as one bulk ticker (un)subscribe per batch
+    connect(MAIN_WWINDOW_PTR->marketWatchDockWindowPtr->model, &MarketWatchModel::subscribeRequested, this, &WebSocketConnection::subscribeTickers);
+    connect(MAIN_WWINDOW_PTR->marketWatchDockWindowPtr->model, &MarketWatchModel::unsubscribeRequested, this, &WebSocketConnection::unsubscribeTickers);
+    // Instrument precision metadata re-formats the rows it affects
+    connect(this, &WebSocketConnection::instrumentSpecsReceived, MAIN_WWINDOW_PTR->marketWatchDockWindowPtr->model, &MarketWatchModel::onInstrumentSpecs);
 
+    // Trades always go through a queue: bursts of prints never become per-print signals
+    m_tradeQueue.reset(new SpscRingBuffer<CryptoCV::TradePrint>(
+        static_cast<std::size_t>(qMax(2, ConfigManager::instance().getTradeQueueCapacity()))));
+    MAIN_WWINDOW_PTR->marketWatchDockWindowPtr->tradeTapes->attachTradeQueue(m_tradeQueue.get());
 
-    m_reconnectTimer.setInterval(5000);
-    connect(&m_reconnectTimer, &QTimer::timeout, this, [this]() {
-        if (m_reconnectAttempts < m_maxReconnectAttempts) {
-            qDebug() << "Attempting to reconnect..." << m_reconnectAttempts + 1;
-            m_reconnectAttempts++;
-            connectToServer();
-        } else {
-            emit errorOccured("Reconnect attempts exhausted");
-            m_reconnectTimer.stop();
-        }
+
+    if (ConfigManager::instance().getThreadedIngest())
+        startIngestThread();
+}
+
+void WebSocketConnection::startIngestThread()
+{
+    m_tickQueue.reset(new SpscRingBuffer<CryptoCV::OkxTicker>(
+        static_cast<std::size_t>(qMax(2, ConfigManager::instance().getTickQueueCapacity()))));
+    MAIN_WWINDOW_PTR->marketWatchDockWindowPtr->conflator->attachTickQueue(m_tickQueue.get());
+
+    m_ingestThread = new QThread();
+    m_ingestThread->setObjectName("OkxIngest");
+    moveToThread(m_ingestThread);
+    m_ingestThread->start();
+
+    // Stop the event loop cleanly before QApplication tears down
+    QThread *thread = m_ingestThread;
+    connect(qApp, &QCoreApplication::aboutToQuit, qApp, [thread]() {
+        thread->quit();
+        thread->wait();
     });
+    qDebug() << "Threaded ingest enabled, tick queue capacity" << m_tickQueue->capacity();
+}
 
-    m_pingTimer.setInterval(25000);
-    connect(&m_pingTimer, &QTimer::timeout, this, &WebSocketConnection::onPingTimeout);
+void WebSocketConnection::publishTicker(const CryptoCV::OkxTicker &ticker)
+{
+    if (m_tickQueue) {
+        m_tickQueue->push(ticker);   // Full queue: counted as a drop, GUI catches up next frame
+        return;
+    }
+    emit tickerReceived(ticker);
 }
 
 // --- WebSocket Methods ---
 
 void WebSocketConnection::connectToServer()
 {
-    if (m_socket.state() == QAbstractSocket::ConnectedState) return;
-    qDebug() << "Connecting to" << m_url.toString();
-    m_socket.open(m_url);
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this]() { connectToServer(); });
+        return;
+    }
+    const QString replayFile = ConfigManager::instance().getReplayFile();
+    if (!replayFile.isEmpty()) {
+        startReplay(replayFile, ConfigManager::instance().getReplaySpeed());
+        return;
+    }
+    for (FeedShard *shard : std::as_const(m_shards))
+        shard->connectToServer();
+    if (!m_statsTimer.isActive()) {
+        m_statsClock.start();
+        m_statsTimer.start();
+    }
+    if (!m_clockSyncTimer.isActive()) {
+        onClockSyncTimeout();
+        m_clockSyncTimer.start();
+    }
+}
+
+void WebSocketConnection::addShard()
+{
+    FeedShard *shard = new FeedShard(m_shards.size(), m_url, this);
+    shard->setReconnectPolicy(ConfigManager::instance().getFeedStaleSeconds(),
+                              ConfigManager::instance().getFeedQuietSeconds(),
+                              ConfigManager::instance().getReconnectMaxBackoffMs());
+    connect(shard, &FeedShard::connected, this, &WebSocketConnection::onShardConnected);
+    connect(shard, &FeedShard::quiet, this, &WebSocketConnection::onShardQuiet);
+    connect(shard, &FeedShard::disconnected, this, &WebSocketConnection::disconnected);
+    connect(shard, &FeedShard::errorOccured, this, &WebSocketConnection::errorOccured);
+    connect(shard, &FeedShard::textMessageReceived, this, &WebSocketConnection::onTextMessageReceived);
+    m_shards.append(shard);
+    if (m_statsTimer.isActive())   // Pool already connected: subscribes its set in onShardConnected
+        shard->connectToServer();
+}
+
+void WebSocketConnection::reserveShards(int instruments)
+{
+    if (m_maxPerShard <= 0) return;
+    const int needed = (instruments + m_maxPerShard - 1) / m_maxPerShard;
+    if (needed <= m_shards.size()) return;
+    qDebug() << "Feed pool grows from" << m_shards.size() << "to" << needed << "shards for" << instruments << "instruments";
+    while (m_shards.size() < needed)
+        addShard();
+}
+
+FeedShard *WebSocketConnection::shardFor(const QString &instId)
+{
+    auto it = m_shardOf.constFind(instId);
+    if (it != m_shardOf.cend()) {
+        it.value()->addInstrument(instId);   // Back after an unsubscribeTickers
+        return it.value();
+    }
+
+    FeedShard *shard = nullptr;
+    if (m_balanceByLoad) {
+        // Least-loaded shard; ties go to the lowest index
+        for (FeedShard *s : std::as_const(m_shards)) {
+            if (!shard || s->load() < shard->load())
+                shard = s;
+        }
+    } else {
+        // Seed 0 keeps the mapping stable across runs; a full shard overflows to the least loaded
+        shard = m_shards.at(static_cast<int>(qHash(instId, 0) % uint(m_shards.size())));
+        if (m_maxPerShard > 0 && shard->load() >= m_maxPerShard) {
+            for (FeedShard *s : std::as_const(m_shards)) {
+                if (s->load() < shard->load())
+                    shard = s;
+            }
+        }
+    }
+    shard->addInstrument(instId);
+    m_shardOf.insert(instId, shard);
+    return shard;
 }
 
 void WebSocketConnection::subscribeTicker(const QString &instId)
@@ -55,211 +235,731 @@ void WebSocketConnection::subscribeTicker(const QString &instId)
 void WebSocketConnection::subscribeTickers(const QStringList &instIds)
 {
     if (instIds.isEmpty()) return;
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, instIds]() { subscribeTickers(instIds); });
+        return;
+    }
 
-    QJsonArray args;
+    // A bulk subscribe (the "All instruments" universe) can outgrow the pool: size it first
+    int incoming = 0;
+    for (const QString &id : instIds) {
+        if (!m_tickerRefs.contains(id)) ++incoming;
+    }
+    reserveShards(int(m_tickerRefs.size()) + incoming);
+
+    QHash<FeedShard*, QStringList> idsByShard;
+    QStringList valid;
     for (const QString &id : instIds) {
         if (id.isEmpty() || !id.contains('-')) {
             qWarning() << "Invalid instId format:" << id << ". Should be like 'BTC-USDT'.";
             continue;
         }
 
-        // 1. Fetch the initial snapshot via REST API.
-        // This is a non-blocking call. The reply will be handled asynchronously in onRestReply.
-        qDebug() << "Fetching initial snapshot for" << id;
-        fetchTickerSnapshot(id);
+        // 1. Group the instrument under the shard it is routed to; the channel is
+        // shared by every view showing the instrument (reference counted).
+        if (m_tickerRefs[id]++ == 0)
+            idsByShard[shardFor(id)] << id;
+        valid << id;
+    }
+
+    // 2. Seed the initial values from one bulk REST snapshot per instType.
+    // This is a non-blocking call. The reply will be handled asynchronously in onRestReply.
+    seedTickerSnapshots(valid);
+
+    // 3. Send chunked subscription messages per connected shard over its WebSocket.
+    // A shard that is still connecting subscribes its whole set in onShardConnected.
+    for (auto it = idsByShard.cbegin(); it != idsByShard.cend(); ++it) {
+        if (it.key()->isConnected())
+            sendChannelOp(it.key(), QStringLiteral("subscribe"), QStringLiteral("tickers"), it.value());
+    }
+}
+
+void WebSocketConnection::unsubscribeTickers(const QStringList &instIds)
+{
+    if (instIds.isEmpty()) return;
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, instIds]() { unsubscribeTickers(instIds); });
+        return;
+    }
+
+    // The instrument keeps its shard (books/trades stay routed there); it only
+    // leaves the shard's ticker set, so a reconnect does not resubscribe it
+    QHash<FeedShard*, QStringList> idsByShard;
+    for (const QString &id : instIds) {
+        auto ref = m_tickerRefs.find(id);
+        if (ref == m_tickerRefs.end() || --ref.value() > 0) continue;
+        m_tickerRefs.erase(ref);
+        FeedShard *shard = m_shardOf.value(id);
+        if (!shard) continue;
+        shard->removeInstrument(id);
+        idsByShard[shard] << id;
+    }
+
+    for (auto it = idsByShard.cbegin(); it != idsByShard.cend(); ++it) {
+        if (it.key()->isConnected())
+            sendChannelOp(it.key(), QStringLiteral("unsubscribe"), QStringLiteral("tickers"), it.value());
+    }
+}
+
+void WebSocketConnection::sendChannelOp(FeedShard *shard, const QString &op, const QString &channel,
+                                        const QStringList &instIds)
+{
+    QJsonArray args;
+    QStringList keys;
+    int frameBytes = 0;
+
+    auto flush = [&]() {
+        if (args.isEmpty()) return;
+        const QString requestId = QString::number(++m_nextRequestId);
+        QJsonObject obj;
+        obj["id"] = requestId;
+        obj["op"] = op;
+        obj["args"] = args;
+        shard->sendJson(obj);
+        if (op == QLatin1String("subscribe"))
+            m_pendingOps.insert(requestId, keys);
+        args = QJsonArray();
+        keys.clear();
+        frameBytes = 0;
+    };
+
+    for (const QString &instId : instIds) {
+        // {"channel":"","instId":""}, plus the names themselves
+        const int argBytes = 26 + channel.size() + instId.size();
+        if (!args.isEmpty() && (frameBytes + argBytes > MAX_OP_FRAME_BYTES || args.size() >= MAX_OP_ARGS))
+            flush();
 
-        // 2. Prepare the WebSocket subscription message argument.
         QJsonObject a;
-        a["channel"] = "tickers";
-        a["instId"] = id;
+        a["channel"] = channel;
+        a["instId"] = instId;
         args.append(a);
+        frameBytes += argBytes;
+
+        const QString key = channel + ':' + instId;
+        keys << key;
+        if (op == QLatin1String("subscribe"))
+            m_subscriptions.insert(key, CryptoCV::SubscriptionState::Pending);
+        else
+            m_subscriptions.remove(key);
     }
+    flush();
+}
 
-    if(args.isEmpty()) return;
+void WebSocketConnection::onSubscribeAck(const QString &requestId, const QString &channel, const QString &instId)
+{
+    const QString key = channel + ':' + instId;
+    m_subscriptions.insert(key, CryptoCV::SubscriptionState::Subscribed);
+    ++m_subscribeAcks;
+    MetricsRegistry::instance().subscribeAcks.add();
 
-    // 3. Send the full subscription message over the WebSocket.
-    // This is also non-blocking and allows live updates to start arriving.
-    QJsonObject obj;
-    obj["op"] = "subscribe";
-    obj["args"] = args;
-    sendJson(obj);
+    auto it = m_pendingOps.find(requestId);
+    if (it != m_pendingOps.end()) {
+        it.value().removeOne(key);
+        if (it.value().isEmpty())
+            m_pendingOps.erase(it);
+    }
+    emit subscriptionAcked(channel, instId);
 }
 
-void WebSocketConnection::sendJson(const QJsonObject &obj)
+void WebSocketConnection::onSubscribeError(const QString &requestId, const QString &error)
 {
-    if (m_socket.state() != QAbstractSocket::ConnectedState) {
-        qWarning() << "WebSocket not connected - cannot send message.";
-        return;
+    ++m_subscribeErrors;
+    MetricsRegistry::instance().subscribeErrors.add();
+
+    // Every channel of the rejected request that has not been acknowledged yet failed
+    const QStringList keys = m_pendingOps.take(requestId);
+    for (const QString &key : keys) {
+        m_subscriptions.insert(key, CryptoCV::SubscriptionState::Failed);
+        const int sep = key.indexOf(':');
+        emit subscriptionFailed(key.left(sep), key.mid(sep + 1), error);
     }
-    QJsonDocument doc(obj);
-    m_socket.sendTextMessage(QString::fromUtf8(doc.toJson(QJsonDocument::Compact)));
 }
 
-void WebSocketConnection::onConnected()
+void WebSocketConnection::onShardQuiet()
 {
-    qDebug() << "WebSocket connected successfully.";
-    m_reconnectAttempts = 0;
-    m_reconnectTimer.stop();
-    m_pingTimer.start();
+    FeedShard *shard = qobject_cast<FeedShard*>(sender());
+    if (!shard || !shard->isConnected()) return;
+
+    // Unsubscribe + subscribe makes OKX push the current ticker of every
+    // instrument, so a shard that is merely illiquid proves itself alive
+    const QStringList symbols(shard->instruments().cbegin(), shard->instruments().cend());
+    if (symbols.isEmpty()) return;
+    sendChannelOp(shard, QStringLiteral("unsubscribe"), QStringLiteral("tickers"), symbols);
+    sendChannelOp(shard, QStringLiteral("subscribe"), QStringLiteral("tickers"), symbols);
+}
+
+void WebSocketConnection::onShardConnected()
+{
+    FeedShard *shard = qobject_cast<FeedShard*>(sender());
+    if (!shard) return;
     emit connected();
 
-    // ---- Resubscribe all symbols from INI ----
-    QSettings settings(ConfigManager::instance().configPath(), QSettings::IniFormat);
-    settings.beginGroup("MarketWatch/CryptoRows");
-    QStringList symbolList = settings.value("symbols").toStringList();
-    settings.endGroup();
+    // ---- Resubscribe this shard's instruments from memory ----
+    // No INI read and no REST re-seed: the first tickers push after subscribe
+    // carries the full current state, and stale snapshots would be dropped anyway.
+    const QStringList symbols(shard->instruments().cbegin(), shard->instruments().cend());
+    if (!symbols.isEmpty()) {
+        sendChannelOp(shard, QStringLiteral("subscribe"), QStringLiteral("tickers"), symbols);
+        qDebug() << "Shard" << shard->index() << "resubscribed" << symbols.size() << "tokens after reconnect";
+    }
 
-    if (!symbolList.isEmpty()) {
-        subscribeTickers(symbolList); // your subscribe method: takes QStringList of symbols
-        qDebug() << "Resubscribed tokens after reconnect:" << symbolList;
+    // Book and trades channels; books restart from the snapshot sent after subscribe
+    QHash<QString, QStringList> idsByChannel;
+    for (const QString &key : shard->channels()) {
+        const int sep = key.indexOf(':');
+        const QString channel = key.left(sep);
+        const QString instId = key.mid(sep + 1);
+        if (OrderBookEngine::isBookChannel(reinterpret_cast<const char16_t *>(channel.utf16()), channel.size()))
+            m_books.open(instId, channel);
+        idsByChannel[channel] << instId;
     }
+    for (auto it = idsByChannel.cbegin(); it != idsByChannel.cend(); ++it)
+        sendChannelOp(shard, QStringLiteral("subscribe"), it.key(), it.value());
 }
 
+// --- Streaming order books ---
+
+FeedShard *WebSocketConnection::bookShardFor(const QString &instId) const
+{
+    FeedShard *shard = m_shardOf.value(instId);
+    if (!shard)
+        shard = m_shards.at(static_cast<int>(qHash(instId, 0) % uint(m_shards.size())));
+    return shard;
+}
 
-void WebSocketConnection::onDisconnected()
+void WebSocketConnection::subscribeOrderBook(const QString &instId, const QString &channel)
 {
-    qDebug() << "WebSocket disconnected.";
-    m_pingTimer.stop();
-    emit disconnected();
-    if (!m_reconnectTimer.isActive()) {
-        m_reconnectTimer.start();
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, instId, channel]() { subscribeOrderBook(instId, channel); });
+        return;
+    }
+    const QString ch = channel.isEmpty() ? ConfigManager::instance().getOrderBookChannel() : channel;
+    const char16_t *chars = reinterpret_cast<const char16_t *>(ch.utf16());
+    if (!OrderBookEngine::isBookChannel(chars, ch.size())) {
+        qWarning() << "Not an order book channel:" << ch;
+        return;
     }
+
+    FeedShard *shard = bookShardFor(instId);
+    shard->addChannel(ch + ':' + instId);
+    m_books.open(instId, ch);
+    if (shard->isConnected())
+        sendChannelOp(shard, QStringLiteral("subscribe"), ch, QStringList() << instId);
+    if (!m_bookPublishTimer.isActive())
+        m_bookPublishTimer.start();
 }
 
-void WebSocketConnection::onPingTimeout()
+void WebSocketConnection::unsubscribeOrderBook(const QString &instId, const QString &channel)
 {
-    if (m_socket.state() == QAbstractSocket::ConnectedState) {
-        qDebug() << "Sending ping to server...";
-        m_socket.sendTextMessage("ping");
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, instId, channel]() { unsubscribeOrderBook(instId, channel); });
+        return;
     }
+    const QString ch = channel.isEmpty() ? ConfigManager::instance().getOrderBookChannel() : channel;
+    FeedShard *shard = bookShardFor(instId);
+    shard->removeChannel(ch + ':' + instId);
+    m_books.close(instId, ch);
+    if (shard->isConnected())
+        sendChannelOp(shard, QStringLiteral("unsubscribe"), ch, QStringList() << instId);
+    if (m_books.bookCount() == 0)
+        m_bookPublishTimer.stop();
 }
 
-void WebSocketConnection::onTextMessageReceived(const QString &msg)
+void WebSocketConnection::subscribeTrades(const QString &instId)
 {
-    if (msg == "pong") {
-        qDebug() << "Received pong from server.";
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, instId]() { subscribeTrades(instId); });
         return;
     }
+    if (m_tradeRefs[instId]++ > 0) return;
 
-    QJsonParseError err;
-    QJsonDocument doc = QJsonDocument::fromJson(msg.toUtf8(), &err);
-    if (err.error != QJsonParseError::NoError) {
-        qWarning() << "JSON parse error:" << err.errorString() << "Original message:" << msg;
+    FeedShard *shard = bookShardFor(instId);
+    shard->addChannel(QStringLiteral("trades:") + instId);
+    if (shard->isConnected())
+        sendChannelOp(shard, QStringLiteral("subscribe"), QStringLiteral("trades"), QStringList() << instId);
+}
+
+void WebSocketConnection::unsubscribeTrades(const QString &instId)
+{
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, instId]() { unsubscribeTrades(instId); });
         return;
     }
-    if (!doc.isObject()) return;
+    auto it = m_tradeRefs.find(instId);
+    if (it == m_tradeRefs.end() || --it.value() > 0) return;
+    m_tradeRefs.erase(it);
 
-    QJsonObject obj = doc.object();
+    FeedShard *shard = bookShardFor(instId);
+    shard->removeChannel(QStringLiteral("trades:") + instId);
+    if (shard->isConnected())
+        sendChannelOp(shard, QStringLiteral("unsubscribe"), QStringLiteral("trades"), QStringList() << instId);
+}
+
+void WebSocketConnection::subscribeCandles(const QString &instId)
+{
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, instId]() { subscribeCandles(instId); });
+        return;
+    }
+    if (m_candleRefs[instId]++ > 0) return;
+
+    // Live prints first, then history: prints are buffered until each backfill
+    // reply and those after its snapshot re-applied (see CandleAggregator::applyBackfill)
+    m_candles.open(InstrumentRegistry::instance().intern(instId));
+    subscribeTrades(instId);
+    for (int tf = 0; tf < CandleAggregator::TIMEFRAME_COUNT; ++tf)
+        makeApiRequest(CryptoCV::ApiRequestType::Candles, instId, CANDLE_BACKFILL_BARS, CandleAggregator::barName(tf));
+    if (!m_candlePublishTimer.isActive())
+        m_candlePublishTimer.start();
+}
+
+void WebSocketConnection::unsubscribeCandles(const QString &instId)
+{
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, instId]() { unsubscribeCandles(instId); });
+        return;
+    }
+    auto it = m_candleRefs.find(instId);
+    if (it == m_candleRefs.end() || --it.value() > 0) return;
+    m_candleRefs.erase(it);
+
+    m_candles.close(InstrumentRegistry::instance().find(instId));
+    unsubscribeTrades(instId);
+    if (m_candleRefs.isEmpty())
+        m_candlePublishTimer.stop();
+}
+
+void WebSocketConnection::onCandlePublishTimeout()
+{
+    m_candles.forEachDirty([this](int instrument, int timeframe, const CryptoCV::Candle &candle) {
+        emit candleUpdated(instrument, CandleAggregator::barName(timeframe), candle);
+    });
+}
+
+void WebSocketConnection::resyncOrderBook(const OrderBookEngine::Book &book)
+{
+    qWarning() << "Order book" << book.channel << book.instId << "out of sync, resubscribing";
+    FeedShard *shard = bookShardFor(book.instId);
+    if (!shard->isConnected()) return;   // onShardConnected resubscribes
+    const QStringList ids = QStringList() << book.instId;
+    sendChannelOp(shard, QStringLiteral("unsubscribe"), book.channel, ids);
+    sendChannelOp(shard, QStringLiteral("subscribe"), book.channel, ids);
+}
+
+void WebSocketConnection::onBookPublishTimeout()
+{
+    m_books.forEachDirty([this](const OrderBookEngine::Book &book) {
+        emit orderBookUpdated(OrderBookEngine::topLevels(book, BOOK_PUBLISH_LEVELS));
+    });
+}
+
+// Fills out with the [px, sz, liq, orders] levels of one book side
+template <typename Char>
+static void readBookLevels(const OkxFrameParser::TextView<Char> &side, std::vector<OrderBookEngine::Level> &out)
+{
+    out.clear();   // Keeps capacity
+    OkxFrameParser::LevelCursor<Char> cursor(side);
+    OkxFrameParser::TextView<Char> price, size, orders;
+    while (cursor.next(price, size, orders)) {
+        OrderBookEngine::Level level;
+        int priceDecimals = 0, sizeDecimals = 0;
+        if (!OkxFrameParser::parseDecimal(price, level.price, priceDecimals)
+                || !OkxFrameParser::parseDecimal(size, level.size, sizeDecimals))
+            continue;
+        level.priceDecimals = static_cast<qint8>(priceDecimals);
+        level.sizeDecimals = static_cast<qint8>(sizeDecimals);
+        level.orders = static_cast<qint32>(OkxFrameParser::toInt64(orders));
+        out.push_back(level);
+    }
+}
+
+InstrumentRegistry::Cache &WebSocketConnection::instrumentCache(FeedShard *source)
+{
+    return source ? source->instrumentCache() : m_instrumentCache;
+}
+
+template <typename Char>
+void WebSocketConnection::handleBookFrame(const OkxFrameParser::Frame<Char> &frame, FeedShard *source)
+{
+    const int instrument = instrumentCache(source).intern(frame.instId.begin, frame.instId.size());
+    OrderBookEngine::Book *book = m_books.find(instrument, frame.channel.begin, frame.channel.size());
+    if (!book) return;   // In flight after unsubscribeOrderBook
+
+    // books sends action=snapshot/update; books5 and bbo-tbt push full books without action
+    const bool isUpdate = frame.action.equals("update");
+
+    OkxFrameParser::RecordCursor<Char> cursor(frame);
+    OkxFrameParser::TextView<Char> record;
+    while (cursor.next(record)) {
+        OkxFrameParser::BookRecord<Char> rec;
+        if (!OkxFrameParser::parseBookRecord(record, rec))
+            continue;
+        readBookLevels(rec.bids, m_bookBids);
+        readBookLevels(rec.asks, m_bookAsks);
+
+        const qint64 ts = OkxFrameParser::toInt64(rec.ts);
+        const qint64 seqId = rec.seqId.isEmpty() ? -1 : OkxFrameParser::toInt64(rec.seqId);
+        const bool hasChecksum = !rec.checksum.isEmpty();
+        const qint32 checksum = static_cast<qint32>(OkxFrameParser::toInt64(rec.checksum));
+        if (source) source->noteExchangeTs(ts);
 
-    if (obj.contains("event")) {
-        QString event = obj.value("event").toString();
-        if (event == "error") {
-            QString errMsg = obj.value("msg").toString();
+        OrderBookEngine::Result result;
+        if (isUpdate) {
+            const qint64 prevSeqId = rec.prevSeqId.isEmpty() ? book->seqId : OkxFrameParser::toInt64(rec.prevSeqId);
+            result = m_books.applyUpdate(*book, m_bookBids, m_bookAsks, prevSeqId, seqId, ts, hasChecksum, checksum);
+        } else {
+            result = m_books.applySnapshot(*book, m_bookBids, m_bookAsks, seqId, ts, hasChecksum, checksum);
+        }
+        if (result == OrderBookEngine::Result::Resync) {
+            resyncOrderBook(*book);
+            return;
+        }
+    }
+}
+
+void WebSocketConnection::onTextMessageReceived(const QString &msg)
+{
+    m_frameRecvNs = LatencyRecorder::nowNs();
+    FeedShard *shard = qobject_cast<FeedShard*>(sender());
+    if (m_journal.isOpen())
+        m_journal.append(FeedJournal::RecordKind::WsFrame, shard ? shard->index() : 0, 0, msg);
+
+    // Parse the QString storage in place: no toUtf8() copy, no QJsonDocument
+    const char16_t *begin = reinterpret_cast<const char16_t *>(msg.constData());
+    handleFrame(begin, begin + msg.size(), shard);
+}
+
+void WebSocketConnection::onStatsTimeout()
+{
+    const qint64 elapsed = m_statsClock.restart();
+    m_journal.flush();   // At most a second of capture is lost if the process dies
+    QVector<CryptoCV::FeedShardStats> stats;
+    stats.reserve(m_shards.size());
+    for (FeedShard *shard : std::as_const(m_shards))
+        stats.append(shard->sampleStats(elapsed));
+
+#ifdef __DEBUGMODE__
+    for (const CryptoCV::FeedShardStats &s : std::as_const(stats))
+        qDebug() << "Shard" << s.shard << (s.connected ? "up" : "down") << "subs" << s.subscriptions
+                 << "msg/s" << s.msgsPerSec << "B/s" << s.bytesPerSec << "lag ms" << s.lagMs;
+#endif
+    emit shardStatsUpdated(stats);
+}
+
+template <typename Char>
+void WebSocketConnection::handleFrame(const Char *begin, const Char *end, FeedShard *source)
+{
+    OkxFrameParser::Frame<Char> frame;
+    if (!OkxFrameParser::parseFrame(begin, end, frame)) {
+        MetricsRegistry::instance().parseErrors.add();
+        qWarning() << "JSON parse error. Original message:" << OkxFrameParser::TextView<Char>{begin, end}.toString();
+        return;
+    }
+
+    // Frames are ASCII JSON: one code unit per wire byte
+    MetricsRegistry::Channel metricsChannel = MetricsRegistry::ChannelOther;
+    if (frame.kind == OkxFrameParser::FrameKind::Event)
+        metricsChannel = MetricsRegistry::ChannelEvents;
+    else if (frame.channel.equals("tickers"))
+        metricsChannel = MetricsRegistry::ChannelTickers;
+    else if (frame.channel.equals("trades"))
+        metricsChannel = MetricsRegistry::ChannelTrades;
+    else if (!frame.channel.isEmpty() && OrderBookEngine::isBookChannel(frame.channel.begin, frame.channel.size()))
+        metricsChannel = MetricsRegistry::ChannelBooks;
+    MetricsRegistry::instance().onFrame(metricsChannel, quint64(end - begin));
+
+    if (frame.kind == OkxFrameParser::FrameKind::Event) {
+        if (frame.event.equals("error")) {
+            QString errMsg = frame.msg.toString();
             qWarning() << "Subscription error:" << errMsg;
+            onSubscribeError(frame.id.toString(), errMsg);
             emit errorOccured("Subscription Error: " + errMsg);
-        } else if (event == "subscribe") {
-            qDebug() << "Successfully subscribed to channel:" << obj.value("arg").toObject().value("channel").toString();
+        } else if (frame.event.equals("subscribe")) {
+            onSubscribeAck(frame.id.toString(), frame.channel.toString(), frame.instId.toString());
+        }
+        return;
+    }
+
+    if (!frame.channel.isEmpty() && OrderBookEngine::isBookChannel(frame.channel.begin, frame.channel.size())) {
+        handleBookFrame(frame, source);
+        return;
+    }
+
+    if (frame.channel.equals("trades")) {
+        OkxFrameParser::RecordCursor<Char> cursor(frame);
+        OkxFrameParser::TextView<Char> record;
+        CryptoCV::TradePrint print;
+        InstrumentRegistry::Cache &instruments = instrumentCache(source);
+        while (cursor.next(record)) {
+            if (!OkxFrameParser::parseTrade(record, print, &instruments))
+                continue;
+            if (source) source->noteExchangeTs(print.ts);
+            m_candles.onTrade(print);
+            m_tradeQueue->push(print);   // Full queue: counted as a drop
+        }
+        return;
+    }
+
+    // WebSocket pushes carry arg.channel; REST ticker replies have no arg
+    if (!frame.channel.isEmpty() && !frame.channel.equals("tickers")) return;
+
+    OkxFrameParser::RecordCursor<Char> cursor(frame);
+    OkxFrameParser::TextView<Char> record;
+    InstrumentRegistry::Cache &instruments = instrumentCache(source);
+    while (cursor.next(record)) {
+        CryptoCV::OkxTicker t;
+        if (!OkxFrameParser::parseTicker(record, t, &instruments))
+            continue;
+        t.recvNs = m_frameRecvNs;
+        t.parsedNs = LatencyRecorder::nowNs();
+        if (source) {
+            // Replayed frames (no source) carry historical ts: no network latency
+            if (t.ts > 0) {
+                const qint64 networkUs = LatencyRecorder::wallUs(t.recvNs) - (t.ts - m_clockOffsetMs) * 1000;
+                t.networkUs = static_cast<qint32>(qBound<qint64>(0, networkUs, std::numeric_limits<qint32>::max()));
+            }
+            source->noteExchangeTs(t.ts);
         }
+        publishStreamTicker(t);
+    }
+}
+
+// --- REST API Methods (Snapshot) ---
+
+void WebSocketConnection::seedTickerSnapshots(const QStringList &instIds)
+{
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, instIds]() { seedTickerSnapshots(instIds); });
         return;
     }
-    handleIncomingJson(obj);
+    for (const QString &id : instIds)
+        m_seedPending.insert(id);
+    // Coalesce bursts (row adds, several shards reconnecting) into one bulk call per instType
+    if (!m_seedTimer.isActive())
+        m_seedTimer.start();
 }
 
-void WebSocketConnection::handleIncomingJson(const QJsonObject &obj)
+void WebSocketConnection::onSeedTimeout()
 {
-    QJsonObject arg = obj.value("arg").toObject();
-    if (arg.isEmpty() || arg.value("channel").toString() != "tickers") return;
-    if (!obj.contains("data") || !obj["data"].isArray()) return;
-    QJsonArray data = obj["data"].toArray();
+    if (isReplaying()) {
+        m_seedPending.clear();   // Snapshots come from the journal
+        return;
+    }
+    QHash<QString, QSet<int>> idsByType;
+    for (const QString &id : std::as_const(m_seedPending)) {
+        const QString type = instTypeOf(id);
+        if (type.isEmpty())
+            fetchTickerSnapshot(id);      // Options need an underlying; keep the per-symbol call
+        else
+            idsByType[type].insert(InstrumentRegistry::instance().intern(id));
+    }
+    m_seedPending.clear();
 
-    for (const QJsonValue &v : data) {
-        if (!v.isObject()) continue;
-        QJsonObject rec = v.toObject();
-        CryptoCV::OkxTicker t;
-        t.instId  = rec.value("instId").toString();
-        t.last    = rec.value("last").toString().toDouble();
-        t.bid     = rec.value("bidPx").toString().toDouble();
-        t.ask     = rec.value("askPx").toString().toDouble();
-        t.askQty  = rec.value("askSz").toString().toDouble();
-        t.bidQty  = rec.value("bidSz").toString().toDouble();
-        emit tickerReceived(t);
+    for (auto it = idsByType.cbegin(); it != idsByType.cend(); ++it) {
+        if (!m_specTypes.contains(it.key()))
+            requestInstrumentSpecs(it.key());   // Display precision (tickSz/lotSz), once per instType
+        QString url = QString(m_restBase + "/api/v5/market/tickers?instType=%1").arg(it.key());
+        QNetworkReply* reply = restGet(url);
+        m_seedRequests.insert(reply, it.value());
+        connect(reply, &QNetworkReply::finished, this, &WebSocketConnection::onRestReply);
+        qDebug() << "Seeding" << it.value().size() << it.key() << "tickers from one bulk snapshot";
     }
 }
 
-void WebSocketConnection::onSocketError(QAbstractSocket::SocketError)
+void WebSocketConnection::requestInstrumentSpecs(const QString &instType)
 {
-    QString err = m_socket.errorString();
-    qWarning() << "WebSocket error:" << err;
-    emit errorOccured(err);
+    m_specTypes.insert(instType);
+    QNetworkReply* specReply = restGet(QString(m_restBase + "/api/v5/public/instruments?instType=%1").arg(instType));
+    connect(specReply, &QNetworkReply::finished, this, [this, specReply]() { onInstrumentSpecsReply(specReply); });
 }
 
-// --- REST API Methods (Snapshot) ---
+void WebSocketConnection::fetchInstrumentList(const QString &instType)
+{
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, instType]() { fetchInstrumentList(instType); });
+        return;
+    }
+    requestInstrumentSpecs(instType);   // Also refreshes the type's precision
+}
 
 void WebSocketConnection::fetchTickerSnapshot(const QString &instId)
 {
-    QString url = QString("https://www.okx.com/api/v5/market/ticker?instId=%1").arg(instId);
-    QNetworkRequest req{QUrl(url)};
-    QNetworkReply* reply = m_networkManager.get(req);
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, instId]() { fetchTickerSnapshot(instId); });
+        return;
+    }
+    if (isReplaying()) return;
+    QString url = QString(m_restBase + "/api/v5/market/ticker?instId=%1").arg(instId);
+    QNetworkReply* reply = restGet(url);
     connect(reply, &QNetworkReply::finished, this, &WebSocketConnection::onRestReply);
 }
 
-void WebSocketConnection::makeApiRequest(CryptoCV::ApiRequestType type, const QString &symbol, int limit)
+void WebSocketConnection::makeApiRequest(CryptoCV::ApiRequestType type, const QString &symbol, int limit,
+                                         const QString &bar)
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, type, symbol, limit, bar]() { makeApiRequest(type, symbol, limit, bar); });
+        return;
+    }
+    if (isReplaying()) return;
     QString url;
     switch (type) {
     case CryptoCV::ApiRequestType::TickerSnapshot:
-        url = QString("https://www.okx.com/api/v5/market/ticker?instId=%1").arg(symbol);
+        url = QString(m_restBase + "/api/v5/market/ticker?instId=%1").arg(symbol);
         break;
     case CryptoCV::ApiRequestType::OrderBookSnapshot:
-        url = QString("https://www.okx.com/api/v5/market/books?instId=%1&sz=%2").arg(symbol).arg(limit);
+        url = QString(m_restBase + "/api/v5/market/books?instId=%1&sz=%2").arg(symbol).arg(limit);
         break;
     case CryptoCV::ApiRequestType::RecentTrades:
-        url = QString("https://www.okx.com/api/v5/market/trades?instId=%1&limit=%2").arg(symbol).arg(limit);
+        url = QString(m_restBase + "/api/v5/market/trades?instId=%1&limit=%2").arg(symbol).arg(limit);
+        break;
+    case CryptoCV::ApiRequestType::Candles:
+        url = QString(m_restBase + "/api/v5/market/candles?instId=%1&bar=%2&limit=%3").arg(symbol, bar).arg(limit);
         break;
         // Add more cases as needed
     }
-    QNetworkRequest req{QUrl(url)};
-    QNetworkReply* reply = m_networkManager.get(req);
+    QNetworkReply* reply = restGet(url);
     m_replyTypeMap[reply] = type;
+    if (type == CryptoCV::ApiRequestType::Candles)
+        m_candleRequests.insert(reply, CandleRequest{symbol, bar, LatencyRecorder::nowNs()});   // The reply body names neither
     connect(reply, &QNetworkReply::finished, this, &WebSocketConnection::onGenericApiReply);
 }
 
 
+QNetworkReply *WebSocketConnection::restGet(const QString &url)
+{
+    const qint64 sentNs = LatencyRecorder::nowNs();
+    QNetworkReply* reply = m_networkManager.get(QNetworkRequest{QUrl(url)});
+    connect(reply, &QNetworkReply::finished, this, [reply, sentNs]() {
+        MetricsRegistry::instance().onRestReply(MetricsRegistry::restOf(reply->url().path()),
+                                                (LatencyRecorder::nowNs() - sentNs) / 1000000,
+                                                reply->error() != QNetworkReply::NoError);
+    });
+    return reply;
+}
+
 void WebSocketConnection::onRestReply()
 {
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
     if (!reply) return;
 
     if (reply->error() == QNetworkReply::NoError) {
-        QByteArray resp = reply->readAll();
-        QJsonParseError err;
-        QJsonDocument doc = QJsonDocument::fromJson(resp, &err);
-        if (err.error != QJsonParseError::NoError) {
-            emit errorOccured("REST JSON parse error: " + err.errorString());
-            reply->deleteLater();
-            return;
-        }
-        QJsonObject obj = doc.object();
-        if (obj.contains("data") && obj["data"].isArray()) {
-            QJsonArray arr = obj["data"].toArray();
-            if (!arr.isEmpty()) {
-                QJsonObject rec = arr.first().toObject();
-                CryptoCV::OkxTicker t;
-                t.instId  = rec.value("instId").toString();
-                t.last    = rec.value("last").toString().toDouble();
-                t.bid     = rec.value("bidPx").toString().toDouble();
-                t.ask     = rec.value("askPx").toString().toDouble();
-                t.askQty  = rec.value("askSz").toString().toDouble();
-                t.bidQty  = rec.value("bidSz").toString().toDouble();
-                emit tickerReceived(t);
-            }
-        }
+        const QByteArray resp = reply->readAll();
+        if (m_journal.isOpen())
+            m_journal.append(FeedJournal::RecordKind::RestTickers, 0, 0, resp.constData(), resp.size());
+        handleTickerReply(resp.constData(), resp.constData() + resp.size(), m_seedRequests.take(reply));
     } else {
+        m_seedRequests.remove(reply);
         emit errorOccured("REST error: " + reply->errorString());
     }
     reply->deleteLater();
 }
 
+void WebSocketConnection::onInstrumentSpecsReply(QNetworkReply *reply)
+{
+    reply->deleteLater();
+    if (reply->error() != QNetworkReply::NoError) {
+        m_specTypes.remove(QUrlQuery(reply->url()).queryItemValue("instType"));   // The next seed asks again
+        return;
+    }
+
+    // {"code":"0","data":[{"instId":"BTC-USDT","tickSz":"0.1","lotSz":"0.00000001","state":"live",...}]}
+    const QJsonArray data = QJsonDocument::fromJson(reply->readAll()).object().value("data").toArray();
+    InstrumentRegistry &registry = InstrumentRegistry::instance();
+    QStringList live;
+    live.reserve(data.size());
+    for (const QJsonValue &value : data) {
+        const QJsonObject spec = value.toObject();
+        const QString instId = spec.value("instId").toString();
+        if (spec.value("state").toString() == QLatin1String("live"))
+            live << instId;
+        const Decimal tick = Decimal::fromString(spec.value("tickSz").toString());
+        const Decimal lot = Decimal::fromString(spec.value("lotSz").toString());
+        if (tick.isNull() || lot.isNull()) continue;
+        registry.setPrecision(registry.intern(instId), tick.scale, lot.scale);
+    }
+    qDebug() << "Instrument precision loaded for" << data.size() << "instruments";
+    emit instrumentSpecsReceived();
+    emit instrumentListReceived(QUrlQuery(reply->url()).queryItemValue("instType"), live);
+}
+
+void WebSocketConnection::onClockSyncTimeout()
+{
+    if (isReplaying()) return;   // Replayed timestamps are historical
+    const qint64 sentNs = LatencyRecorder::nowNs();
+    QNetworkReply* reply = restGet(m_restBase + "/api/v5/public/time");
+    connect(reply, &QNetworkReply::finished, this, [this, reply, sentNs]() { onClockSyncReply(reply, sentNs); });
+}
+
+void WebSocketConnection::onClockSyncReply(QNetworkReply *reply, qint64 sentNs)
+{
+    reply->deleteLater();
+    const qint64 recvNs = LatencyRecorder::nowNs();
+    if (reply->error() != QNetworkReply::NoError) return;
+
+    // {"code":"0","data":[{"ts":"1597026383085"}]}
+    const QJsonObject obj = QJsonDocument::fromJson(reply->readAll()).object();
+    const qint64 exchangeTs = obj.value("data").toArray().at(0).toObject().value("ts").toString().toLongLong();
+    if (exchangeTs <= 0) return;
+
+    // NTP-style: the exchange stamped its clock around the middle of the round-trip
+    const qint64 rttMs = (recvNs - sentNs) / 1000000;
+    const qint64 midMs = LatencyRecorder::wallUs(sentNs + (recvNs - sentNs) / 2) / 1000;
+    m_clockSamples.append(qMakePair(rttMs, exchangeTs - midMs));
+    if (m_clockSamples.size() > CLOCK_SYNC_SAMPLES)
+        m_clockSamples.removeFirst();
+
+    // The shortest round-trip bounds the error best (+-rtt/2)
+    QPair<qint64, qint64> best = m_clockSamples.first();
+    for (const auto &sample : std::as_const(m_clockSamples)) {
+        if (sample.first < best.first) best = sample;
+    }
+    m_clockOffsetMs = best.second;
+    LatencyRecorder::instance().setClockOffset(best.second, best.first);
+}
+
+void WebSocketConnection::handleTickerReply(const char *begin, const char *end, const QSet<int> &wanted)
+{
+    // Same scanner as the stream; the reply body is UTF-8
+    OkxFrameParser::Frame<char> frame;
+    if (!OkxFrameParser::parseFrame(begin, end, frame)) {
+        emit errorOccured("REST JSON parse error");
+        return;
+    }
+    // Single-ticker replies carry one record; bulk seed replies carry the whole
+    // instType and are filtered down to the instruments that asked for a seed
+    OkxFrameParser::RecordCursor<char> cursor(frame);
+    OkxFrameParser::TextView<char> record;
+    while (cursor.next(record)) {
+        CryptoCV::OkxTicker t;
+        if (!OkxFrameParser::parseTicker(record, t, &m_instrumentCache))
+            continue;
+        if (!wanted.isEmpty() && !wanted.contains(t.instrument))
+            continue;
+        publishSnapshot(t);
+    }
+}
+
+void WebSocketConnection::publishStreamTicker(const CryptoCV::OkxTicker &ticker)
+{
+    // Every stream path goes through here, so a later snapshot is judged against it
+    if (ticker.instrument >= m_lastStreamTs.size())
+        m_lastStreamTs.resize(ticker.instrument + 1);
+    qint64 &lastTs = m_lastStreamTs[ticker.instrument];
+    if (ticker.ts > lastTs) lastTs = ticker.ts;
+    publishTicker(ticker);
+}
+
+void WebSocketConnection::publishSnapshot(const CryptoCV::OkxTicker &ticker)
+{
+    // The stream may already have delivered newer data while the REST call was in flight
+    if (ticker.instrument < m_lastStreamTs.size() && ticker.ts <= m_lastStreamTs.at(ticker.instrument)) {
+        ++m_staleSnapshots;
+        return;
+    }
+    publishTicker(ticker);
+}
+
 void WebSocketConnection::onGenericApiReply()
 {
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
@@ -267,6 +967,8 @@ void WebSocketConnection::onGenericApiReply()
     CryptoCV::ApiRequestType type = m_replyTypeMap.value(reply, CryptoCV::ApiRequestType::TickerSnapshot); // default fallback
 
     QByteArray resp = reply->readAll();
+    if (m_journal.isOpen())
+        m_journal.append(FeedJournal::RecordKind::RestApi, 0, int(type), resp.constData(), resp.size());
     QJsonParseError err;
     QJsonDocument doc = QJsonDocument::fromJson(resp, &err);
 
@@ -274,6 +976,11 @@ void WebSocketConnection::onGenericApiReply()
         emit errorOccured("REST JSON parse error");
         reply->deleteLater();
         m_replyTypeMap.remove(reply);
+        if (m_candleRequests.contains(reply)) {
+            const CandleRequest request = m_candleRequests.take(reply);
+            m_candles.abandonBackfill(InstrumentRegistry::instance().find(request.instId),
+                                      CandleAggregator::timeframeOf(request.bar));
+        }
         return;
     }
 
@@ -293,9 +1000,120 @@ void WebSocketConnection::onGenericApiReply()
         // process trades
         emit recentTradesReceived(obj);
         break;
+    case CryptoCV::ApiRequestType::Candles: {
+        // Rows: [ts, o, h, l, c, vol, volCcy, volCcyQuote, confirm], newest first
+        const CandleRequest request = m_candleRequests.take(reply);
+        const QJsonArray rows = obj.value("data").toArray();
+        QVector<CryptoCV::Candle> bars;
+        bars.reserve(rows.size());
+        for (const QJsonValue &v : rows) {
+            const QJsonArray r = v.toArray();
+            CryptoCV::Candle c;
+            c.openTime = r.at(0).toString().toLongLong();
+            c.open = r.at(1).toString().toDouble();
+            c.high = r.at(2).toString().toDouble();
+            c.low = r.at(3).toString().toDouble();
+            c.close = r.at(4).toString().toDouble();
+            c.volume = r.at(5).toString().toDouble();
+            c.turnover = r.at(7).toString().toDouble();
+            c.confirmed = r.at(8).toString() == QLatin1String("1");
+            bars.append(c);
+        }
+        // Trade ts are exchange time: place the snapshot mid round-trip (as the
+        // clock sync does) and move it onto the exchange clock
+        const qint64 recvNs = LatencyRecorder::nowNs();
+        const qint64 snapshotTs = LatencyRecorder::wallUs(request.sentNs + (recvNs - request.sentNs) / 2) / 1000
+                                  + LatencyRecorder::instance().clockOffsetMs();
+        m_candles.applyBackfill(InstrumentRegistry::instance().intern(request.instId),
+                                CandleAggregator::timeframeOf(request.bar), bars, snapshotTs);
+        break;
+    }
         // Add more cases as needed
     }
     reply->deleteLater();
     m_replyTypeMap.remove(reply);
 }
 
+// --- Capture replay ---
+
+void WebSocketConnection::startReplay(const QString &path, double speed)
+{
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, path, speed]() { startReplay(path, speed); });
+        return;
+    }
+    if (!m_replay.open(path)) {
+        emit errorOccured("Cannot replay feed journal " + path);
+        return;
+    }
+    m_replaySpeed = qMax(0.0, speed);
+    m_replayBaseNs = -1;
+    m_replayPending = false;
+    m_replayed = 0;
+    m_replayClock.start();
+    qDebug() << "Replaying" << path << "(" << m_replay.fileSize() << "bytes) at"
+             << (m_replaySpeed > 0 ? QString::number(m_replaySpeed) + "x" : QStringLiteral("full speed"));
+    m_replayTimer.start(0);
+}
+
+void WebSocketConnection::onReplayTimeout()
+{
+    const qint64 sliceEndNs = m_replayClock.nsecsElapsed() + REPLAY_SLICE_NS;
+    while (m_replayPending || m_replay.next(m_replayRecord)) {
+        m_replayPending = true;
+        if (m_replayBaseNs < 0) m_replayBaseNs = m_replayRecord.offsetNs;
+
+        if (m_replaySpeed > 0) {
+            // Paced: sleep until this record is due on the scaled capture clock
+            const qint64 dueNs = qint64(double(m_replayRecord.offsetNs - m_replayBaseNs) / m_replaySpeed);
+            const qint64 waitNs = dueNs - m_replayClock.nsecsElapsed();
+            if (waitNs > 0) {
+                m_replayTimer.start(int(waitNs / 1000000));
+                return;
+            }
+        }
+
+        replayRecord(m_replayRecord);
+        m_replayPending = false;
+        ++m_replayed;
+
+        if (m_replayClock.nsecsElapsed() >= sliceEndNs) {
+            m_replayTimer.start(0);   // Let publish timers and queued work run
+            return;
+        }
+    }
+
+    const qint64 elapsedMs = m_replayClock.elapsed();
+    qDebug() << "Replay finished:" << m_replayed << "records in" << elapsedMs << "ms ("
+             << (elapsedMs > 0 ? m_replayed * 1000 / quint64(elapsedMs) : m_replayed) << "records/s)";
+    m_replay.close();
+    emit replayFinished(m_replayed, elapsedMs);
+}
+
+void WebSocketConnection::replayRecord(const FeedJournalReader::Record &record)
+{
+    switch (record.kind) {
+    case FeedJournal::RecordKind::WsFrame:
+        // No shard: replayed frames do not feed live lag/rate statistics
+        m_frameRecvNs = LatencyRecorder::nowNs();
+        handleFrame(record.data, record.data + record.size, nullptr);
+        break;
+    case FeedJournal::RecordKind::RestTickers:
+        handleTickerReply(record.data, record.data + record.size, QSet<int>());
+        break;
+    case FeedJournal::RecordKind::RestApi: {
+        // Book snapshots would open dialogs and candle replies lack their request,
+        // so only ticker and trade history replies are replayed
+        const auto type = static_cast<CryptoCV::ApiRequestType>(record.tag);
+        if (type != CryptoCV::ApiRequestType::TickerSnapshot && type != CryptoCV::ApiRequestType::RecentTrades)
+            break;
+        const QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromRawData(record.data, record.size));
+        if (!doc.isObject()) break;
+        if (type == CryptoCV::ApiRequestType::TickerSnapshot)
+            emit tickerSnapshotReceived(doc.object());
+        else
+            emit recentTradesReceived(doc.object());
+        break;
+    }
+    }
+}
@@ -6,7 +6,7 @@
  *
  * @class WebSocketConnection
  * @brief Main class for handling connection between this application and OKX:
- *        - Real-time market data via public WebSocket
+ *        - Real-time market data via a pool of public WebSocket shards (FeedShard)
  *        - REST API requests for ticker snapshots, order book, and trades
  *        Routes received data to Qt models, UI, and logs. Handles reconnection logic.
  */
@@ -14,15 +14,26 @@
 #pragma once
 
 #include <QObject>
-#include <QWebSocket>
-#include <QAbstractSocket>
 #include <QNetworkAccessManager>
 #include <QTimer>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QThread>
+#include <memory>
+#include "okxframeparser.h"
 #include "protocol.h" // For CryptoCV::OkxTicker and ApiRequestType enums
+#include "spscringbuffer.h"
+#include "orderbookengine.h"
+#include "candleaggregator.h"
+#include "feedjournal.h"
+
+class FeedShard;
 
 class WebSocketConnection : public QObject
 {
@@ -39,10 +50,20 @@ public:
     // WebSocket methods
 
     /**
-     * Connects/reconnects to the OKX WebSocket server.
+     * Connects/reconnects every shard of the pool to the OKX WebSocket server.
+     * With Feed/replayFile set, replays that journal instead (no network).
      */
     void connectToServer();
 
+    /**
+     * Feeds a captured journal (Feed/recordFile) through the normal parse ->
+     * model pipeline instead of the network. REST requests are suppressed.
+     * @param speed 1 = real time, N = N times faster, 0 = as fast as possible
+     */
+    void startReplay(const QString &path, double speed);
+
+    bool isReplaying() const { return m_replay.isOpen(); }
+
     /**
      * Subscribes for live ticker updates for one instrument.
      * @param instId Instrument symbol ("BTC-USDT", etc.)
@@ -52,25 +73,135 @@ public:
     /**
      * Subscribes for live ticker updates for multiple instruments,
      * and fetches initial REST snapshot for each.
+     * Reference counted per instId: an instrument shown in several views is
+     * subscribed once, and every call seeds it.
+     * Each instrument is routed to one shard (Feed/shardPolicy) and stays there;
+     * the whole set goes out as a few chunked subscribe frames per shard, and
+     * each channel's ack/error is reported via subscriptionAcked/subscriptionFailed.
      * @param instIds List of instrument symbols
      */
     void subscribeTickers(const QStringList &instIds);
 
+    /**
+     * Releases one subscribeTickers reference per instrument; channels dropped
+     * with their last reference go out as a few chunked unsubscribe frames per
+     * shard. Ids that are not subscribed are ignored.
+     * @param instIds List of instrument symbols
+     */
+    void unsubscribeTickers(const QStringList &instIds);
+
     // REST API methods
 
+    /**
+     * Lists the tradable instruments of an instType (/api/v5/public/instruments)
+     * and refreshes their display precision. The ids arrive in instrumentListReceived.
+     * @param instType "SPOT", "SWAP", "FUTURES", ...
+     */
+    void fetchInstrumentList(const QString &instType);
+
     /**
      * Fetches snapshot data (current stats) for a symbol with REST API.
      * @param instId Instrument symbol
      */
     void fetchTickerSnapshot(const QString &instId);
 
+    /**
+     * Seeds initial values for many instruments with one bulk
+     * /api/v5/market/tickers?instType=... call per instrument type, filtered
+     * to the requested set. Requests arriving within 50 ms are coalesced.
+     * Snapshots older than data already received from the stream are skipped.
+     * @param instIds Instrument symbols to seed
+     */
+    void seedTickerSnapshots(const QStringList &instIds);
+
     /**
      * Makes a REST API request (ticker, orderbook, trades, etc.) and routes reply using a switch-case-based handler.
      * @param type Type of API request (enum)
      * @param symbol Instrument symbol ("BTC-USDT", etc.)
-     * @param limit Optional: Depth (orderbook) or count (trades)
+     * @param limit Optional: Depth (orderbook) or count (trades, candles)
+     * @param bar   Candles only: OKX bar size ("1s", "1m", "5m", "1H", ...)
+     */
+    void makeApiRequest(CryptoCV::ApiRequestType type, const QString &symbol, int limit,
+                        const QString &bar = QStringLiteral("1m"));
+
+    // Streaming order books
+
+    /**
+     * Subscribes to a streaming L2 order book. Snapshot + incremental updates
+     * are applied by OrderBookEngine; checksum mismatches and sequence gaps
+     * trigger an automatic resubscribe. Changed books are published through
+     * orderBookUpdated at most every 100 ms.
+     * @param instId Instrument symbol
+     * @param channel "books", "books5" or "bbo-tbt" (empty = Feed/bookChannel)
+     */
+    void subscribeOrderBook(const QString &instId, const QString &channel = QString());
+
+    /**
+     * Drops a book subscribed with subscribeOrderBook.
+     */
+    void unsubscribeOrderBook(const QString &instId, const QString &channel = QString());
+
+    // Streaming trades
+
+    /**
+     * Subscribes to the public trades channel (reference counted per instId).
+     * Prints go to tradeQueue() and are drained by TradeTapeStore.
+     */
+    void subscribeTrades(const QString &instId);
+
+    /**
+     * Releases one subscribeTrades reference; the channel is dropped with the last one.
+     */
+    void unsubscribeTrades(const QString &instId);
+
+    // Candles
+
+    /**
+     * Builds 1s/1m/5m/1H OHLCV bars for instId from its trades (reference counted).
+     * Subscribes the trades channel and backfills each timeframe from REST
+     * (ApiRequestType::Candles). Open bars are published through candleUpdated.
+     */
+    void subscribeCandles(const QString &instId);
+
+    /**
+     * Releases one subscribeCandles reference.
      */
-    void makeApiRequest(CryptoCV::ApiRequestType type, const QString &symbol, int limit);
+    void unsubscribeCandles(const QString &instId);
+
+    /**
+     * Network -> GUI trade queue (always present).
+     */
+    SpscRingBuffer<CryptoCV::TradePrint> *tradeQueue() const { return m_tradeQueue.get(); }
+
+    /**
+     * Order book engine counters (connection thread).
+     */
+    const OrderBookEngine::Stats &orderBookStats() const { return m_books.stats(); }
+
+    // Threaded ingest
+
+    /**
+     * True when the socket, timers and parsing run on their own QThread
+     * (config: Feed/threadedIngest). Ticks are then handed to the GUI through
+     * tickQueue() instead of the tickerReceived signal.
+     */
+    bool isThreadedIngest() const { return m_ingestThread != nullptr; }
+
+    /**
+     * Network -> GUI tick queue (nullptr in single-threaded mode).
+     * Exposes depth/drop counters for diagnostics.
+     */
+    SpscRingBuffer<CryptoCV::OkxTicker> *tickQueue() const { return m_tickQueue.get(); }
+
+    /**
+     * Number of WebSocket connections in the pool (Feed/shards, default 1).
+     */
+    int shardCount() const { return m_shards.size(); }
+
+    // Subscription acknowledgement counters (connection thread)
+    quint64 subscribeAckCount() const { return m_subscribeAcks; }
+    quint64 subscribeErrorCount() const { return m_subscribeErrors; }
+    quint64 staleSnapshotCount() const { return m_staleSnapshots; }
 
 signals:
     // Connection status
@@ -86,34 +217,180 @@ signals:
     void orderBookReceived(QJsonObject obj);
     void recentTradesReceived(QJsonObject obj);
 
+    // Streaming order book, top levels of a changed book (throttled)
+    void orderBookUpdated(CryptoCV::OrderBookDepth depth);
+
+    // Open bar of a changed candle series (throttled); bar is "1s", "1m", "5m" or "1H"
+    void candleUpdated(int instrument, const QString &bar, CryptoCV::Candle candle);
+
+    // Per-channel subscription outcome ({"event":"subscribe"} / {"event":"error"})
+    void subscriptionAcked(const QString &channel, const QString &instId);
+    void subscriptionFailed(const QString &channel, const QString &instId, const QString &error);
+
+    // Pool health, emitted once per second (one entry per shard)
+    void shardStatsUpdated(QVector<CryptoCV::FeedShardStats> stats);
+
+    // InstrumentRegistry precision updated from a /public/instruments reply
+    void instrumentSpecsReceived();
+
+    // Live instruments of one instType, from the same /public/instruments reply
+    void instrumentListReceived(const QString &instType, const QStringList &instIds);
+
+    // End of a journal replay; records/elapsed give the offline throughput
+    void replayFinished(quint64 records, qint64 elapsedMs);
+
 private slots:
-    // WebSocket event handling
-    void onConnected();
-    void onDisconnected();
+    // WebSocket event handling (sender() is the FeedShard)
+    void onShardConnected();
+    void onShardQuiet();   // Pongs but no data for Feed/quietSeconds: refresh the ticker subscriptions
     void onTextMessageReceived(const QString &msg);
-    void onSocketError(QAbstractSocket::SocketError error);
-    void onPingTimeout();
+    void onStatsTimeout();
+    void onSeedTimeout();
+    void onBookPublishTimeout();
+    void onCandlePublishTimeout();
+    void onReplayTimeout();
+    void onClockSyncTimeout();
 
     // REST/Network reply handling
     void onRestReply();
     void onGenericApiReply();
 
 private:
-    // Helper to send JSON payloads via WebSocket
-    void sendJson(const QJsonObject &obj);
+    // Picks (and remembers) the shard an instrument is routed to
+    FeedShard *shardFor(const QString &instId);
+
+    // Appends one FeedShard to the pool; it connects at once if the pool is running
+    void addShard();
+
+    // Grows the pool until this many ticker instruments fit at Feed/maxInstrumentsPerShard each
+    void reserveShards(int instruments);
+
+    /**
+     * Sends a subscribe/unsubscribe op for one channel and many instruments,
+     * split into frames below the exchange size limit. Each frame carries an
+     * "id" so acknowledgements and errors can be matched to its channels.
+     */
+    void sendChannelOp(FeedShard *shard, const QString &op, const QString &channel, const QStringList &instIds);
 
-    // Parses incoming WebSocket JSON messages
-    void handleIncomingJson(const QJsonObject &obj);
+    // Ack/error bookkeeping for sendChannelOp
+    void onSubscribeAck(const QString &requestId, const QString &channel, const QString &instId);
+    void onSubscribeError(const QString &requestId, const QString &error);
+
+    // Parses one raw OKX frame (UTF-16 from the socket, UTF-8 from REST) and dispatches it
+    // @param source Shard the frame arrived on, nullptr for REST
+    template <typename Char>
+    void handleFrame(const Char *begin, const Char *end, FeedShard *source);
+
+    // Symbol -> registry id cache for a frame's records: the shard's own, or
+    // m_instrumentCache for REST replies and replayed frames
+    InstrumentRegistry::Cache &instrumentCache(FeedShard *source);
+
+    // Applies the records of one books/books5/bbo-tbt push to its book
+    template <typename Char>
+    void handleBookFrame(const OkxFrameParser::Frame<Char> &frame, FeedShard *source);
+
+    // Unsubscribes and resubscribes a book so the exchange sends a fresh snapshot
+    void resyncOrderBook(const OrderBookEngine::Book &book);
+
+    // Shard carrying an instrument's book/trades: its ticker shard if it has one
+    FeedShard *bookShardFor(const QString &instId) const;
+
+    // Routes a parsed tick to the GUI: ring buffer when threaded, signal otherwise
+    void publishTicker(const CryptoCV::OkxTicker &ticker);
+
+    // publishTicker for stream ticks: records the newest stream ts publishSnapshot checks against
+    void publishStreamTicker(const CryptoCV::OkxTicker &ticker);
+
+    // publishTicker for REST snapshots: dropped if the stream already delivered newer data
+    void publishSnapshot(const CryptoCV::OkxTicker &ticker);
+
+    // Publishes the tickers of a REST ticker reply (wanted empty = all of them)
+    void handleTickerReply(const char *begin, const char *end, const QSet<int> &wanted);
+
+    // GET through the shared manager; the reply's latency and outcome are counted in MetricsRegistry
+    QNetworkReply *restGet(const QString &url);
+
+    // Stores tickSz/lotSz precision of every instrument in a /public/instruments reply
+    void onInstrumentSpecsReply(QNetworkReply *reply);
+    void requestInstrumentSpecs(const QString &instType);   // GET /public/instruments for one instType
+
+    // Folds one /public/time round-trip into the exchange clock offset estimate
+    void onClockSyncReply(QNetworkReply *reply, qint64 sentNs);
+
+    // Dispatches one journal record like the live socket/REST reply it captured
+    void replayRecord(const FeedJournalReader::Record &record);
+
+    // Moves this object (and its child socket/timers/network manager) onto m_ingestThread
+    void startIngestThread();
 
     // Members
-    QWebSocket m_socket;                  // For streaming/live updates
     QNetworkAccessManager m_networkManager;   // For REST API requests
     QUrl m_url;
-    QTimer m_reconnectTimer;              // Auto-reconnect timer
-    QTimer m_pingTimer;                   // Send periodic pings to keep alive
+    QString m_restBase;                       // Feed/restUrl, e.g. "https://www.okx.com"
+    QVector<FeedShard*> m_shards;             // WebSocket pool (children of this)
+    QHash<QString, FeedShard*> m_shardOf;     // instId -> shard it is subscribed on
+    bool m_balanceByLoad = false;             // Feed/shardPolicy=load, otherwise hash
+    int m_maxPerShard = 0;                    // Feed/maxInstrumentsPerShard, 0 = fixed pool
+    QTimer m_statsTimer;                      // Samples shard stats every second
+    QElapsedTimer m_statsClock;
+
+    // Subscription tracking
+    QHash<QString, CryptoCV::SubscriptionState> m_subscriptions;  // "channel:instId" -> state
+    QHash<QString, QStringList> m_pendingOps;                     // request id -> keys awaiting ack
+    int m_nextRequestId = 0;
+    quint64 m_subscribeAcks = 0;
+    quint64 m_subscribeErrors = 0;
+
+    // REST snapshot seeding
+    QTimer m_seedTimer;                                    // Coalesces seed requests
+    QSet<QString> m_seedPending;                           // Instruments waiting for a seed
+    QHash<QNetworkReply*, QSet<int>> m_seedRequests;       // Bulk reply -> instrument ids it seeds
+    QVector<qint64> m_lastStreamTs;                        // Instrument id -> newest stream ts
+    InstrumentRegistry::Cache m_instrumentCache;           // Symbol -> id for frames without a shard
+    quint64 m_staleSnapshots = 0;                          // Snapshots skipped as older than stream
+    QSet<QString> m_specTypes;                             // instTypes whose metadata was requested
+    QHash<QString, int> m_tickerRefs;                      // instId -> views showing its ticker
+
+    // Streaming order books
+    OrderBookEngine m_books;
+    std::vector<OrderBookEngine::Level> m_bookBids;   // Parse scratch, reused for every record
+    std::vector<OrderBookEngine::Level> m_bookAsks;
+    QTimer m_bookPublishTimer;                        // Throttles orderBookUpdated
+
+    // Streaming trades
+    QHash<QString, int> m_tradeRefs;                                   // instId -> open subscribers
+    std::unique_ptr<SpscRingBuffer<CryptoCV::TradePrint>> m_tradeQueue;  // Network -> TradeTapeStore
+
+    // Candles
+    CandleAggregator m_candles;
+    QHash<QString, int> m_candleRefs;                              // instId -> open subscribers
+    struct CandleRequest {
+        QString instId;
+        QString bar;
+        qint64 sentNs = 0;   // LatencyRecorder::nowNs() when the request left
+    };
+    QHash<QNetworkReply*, CandleRequest> m_candleRequests;          // Backfill reply -> its request
+    QTimer m_candlePublishTimer;                                   // Throttles candleUpdated
 
     QMap<QNetworkReply*, CryptoCV::ApiRequestType> m_replyTypeMap; // For dispatching generic REST API replies
 
-    int m_reconnectAttempts = 0;
-    const int m_maxReconnectAttempts = 10;
+    // Capture / replay
+    FeedJournalWriter m_journal;                  // Open when Feed/recordFile is set
+    FeedJournalReader m_replay;                   // Open while replaying
+    FeedJournalReader::Record m_replayRecord;     // Next record (pending when not yet due)
+    bool m_replayPending = false;
+    QTimer m_replayTimer;
+    QElapsedTimer m_replayClock;
+    double m_replaySpeed = 1.0;
+    qint64 m_replayBaseNs = -1;                   // Capture offset of the first record
+    quint64 m_replayed = 0;
+
+    // Latency instrumentation (LatencyRecorder)
+    qint64 m_frameRecvNs = 0;                     // Receive stamp of the frame being handled
+    QTimer m_clockSyncTimer;                      // Periodic /public/time round-trip
+    QVector<QPair<qint64, qint64>> m_clockSamples; // Recent (rtt ms, offset ms), oldest first
+    qint64 m_clockOffsetMs = 0;                   // Exchange clock - local clock (min-RTT sample)
+
+    QThread *m_ingestThread = nullptr;                                 // Network thread (threaded ingest only)
+    std::unique_ptr<SpscRingBuffer<CryptoCV::OkxTicker>> m_tickQueue;  // Network -> GUI handoff
 };